@@ -0,0 +1,39 @@
+# Benchmarks are built like tests but are not part of the test suite: they only
+# report figures. Each one gets a `benchmark-<name>` target that builds and runs
+# it, once per entry of RUNS with the entry as its argument, or once without
+# arguments. Separate runs keep the peak memory figures of a run its own.
+function(add_aktualizr_benchmark)
+    set(options PROJECT_WORKING_DIRECTORY)
+    set(oneValueArgs NAME)
+    set(multiValueArgs SOURCES LIBRARIES RUNS)
+    cmake_parse_arguments(AKTUALIZR_BENCHMARK "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
+    set(BENCHMARK_TARGET b_${AKTUALIZR_BENCHMARK_NAME})
+
+    add_executable(${BENCHMARK_TARGET} EXCLUDE_FROM_ALL ${AKTUALIZR_BENCHMARK_SOURCES})
+    target_link_libraries(${BENCHMARK_TARGET}
+        ${AKTUALIZR_BENCHMARK_LIBRARIES}
+        ${TEST_LIBS})
+    target_include_directories(${BENCHMARK_TARGET} PUBLIC ${PROJECT_SOURCE_DIR}/tests)
+
+    if(AKTUALIZR_BENCHMARK_PROJECT_WORKING_DIRECTORY)
+        set(WD WORKING_DIRECTORY ${PROJECT_SOURCE_DIR})
+    else()
+        set(WD )
+    endif()
+
+    set(COMMANDS )
+    if(AKTUALIZR_BENCHMARK_RUNS)
+        foreach(RUN ${AKTUALIZR_BENCHMARK_RUNS})
+            list(APPEND COMMANDS COMMAND $<TARGET_FILE:${BENCHMARK_TARGET}> ${RUN})
+        endforeach()
+    else()
+        set(COMMANDS COMMAND $<TARGET_FILE:${BENCHMARK_TARGET}>)
+    endif()
+
+    add_custom_target(benchmark-${AKTUALIZR_BENCHMARK_NAME}
+        ${COMMANDS}
+        DEPENDS ${BENCHMARK_TARGET}
+        ${WD}
+        USES_TERMINAL)
+    set(TEST_SOURCES ${TEST_SOURCES} ${AKTUALIZR_BENCHMARK_SOURCES} PARENT_SCOPE)
+endfunction(add_aktualizr_benchmark)
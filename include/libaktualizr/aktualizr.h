@@ -277,7 +277,9 @@ class Aktualizr {
 
   /**
    * Synchronously run an Uptane cycle: check for updates, download any new
-   * targets, install them, and send a manifest back to the server.
+   * targets, install them, and send a manifest back to the server. A
+   * MetadataMetricsReport event with the metadata processing statistics of
+   * the cycle is sent at the end.
    *
    * @return `false`, if the restart is required to continue, `true` otherwise
    *
@@ -319,6 +321,14 @@ class Aktualizr {
    */
   std::vector<SecondaryInfo> GetSecondaries() const;
 
+  /**
+   * Latency and size statistics of the fetching, verification and storage of
+   * the Uptane metadata, per repository and role, since aktualizr started.
+   *
+   * @return MetadataMetrics object
+   */
+  result::MetadataMetrics GetMetadataMetrics() const;
+
   // The type proxy is needed in doxygen 1.8.16 because of this bug
   // https://github.com/doxygen/doxygen/issues/7236
   using SigHandler = std::function<void(std::shared_ptr<event::BaseEvent>)>;
@@ -341,6 +351,8 @@ class Aktualizr {
   std::shared_ptr<SotaUptaneClient> uptane_client_;
 
  private:
+  bool RunUptaneCycleSteps();
+
   struct {
     std::mutex m;
     std::condition_variable cv;
@@ -72,6 +72,11 @@ struct UptaneConfig {
   bool force_install_completion{false};
   boost::filesystem::path secondary_config_file;
   uint64_t secondary_preinstall_wait_sec{600U};
+  uint64_t secondary_install_max_parallel{0U};
+  uint64_t secondary_install_max_parallel_per_type{0U};
+  bool secondary_install_largest_first{false};
+  uint64_t verification_max_parallel{1U};
+  uint64_t delegations_fetch_max_parallel{1U};
 
   void updateFromPropertyTree(const boost::property_tree::ptree& pt);
   void writeToStream(std::ostream& out_stream) const;
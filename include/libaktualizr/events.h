@@ -190,6 +190,21 @@ class CampaignPostponeComplete : public BaseEvent {
   CampaignPostponeComplete() { variant = TypeName; }
 };
 
+/**
+ * An Uptane cycle has ended. Reports the metadata processing statistics of
+ * the cycle.
+ */
+class MetadataMetricsReport : public BaseEvent {
+ public:
+  static constexpr const char* TypeName{"MetadataMetricsReport"};
+
+  explicit MetadataMetricsReport(result::MetadataMetrics metrics_in) : metrics(std::move(metrics_in)) {
+    variant = TypeName;
+  }
+
+  result::MetadataMetrics metrics;
+};
+
 using Channel = boost::signals2::signal<void(std::shared_ptr<event::BaseEvent>)>;
 
 }  // namespace event
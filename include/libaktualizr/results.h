@@ -2,6 +2,7 @@
 #define RESULTS_H_
 /** \file */
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -150,6 +151,51 @@ class Install {
   };
 };
 
+/**
+ * Latency and size statistics of one step ("fetch", "verify" or "store") of
+ * the processing of one Uptane metadata role.
+ *
+ * Bucket i of a histogram counts the samples up to the i-th bound of
+ * LatencyBoundsUs() (resp. SizeBoundsBytes()), the last bucket counts the
+ * samples above the last bound.
+ */
+class MetadataStepMetrics {
+ public:
+  static std::vector<uint64_t> LatencyBoundsUs() { return {100, 1000, 10000, 100000, 1000000, 10000000}; }
+  static std::vector<uint64_t> SizeBoundsBytes() {
+    return {1024, 16 * 1024, 64 * 1024, 256 * 1024, 1024 * 1024, 8 * 1024 * 1024};
+  }
+
+  MetadataStepMetrics(std::string repo_in, std::string role_in, std::string step_in)
+      : repo(std::move(repo_in)),
+        role(std::move(role_in)),
+        step(std::move(step_in)),
+        latency_histogram(LatencyBoundsUs().size() + 1),
+        size_histogram(SizeBoundsBytes().size() + 1) {}
+
+  std::string repo;  // "director" or "image"
+  std::string role;
+  std::string step;
+  uint64_t count{0};
+  uint64_t failures{0};
+  uint64_t bytes{0};
+  uint64_t total_us{0};
+  uint64_t max_us{0};
+  std::vector<uint64_t> latency_histogram;
+  std::vector<uint64_t> size_histogram;
+};
+
+/**
+ * Statistics of the Uptane metadata processing, one entry per repository,
+ * role and step that has been run.
+ */
+class MetadataMetrics {
+ public:
+  MetadataMetrics() = default;
+  explicit MetadataMetrics(std::vector<MetadataStepMetrics> steps_in) : steps(std::move(steps_in)) {}
+  std::vector<MetadataStepMetrics> steps;
+};
+
 }  // namespace result
 
 #endif  // RESULTS_H_
@@ -3,6 +3,7 @@
 /** \file */
 
 #include <algorithm>
+#include <memory>
 #include <stdexcept>
 #include <unordered_map>
 
@@ -171,15 +172,21 @@ class Hash {
   static std::string TypeString(Type type);
   std::string TypeString() const;
   Type type() const;
-  std::string HashString() const { return hash_; }
+  /** Upper case hex representation of the digest. */
+  std::string HashString() const;
   friend std::ostream &operator<<(std::ostream &os, const Hash &h);
 
   static std::string encodeVector(const std::vector<Hash> &hashes);
   static std::vector<Hash> decodeVector(std::string hashes_str);
 
  private:
+  void setHash(const std::string &hash);
+
   Type type_;
+  // Raw digest bytes if the hash was given as a valid hex string (half the
+  // size of the hex form), the upper case string as given otherwise.
   std::string hash_;
+  bool binary_{false};
 };
 
 std::ostream &operator<<(std::ostream &os, const Hash &h);
@@ -319,26 +326,36 @@ class HardwareIdentifier {
   static const int kMaxLength = 200;
 
   static HardwareIdentifier Unknown() { return HardwareIdentifier("Unknown"); }
-  explicit HardwareIdentifier(const std::string &hwid) : hwid_(hwid) {
+  explicit HardwareIdentifier(const std::string &hwid) {
     /* if (hwid.length() < kMinLength) {
       throw std::out_of_range("Hardware Identifier too short");
     } */
     if (kMaxLength < hwid.length()) {
       throw std::out_of_range("Hardware Identifier too long");
     }
+    hwid_ = intern(hwid);
   }
+  // No move operations: a moved-from identifier would be left without a value.
+  HardwareIdentifier(const HardwareIdentifier &) = default;
+  HardwareIdentifier &operator=(const HardwareIdentifier &) = default;
+  ~HardwareIdentifier() = default;
 
-  std::string ToString() const { return hwid_; }
+  const std::string &ToString() const { return *hwid_; }
 
   bool operator==(const HardwareIdentifier &rhs) const { return hwid_ == rhs.hwid_; }
   bool operator!=(const HardwareIdentifier &rhs) const { return !(*this == rhs); }
 
-  bool operator<(const HardwareIdentifier &rhs) const { return hwid_ < rhs.hwid_; }
+  bool operator<(const HardwareIdentifier &rhs) const { return *hwid_ < *rhs.hwid_; }
   friend std::ostream &operator<<(std::ostream &os, const HardwareIdentifier &hwid);
   friend struct std::hash<Uptane::HardwareIdentifier>;
 
  private:
-  std::string hwid_;
+  // The same few hardware IDs are repeated in every Target of a repository,
+  // so all live identifiers with the same value share a single string. This
+  // also makes comparing them for equality a pointer comparison.
+  static std::shared_ptr<const std::string> intern(const std::string &hwid);
+
+  std::shared_ptr<const std::string> hwid_;
 };
 
 std::ostream &operator<<(std::ostream &os, const HardwareIdentifier &hwid);
@@ -380,6 +397,8 @@ class Target {
  public:
   // From Uptane metadata
   Target(std::string filename, const Json::Value &content);
+  // From Uptane metadata, taking over the custom data of `content`
+  Target(std::string filename, Json::Value &&content);
   // Internal use only. Only used for reading installed_versions list and by
   // various tests.
   Target(std::string filename, EcuMap ecus, std::vector<Hash> hashes, uint64_t length, std::string correlation_id = "");
@@ -387,19 +406,20 @@ class Target {
   static Target Unknown();
 
   const EcuMap &ecus() const { return ecus_; }
-  std::string filename() const { return filename_; }
+  const std::string &filename() const { return filename_; }
   std::string sha256Hash() const;
   std::string sha512Hash() const;
   const std::vector<Hash> &hashes() const { return hashes_; }
   const std::vector<HardwareIdentifier> &hardwareIds() const { return hwids_; }
   std::string custom_version() const;
-  Json::Value custom_data() const { return custom_; }
-  void updateCustom(const Json::Value &custom);
-  std::string correlation_id() const { return correlation_id_; }
+  const Json::Value &custom_data() const;
+  void updateCustom(const Json::Value &custom) { updateCustom(Json::Value(custom)); }
+  void updateCustom(Json::Value &&custom);
+  const std::string &correlation_id() const { return correlation_id_; }
   void setCorrelationId(std::string correlation_id) { correlation_id_ = std::move(correlation_id); }
   uint64_t length() const { return length_; }
   bool IsValid() const { return valid; }
-  std::string uri() const { return uri_; }
+  const std::string &uri() const { return uri_; }
   void setUri(std::string uri) { uri_ = std::move(uri); }
   bool MatchHash(const Hash &hash) const;
 
@@ -419,7 +439,7 @@ class Target {
    * root commit object.
    */
   bool IsOstree() const;
-  std::string type() const { return type_; }
+  const std::string &type() const { return type_; }
 
   // Comparison is usually not meaningful. Use MatchTarget instead.
   bool operator==(const Target &t2) = delete;
@@ -435,11 +455,14 @@ class Target {
   EcuMap ecus_;  // Director only
   std::vector<Hash> hashes_;
   std::vector<HardwareIdentifier> hwids_;  // Image repo only
-  Json::Value custom_;
+  // Immutable once set, so that copies of a Target (of which there are many)
+  // share it instead of duplicating the whole JSON tree.
+  std::shared_ptr<const Json::Value> custom_;
   uint64_t length_{0};
   std::string correlation_id_;
   std::string uri_;
 
+  void init(const Json::Value &content);
   std::string hashString(Hash::Type type) const;
 };
 
@@ -88,7 +88,8 @@ bpo::variables_map parseOptions(int argc, char **argv) {
 }
 
 void processEvent(const std::shared_ptr<event::BaseEvent> &event) {
-  if (event->isTypeOf<event::DownloadProgressReport>() || event->variant == "UpdateCheckComplete") {
+  if (event->isTypeOf<event::DownloadProgressReport>() || event->isTypeOf<event::MetadataMetricsReport>() ||
+      event->variant == "UpdateCheckComplete") {
     // Do nothing; libaktualizr already logs it.
   } else if (event->variant == "AllDownloadsComplete") {
     const auto *downloads_complete = dynamic_cast<event::AllDownloadsComplete *>(event.get());
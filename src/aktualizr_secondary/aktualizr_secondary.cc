@@ -9,10 +9,19 @@
 #include <sys/types.h>
 #include <memory>
 
+const std::string AktualizrSecondary::kVerifiedMetaCacheFile{"verified_metadata.json"};
+
 AktualizrSecondary::AktualizrSecondary(AktualizrSecondaryConfig config, std::shared_ptr<INvStorage> storage)
     : config_(std::move(config)),
       storage_(std::move(storage)),
       keys_(std::make_shared<KeyManager>(storage_, config_.keymanagerConfig())) {
+  // The Primary re-sends the same metadata after retries and reboots; don't
+  // verify the signatures of what we have already verified.
+  auto verified_meta_cache = std::make_shared<Uptane::VerifiedMetaCache>(config_.storage.path / kVerifiedMetaCacheFile);
+  director_repo_.setVerifiedMetaCache(verified_meta_cache);
+  image_repo_.setVerifiedMetaCache(verified_meta_cache);
+  director_repo_.setMaxParallelVerifications(config_.uptane.verification_max_parallel);
+  image_repo_.setMaxParallelVerifications(config_.uptane.verification_max_parallel);
   uptaneInitialize();
   manifest_issuer_ = std::make_shared<Uptane::ManifestIssuer>(keys_, ecu_serial_);
   registerHandlers();
@@ -192,13 +201,16 @@ void AktualizrSecondary::initPendingTargetIfAny() {
 
 void AktualizrSecondary::registerHandlers() {
   registerHandler(AKIpUptaneMes_PR_getInfoReq,
-                  std::bind(&AktualizrSecondary::getInfoHdlr, this, std::placeholders::_1, std::placeholders::_2));
+                  std::bind(&AktualizrSecondary::getInfoHdlr, this, std::placeholders::_1, std::placeholders::_2),
+                  HandlerType::kReadOnly);
 
   registerHandler(AKIpUptaneMes_PR_versionReq,
-                  std::bind(&AktualizrSecondary::versionHdlr, std::placeholders::_1, std::placeholders::_2));
+                  std::bind(&AktualizrSecondary::versionHdlr, std::placeholders::_1, std::placeholders::_2),
+                  HandlerType::kReadOnly);
 
   registerHandler(AKIpUptaneMes_PR_manifestReq,
-                  std::bind(&AktualizrSecondary::getManifestHdlr, this, std::placeholders::_1, std::placeholders::_2));
+                  std::bind(&AktualizrSecondary::getManifestHdlr, this, std::placeholders::_1, std::placeholders::_2),
+                  HandlerType::kReadOnly);
 
   registerHandler(AKIpUptaneMes_PR_putMetaReq2,
                   std::bind(&AktualizrSecondary::putMetaHdlr, this, std::placeholders::_1, std::placeholders::_2));
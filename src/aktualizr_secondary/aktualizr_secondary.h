@@ -16,6 +16,7 @@ class KeyManager;
 class AktualizrSecondary : public MsgDispatcher {
  public:
   using Ptr = std::shared_ptr<AktualizrSecondary>;
+  static const std::string kVerifiedMetaCacheFile;
 
   virtual void initialize() = 0;
   const Uptane::EcuSerial& serial() const { return ecu_serial_; }
@@ -6,12 +6,14 @@ void AktualizrSecondaryNetConfig::updateFromPropertyTree(const boost::property_t
   CopyFromConfig(port, "port", pt);
   CopyFromConfig(primary_ip, "primary_ip", pt);
   CopyFromConfig(primary_port, "primary_port", pt);
+  CopyFromConfig(max_connections, "max_connections", pt);
 }
 
 void AktualizrSecondaryNetConfig::writeToStream(std::ostream& out_stream) const {
   writeOption(out_stream, port, "port");
   writeOption(out_stream, primary_ip, "primary_ip");
   writeOption(out_stream, primary_port, "primary_port");
+  writeOption(out_stream, max_connections, "max_connections");
 }
 
 void AktualizrSecondaryUptaneConfig::updateFromPropertyTree(const boost::property_tree::ptree& pt) {
@@ -20,6 +22,8 @@ void AktualizrSecondaryUptaneConfig::updateFromPropertyTree(const boost::propert
   CopyFromConfig(key_source, "key_source", pt);
   CopyFromConfig(key_type, "key_type", pt);
   CopyFromConfig(force_install_completion, "force_install_completion", pt);
+  CopyFromConfig(verification_max_parallel, "verification_max_parallel", pt);
+  CopyFromConfig(verify_installed_image, "verify_installed_image", pt);
 }
 
 void AktualizrSecondaryUptaneConfig::writeToStream(std::ostream& out_stream) const {
@@ -28,6 +32,8 @@ void AktualizrSecondaryUptaneConfig::writeToStream(std::ostream& out_stream) con
   writeOption(out_stream, key_source, "key_source");
   writeOption(out_stream, key_type, "key_type");
   writeOption(out_stream, force_install_completion, "force_install_completion");
+  writeOption(out_stream, verification_max_parallel, "verification_max_parallel");
+  writeOption(out_stream, verify_installed_image, "verify_installed_image");
 }
 
 AktualizrSecondaryConfig::AktualizrSecondaryConfig(const boost::program_options::variables_map& cmd) {
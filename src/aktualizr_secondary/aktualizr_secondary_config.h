@@ -16,6 +16,7 @@ struct AktualizrSecondaryNetConfig {
   in_port_t port{9030};
   std::string primary_ip;
   in_port_t primary_port{9030};
+  size_t max_connections{1};
 
   void updateFromPropertyTree(const boost::property_tree::ptree& pt);
   void writeToStream(std::ostream& out_stream) const;
@@ -27,6 +28,8 @@ struct AktualizrSecondaryUptaneConfig {
   CryptoSource key_source{CryptoSource::kFile};
   KeyType key_type{KeyType::kRSA2048};
   bool force_install_completion{false};
+  uint64_t verification_max_parallel{1U};
+  bool verify_installed_image{false};
 
   void updateFromPropertyTree(const boost::property_tree::ptree& pt);
   void writeToStream(std::ostream& out_stream) const;
@@ -7,6 +7,8 @@ TEST(aktualizr_secondary_config, config_initialized_values) {
   AktualizrSecondaryConfig conf;
 
   EXPECT_EQ(conf.network.port, 9030);
+  // the installed image is only hashed again when its file changes
+  EXPECT_FALSE(conf.uptane.verify_installed_image);
 }
 
 TEST(aktualizr_secondary_config, config_toml_parsing) {
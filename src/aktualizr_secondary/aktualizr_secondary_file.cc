@@ -9,9 +9,13 @@ AktualizrSecondaryFile::AktualizrSecondaryFile(const AktualizrSecondaryConfig& c
 AktualizrSecondaryFile::AktualizrSecondaryFile(const AktualizrSecondaryConfig& config,
                                                std::shared_ptr<INvStorage> storage,
                                                std::shared_ptr<FileUpdateAgent> update_agent)
-    : AktualizrSecondary(config, std::move(storage)), update_agent_{std::move(update_agent)} {
+    : AktualizrSecondary(config, std::move(storage)),
+      update_agent_{std::move(update_agent)},
+      verify_installed_image_{config.uptane.verify_installed_image} {
   registerHandler(AKIpUptaneMes_PR_uploadDataReq, std::bind(&AktualizrSecondaryFile::uploadDataHdlr, this,
                                                             std::placeholders::_1, std::placeholders::_2));
+  registerUploadDataHandler(std::bind(&AktualizrSecondaryFile::rawUploadDataHdlr, this, std::placeholders::_1,
+                                      std::placeholders::_2, std::placeholders::_3));
   if (!update_agent_) {
     std::string current_target_name;
 
@@ -30,7 +34,14 @@ AktualizrSecondaryFile::AktualizrSecondaryFile(const AktualizrSecondaryConfig& c
   }
 }
 
-void AktualizrSecondaryFile::initialize() { initPendingTargetIfAny(); }
+void AktualizrSecondaryFile::initialize() {
+  // Otherwise the cached hash is checked against the image file's metadata
+  // when the first manifest is assembled, without reading the image.
+  if (verify_installed_image_ && !update_agent_->verifyInstalledImage()) {
+    LOG_WARNING << "The installed image does not match its recorded hash";
+  }
+  initPendingTargetIfAny();
+}
 
 data::InstallationResult AktualizrSecondaryFile::receiveData(const uint8_t* data, size_t size) {
   if (!pendingTarget().IsValid()) {
@@ -61,19 +72,24 @@ data::InstallationResult AktualizrSecondaryFile::installPendingTarget(const Upta
 void AktualizrSecondaryFile::completeInstall() { return update_agent_->completeInstall(); }
 
 MsgHandler::ReturnCode AktualizrSecondaryFile::uploadDataHdlr(Asn1Message& in_msg, Asn1Message& out_msg) {
-  if (last_msg_ != AKIpUptaneMes_PR_uploadDataReq) {
-    LOG_INFO << "Received an initial data upload request message; attempting to receive data...";
-  } else {
-    LOG_DEBUG << "Received another data upload request message; attempting to receive data...";
-  }
-
   auto rec_buf_size = in_msg.uploadDataReq()->data.size;
   if (rec_buf_size < 0) {
     LOG_ERROR << "The received data buffer size is negative: " << rec_buf_size;
     return ReturnCode::kOk;
   }
 
-  auto result = receiveData(in_msg.uploadDataReq()->data.buf, static_cast<size_t>(rec_buf_size));
+  return rawUploadDataHdlr(in_msg.uploadDataReq()->data.buf, static_cast<size_t>(rec_buf_size), out_msg);
+}
+
+MsgHandler::ReturnCode AktualizrSecondaryFile::rawUploadDataHdlr(const uint8_t* data, size_t size,
+                                                                 Asn1Message& out_msg) {
+  if (last_msg_ != AKIpUptaneMes_PR_uploadDataReq) {
+    LOG_INFO << "Received an initial data upload request message; attempting to receive data...";
+  } else {
+    LOG_DEBUG << "Received another data upload request message; attempting to receive data...";
+  }
+
+  auto result = receiveData(data, size);
 
   auto m = out_msg.present(AKIpUptaneMes_PR_uploadDataResp).uploadDataResp();
   m->result = static_cast<AKInstallationResultCode_t>(result.result_code.num_code);
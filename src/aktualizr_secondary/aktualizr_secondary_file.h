@@ -26,9 +26,11 @@ class AktualizrSecondaryFile : public AktualizrSecondary {
   void completeInstall() override;
 
   ReturnCode uploadDataHdlr(Asn1Message& in_msg, Asn1Message& out_msg);
+  ReturnCode rawUploadDataHdlr(const uint8_t* data, size_t size, Asn1Message& out_msg);
 
  private:
   std::shared_ptr<FileUpdateAgent> update_agent_;
+  const bool verify_installed_image_;
 };
 
 #endif  // AKTUALIZR_SECONDARY_FILE_H
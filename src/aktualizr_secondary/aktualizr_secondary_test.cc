@@ -63,6 +63,10 @@ class AktualizrSecondaryWrapper {
     return storage_dir_.Path() / AktualizrSecondaryFile::FileUpdateDefaultFile;
   }
 
+  boost::filesystem::path verifiedMetaCachePath() const {
+    return storage_dir_.Path() / AktualizrSecondary::kVerifiedMetaCacheFile;
+  }
+
   std::shared_ptr<NiceMock<UpdateAgentMock>> update_agent_;
 
  private:
@@ -325,6 +329,18 @@ TEST_F(SecondaryTest, fullUptaneVerificationPositive) {
   EXPECT_EQ(manifest.filepath(), target.filename());
 }
 
+TEST_F(SecondaryTest, ResendIdenticalMetadata) {
+  // The signatures of the first bundle are verified and remembered; sending it
+  // again (e.g. after a Primary reboot) must still pass the remaining checks.
+  ASSERT_TRUE(secondary_->putMetadata(uptane_repo_.getCurrentMetadata()).isSuccess());
+  EXPECT_TRUE(boost::filesystem::exists(secondary_.verifiedMetaCachePath()));
+  ASSERT_TRUE(secondary_->putMetadata(uptane_repo_.getCurrentMetadata()).isSuccess());
+
+  // New metadata is verified as usual.
+  uptane_repo_.refreshRoot(Uptane::RepositoryType::Director());
+  EXPECT_TRUE(secondary_->putMetadata(uptane_repo_.getCurrentMetadata()).isSuccess());
+}
+
 TEST_F(SecondaryTest, TwoImagesAndOneTarget) {
   // two images for the same ECU, just one of them is added as a target and signed
   // default image and corresponding target has been already added, just add another image
@@ -109,7 +109,8 @@ int main(int argc, char *argv[]) {
     secondary->initialize();
 
     SecondaryTcpServer tcp_server(*secondary, config.network.primary_ip, config.network.primary_port,
-                                  config.network.port, config.uptane.force_install_completion);
+                                  config.network.port, config.uptane.force_install_completion,
+                                  config.network.max_connections);
 
     tcp_server.run();
 
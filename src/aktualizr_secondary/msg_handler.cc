@@ -2,19 +2,31 @@
 
 #include "logging/logging.h"
 
-void MsgDispatcher::clearHandlers() { handler_map_.clear(); }
+void MsgDispatcher::clearHandlers() {
+  handler_map_.clear();
+  upload_data_handler_ = nullptr;
+}
 
-void MsgDispatcher::registerHandler(AKIpUptaneMes_PR msg_id, Handler handler) {
-  handler_map_[msg_id] = std::move(handler);
+void MsgDispatcher::registerHandler(AKIpUptaneMes_PR msg_id, Handler handler, HandlerType type) {
+  handler_map_[msg_id] = std::make_pair(std::move(handler), type);
 }
 
+void MsgDispatcher::registerUploadDataHandler(UploadDataHandler handler) { upload_data_handler_ = std::move(handler); }
+
 MsgHandler::ReturnCode MsgDispatcher::handleMsg(const Asn1Message::Ptr& in_msg, Asn1Message::Ptr& out_msg) {
   auto find_res_it = handler_map_.find(in_msg->present());
   if (find_res_it == handler_map_.end()) {
     return MsgHandler::kUnkownMsg;
   }
   LOG_TRACE << "Found a handler for the request, processing it...";
-  auto handle_status_code = find_res_it->second(*in_msg, *out_msg);
+  ReturnCode handle_status_code;
+  if (find_res_it->second.second == HandlerType::kReadOnly) {
+    boost::shared_lock<boost::shared_mutex> lock(state_mutex_);
+    handle_status_code = find_res_it->second.first(*in_msg, *out_msg);
+  } else {
+    boost::unique_lock<boost::shared_mutex> lock(state_mutex_);
+    handle_status_code = find_res_it->second.first(*in_msg, *out_msg);
+  }
   LOG_TRACE << "Request handler returned a response: " << out_msg->toStr();
 
   // Track the last message to help cut down on repetitive logging. Ignore the
@@ -24,3 +36,16 @@ MsgHandler::ReturnCode MsgDispatcher::handleMsg(const Asn1Message::Ptr& in_msg,
   }
   return handle_status_code;
 }
+
+MsgHandler::ReturnCode MsgDispatcher::handleUploadData(const uint8_t* data, size_t size, Asn1Message::Ptr& out_msg) {
+  if (!upload_data_handler_) {
+    return MsgHandler::kUnkownMsg;
+  }
+  ReturnCode handle_status_code;
+  {
+    boost::unique_lock<boost::shared_mutex> lock(state_mutex_);
+    handle_status_code = upload_data_handler_(data, size, *out_msg);
+  }
+  last_msg_ = AKIpUptaneMes_PR_uploadDataReq;
+  return handle_status_code;
+}
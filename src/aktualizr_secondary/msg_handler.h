@@ -1,8 +1,12 @@
 #ifndef MSG_HANDLER_H
 #define MSG_HANDLER_H
 
+#include <atomic>
 #include <memory>
 #include <unordered_map>
+#include <utility>
+
+#include <boost/thread/shared_mutex.hpp>
 
 #include "AKIpUptaneMes.h"
 #include "asn1/asn1_message.h"
@@ -21,22 +25,49 @@ class MsgHandler {
 
  public:
   virtual ReturnCode handleMsg(const Asn1Message::Ptr& in_msg, Asn1Message::Ptr& out_msg) = 0;
+
+  /**
+   * Handle the payload of an uploadDataReq message straight from the receive
+   * buffer, without decoding it into an Asn1Message first. Returns kUnkownMsg
+   * if raw payloads are not supported, in which case the message is decoded
+   * and passed to handleMsg() instead.
+   */
+  virtual ReturnCode handleUploadData(const uint8_t* data, size_t size, Asn1Message::Ptr& out_msg) {
+    (void)data;
+    (void)size;
+    (void)out_msg;
+    return kUnkownMsg;
+  }
 };
 
+/**
+ * Dispatches messages to the handlers registered for them.
+ *
+ * Messages can be handled from several connections at once. Handlers that
+ * change the Secondary state are run exclusively, while read-only handlers
+ * may run in parallel with each other.
+ */
 class MsgDispatcher : public MsgHandler {
  public:
   using Handler = std::function<ReturnCode(Asn1Message&, Asn1Message&)>;
+  using UploadDataHandler = std::function<ReturnCode(const uint8_t*, size_t, Asn1Message&)>;
+  enum class HandlerType { kMutating, kReadOnly };
 
-  void registerHandler(AKIpUptaneMes_PR msg_id, Handler handler);
+  void registerHandler(AKIpUptaneMes_PR msg_id, Handler handler, HandlerType type = HandlerType::kMutating);
+  // Register a handler for uploadDataReq payloads that are not decoded (see MsgHandler::handleUploadData).
+  void registerUploadDataHandler(UploadDataHandler handler);
   ReturnCode handleMsg(const Asn1Message::Ptr& in_msg, Asn1Message::Ptr& out_msg) override;
+  ReturnCode handleUploadData(const uint8_t* data, size_t size, Asn1Message::Ptr& out_msg) override;
 
  protected:
   void clearHandlers();
 
-  unsigned int last_msg_ = 0;
+  std::atomic<unsigned int> last_msg_{0};
 
  private:
-  std::unordered_map<unsigned int, Handler> handler_map_;
+  std::unordered_map<unsigned int, std::pair<Handler, HandlerType>> handler_map_;
+  UploadDataHandler upload_data_handler_;
+  boost::shared_mutex state_mutex_;
 };
 
 #endif  // MSG_HANDLER_H
@@ -1,4 +1,9 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include <netinet/tcp.h>
@@ -66,9 +71,12 @@ class SecondaryMock : public MsgDispatcher {
   size_t getReceivedImageSize() const { return boost::filesystem::file_size(image_filepath_); }
 
   const std::string& getReceivedTlsCreds() const { return tls_creds_; }
+  size_t rawUploadRequests() const { return raw_upload_requests_; }
 
   // Used by both protocol versions:
   void registerBaseHandlers() {
+    registerUploadDataHandler(nullptr);
+
     registerHandler(AKIpUptaneMes_PR_getInfoReq,
                     std::bind(&SecondaryMock::getInfoHdlr, this, std::placeholders::_1, std::placeholders::_2));
 
@@ -98,6 +106,8 @@ class SecondaryMock : public MsgDispatcher {
 
     registerHandler(AKIpUptaneMes_PR_uploadDataReq,
                     std::bind(&SecondaryMock::uploadDataHdlr, this, std::placeholders::_1, std::placeholders::_2));
+    registerUploadDataHandler(std::bind(&SecondaryMock::rawUploadDataHdlr, this, std::placeholders::_1,
+                                        std::placeholders::_2, std::placeholders::_3));
 
     registerHandler(AKIpUptaneMes_PR_downloadOstreeRevReq,
                     std::bind(&SecondaryMock::downloadOstreeRev, this, std::placeholders::_1, std::placeholders::_2));
@@ -300,6 +310,17 @@ class SecondaryMock : public MsgDispatcher {
     return ReturnCode::kOk;
   }
 
+  MsgHandler::ReturnCode rawUploadDataHdlr(const uint8_t* data, size_t size, Asn1Message& out_msg) {
+    ++raw_upload_requests_;
+    auto result = receiveImageData(data, size);
+
+    auto m = out_msg.present(AKIpUptaneMes_PR_uploadDataResp).uploadDataResp();
+    m->result = static_cast<AKInstallationResultCode_t>(result.result_code.num_code);
+    SetString(&m->description, result.description);
+
+    return ReturnCode::kOk;
+  }
+
   MsgHandler::ReturnCode uploadDataFailureHdlr(Asn1Message& in_msg, Asn1Message& out_msg) {
     (void)in_msg;
 
@@ -380,6 +401,7 @@ class SecondaryMock : public MsgDispatcher {
   std::string tls_creds_;
   std::string received_firmware_data_;
   HandlerVersion handler_version_;
+  std::atomic<size_t> raw_upload_requests_{0};
 };
 
 class TargetFile {
@@ -534,6 +556,11 @@ class SecondaryRpcCommon : public ::testing::Test {
       EXPECT_TRUE(result.isSuccess());
       EXPECT_EQ(image_file_.hash(), secondary_.getReceivedImageHash());
     }
+
+    // v2 firmware data is handed over straight from the receive buffer
+    if (handler_version == HandlerVersion::kV2) {
+      EXPECT_GT(secondary_.rawUploadRequests(), 0u);
+    }
   }
 
   void installOstreeRev() {
@@ -734,11 +761,11 @@ class SecondaryRpcTestPositive : public ::testing::Test, public MsgHandler {
   std::thread secondary_server_thread_;
 };
 
-/* This test fails because the Secondary TCP server implementation is a
- * single-threaded, synchronous and blocking hence it cannot accept any new
- * connections until the current one is closed. Therefore, if a client/Primary
- * does not close its socket for some reason then Secondary becomes
- * "unavailable" */
+/* This test fails because the Secondary TCP server serves a single connection
+ * at a time by default, hence it cannot accept any new connections until the
+ * current one is closed. Therefore, if a client/Primary does not close its
+ * socket for some reason then Secondary becomes "unavailable". See
+ * SecondaryRpcTestConcurrent for the multi-connection mode. */
 // TEST_F(SecondaryRpcTestPositive, primaryNotClosingSocket) {
 //  ConnectionSocket con_sock{"127.0.0.1", secondary_server_.port()};
 //  con_sock.connect();
@@ -790,6 +817,135 @@ TEST_F(SecondaryRpcTestPositive, primaryConnectAndSendGarbage) {
   ASSERT_EQ(sendInstallMsg(), AKIpUptaneMes_PR_installResp);
 }
 
+/* This class serves several connections concurrently. The install handler is
+ * state-mutating and deliberately slow, the version handler is read-only. */
+class SecondaryRpcTestConcurrent : public ::testing::Test, public MsgDispatcher {
+ protected:
+  static constexpr size_t kMaxConnections{4};
+
+  SecondaryRpcTestConcurrent()
+      : secondary_server_{*this, "", 0, 0, false, kMaxConnections},
+        secondary_server_thread_{[&]() { secondary_server_.run(); }} {
+    registerHandler(AKIpUptaneMes_PR_installReq,
+                    std::bind(&SecondaryRpcTestConcurrent::installHdlr, this, std::placeholders::_1,
+                              std::placeholders::_2));
+    registerHandler(AKIpUptaneMes_PR_versionReq,
+                    std::bind(&SecondaryRpcTestConcurrent::versionHdlr, this, std::placeholders::_1,
+                              std::placeholders::_2),
+                    HandlerType::kReadOnly);
+    secondary_server_.wait_until_running();
+  }
+
+  ~SecondaryRpcTestConcurrent() {
+    secondary_server_.stop();
+    if (secondary_server_thread_.joinable()) {
+      secondary_server_thread_.join();
+    }
+  }
+
+  ReturnCode installHdlr(Asn1Message& in_msg, Asn1Message& out_msg) {
+    (void)in_msg;
+    EXPECT_FALSE(mutating_.exchange(true));
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    mutating_.store(false);
+    out_msg.present(AKIpUptaneMes_PR_installResp).installResp()->result = AKInstallationResultCode_ok;
+    return ReturnCode::kOk;
+  }
+
+  ReturnCode versionHdlr(Asn1Message& in_msg, Asn1Message& out_msg) {
+    (void)in_msg;
+    EXPECT_FALSE(mutating_.load());
+    out_msg.present(AKIpUptaneMes_PR_versionResp).versionResp()->version = 2;
+    return ReturnCode::kOk;
+  }
+
+  AKIpUptaneMes_PR sendInstallMsg() {
+    Asn1Message::Ptr req(Asn1Message::Empty());
+    req->present(AKIpUptaneMes_PR_installReq);
+    SetString(&req->installReq()->hash, "target_name");
+    return Asn1Rpc(req, {"127.0.0.1", secondary_server_.port()})->present();
+  }
+
+  AKIpUptaneMes_PR sendVersionMsg() {
+    Asn1Message::Ptr req(Asn1Message::Empty());
+    req->present(AKIpUptaneMes_PR_versionReq);
+    req->versionReq()->version = 2;
+    return Asn1Rpc(req, {"127.0.0.1", secondary_server_.port()})->present();
+  }
+
+  std::atomic<bool> mutating_{false};
+  SecondaryTcpServer secondary_server_;
+  std::thread secondary_server_thread_;
+};
+
+constexpr size_t SecondaryRpcTestConcurrent::kMaxConnections;
+
+/* A Primary connection that is never closed does not make the Secondary
+ * unavailable for other connections. */
+TEST_F(SecondaryRpcTestConcurrent, primaryNotClosingSocket) {
+  ConnectionSocket con_sock{"127.0.0.1", secondary_server_.port()};
+  con_sock.connect();
+  ASSERT_EQ(sendInstallMsg(), AKIpUptaneMes_PR_installResp);
+  ASSERT_EQ(sendVersionMsg(), AKIpUptaneMes_PR_versionResp);
+}
+
+/* The server stops while a Primary keeps its connections open, both idle and
+ * after a request/response exchange. */
+TEST_F(SecondaryRpcTestConcurrent, stopWithOpenConnections) {
+  ConnectionSocket idle_sock{"127.0.0.1", secondary_server_.port()};
+  idle_sock.connect();
+  ConnectionSocket con_sock{"127.0.0.1", secondary_server_.port()};
+  con_sock.connect();
+  Asn1Message::Ptr req(Asn1Message::Empty());
+  req->present(AKIpUptaneMes_PR_versionReq);
+  req->versionReq()->version = 2;
+  ASSERT_EQ(Asn1Rpc(req, *con_sock)->present(), AKIpUptaneMes_PR_versionResp);
+
+  secondary_server_.stop();
+  auto joined = std::async(std::launch::async, [this]() { secondary_server_thread_.join(); });
+  ASSERT_EQ(joined.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+}
+
+/* Load test: several clients send a mix of state-mutating and read-only
+ * requests while another connection is stalled. Reports the request latency
+ * and checks that every request is served. */
+TEST_F(SecondaryRpcTestConcurrent, RequestLatencyUnderLoad) {
+  ConnectionSocket stalled_sock{"127.0.0.1", secondary_server_.port()};
+  stalled_sock.connect();
+
+  const size_t clients = kMaxConnections - 1;
+  const size_t requests_per_client = 40;
+  std::vector<std::vector<int64_t>> latencies(clients);
+  std::vector<std::thread> client_threads;
+  for (size_t c = 0; c < clients; ++c) {
+    client_threads.emplace_back([this, c, &latencies]() {
+      for (size_t r = 0; r < requests_per_client; ++r) {
+        const auto start = std::chrono::steady_clock::now();
+        if ((r + c) % 2 == 0) {
+          EXPECT_EQ(sendInstallMsg(), AKIpUptaneMes_PR_installResp);
+        } else {
+          EXPECT_EQ(sendVersionMsg(), AKIpUptaneMes_PR_versionResp);
+        }
+        latencies[c].push_back(
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+      }
+    });
+  }
+  for (auto& t : client_threads) {
+    t.join();
+  }
+
+  std::vector<int64_t> all;
+  for (const auto& l : latencies) {
+    all.insert(all.end(), l.begin(), l.end());
+  }
+  ASSERT_EQ(all.size(), clients * requests_per_client);
+  std::sort(all.begin(), all.end());
+  LOG_INFO << "Request latency with " << clients << " concurrent clients: p50 " << all[all.size() / 2] << " us, p95 "
+           << all[all.size() * 95 / 100] << " us, max " << all.back() << " us";
+  EXPECT_LT(all.back(), 5 * 1000 * 1000);
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
 
@@ -1,6 +1,14 @@
 #include "secondary_tcp_server.h"
 
+#include <fcntl.h>
 #include <netinet/tcp.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <thread>
+#include <vector>
 
 #include "AKInstallationResultCode.h"
 #include "AKIpUptaneMes.h"
@@ -10,12 +18,16 @@
 #include "utilities/dequeue_buffer.h"
 
 SecondaryTcpServer::SecondaryTcpServer(MsgHandler &msg_handler, const std::string &primary_ip, in_port_t primary_port,
-                                       in_port_t port, bool reboot_after_install)
+                                       in_port_t port, bool reboot_after_install, size_t max_connections)
     : msg_handler_(msg_handler),
       listen_socket_(port),
       keep_running_(true),
       reboot_after_install_(reboot_after_install),
+      max_connections_(std::max<size_t>(max_connections, 1)),
       is_running_(false) {
+  if (pipe2(wake_pipe_, O_CLOEXEC) != 0) {
+    throw std::system_error(errno, std::system_category(), "pipe2");
+  }
   if (primary_ip.empty()) {
     return;
   }
@@ -29,10 +41,21 @@ SecondaryTcpServer::SecondaryTcpServer(MsgHandler &msg_handler, const std::strin
   }
 }
 
+SecondaryTcpServer::~SecondaryTcpServer() {
+  close(wake_pipe_[0]);
+  close(wake_pipe_[1]);
+}
+
 void SecondaryTcpServer::run() {
   if (listen(*listen_socket_, SOMAXCONN) < 0) {
     throw std::system_error(errno, std::system_category(), "listen");
   }
+  // Several workers are woken up by one connection, only one of them gets it.
+  // The others must not block in accept().
+  const int listen_flags = fcntl(*listen_socket_, F_GETFL);
+  if (listen_flags < 0 || fcntl(*listen_socket_, F_SETFL, listen_flags | O_NONBLOCK) < 0) {
+    throw std::system_error(errno, std::system_category(), "fcntl");
+  }
   LOG_INFO << "Secondary TCP server listening on " << listen_socket_.toString();
 
   {
@@ -41,14 +64,47 @@ void SecondaryTcpServer::run() {
     running_condition_.notify_all();
   }
 
-  bool first_connection = true;
+  // Every worker waits for a connection on the shared listening socket and
+  // serves the connection it gets until the Primary closes it.
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < max_connections_; ++i) {
+    workers.emplace_back(&SecondaryTcpServer::AcceptConnections, this);
+  }
+  AcceptConnections();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(running_condition_mutex_);
+    is_running_ = false;
+    running_condition_.notify_all();
+  }
+
+  LOG_INFO << "Secondary TCP server exiting.";
+}
 
+void SecondaryTcpServer::AcceptConnections() {
   while (keep_running_.load()) {
     sockaddr_storage peer_sa{};
     socklen_t peer_sa_size = sizeof(sockaddr_storage);
 
     LOG_DEBUG << "Waiting for connection from Primary...";
+    std::array<pollfd, 2> fds{{{*listen_socket_, POLLIN, 0}, {wake_pipe_[0], POLLIN, 0}}};
+    if (poll(fds.data(), fds.size(), -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG_INFO << "Socket poll failed, aborting.";
+      break;
+    }
+    if (fds[1].revents != 0) {
+      break;  // stopped
+    }
     int con_fd = accept(*listen_socket_, reinterpret_cast<sockaddr *>(&peer_sa), &peer_sa_size);
+    if (con_fd == -1 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+      continue;  // another worker got the connection
+    }
     if (con_fd == -1) {
       // Accept can fail if a client closes connection/client socket before a TCP handshake completes or
       // a network connection goes down in the middle of a TCP handshake procedure. At first glance it looks like
@@ -61,33 +117,58 @@ void SecondaryTcpServer::run() {
       break;
     }
 
-    if (first_connection) {
+    Socket connection(con_fd);
+    // The listening socket is non-blocking, the connection must not be
+    const int con_flags = fcntl(con_fd, F_GETFL);
+    if (con_flags >= 0) {
+      fcntl(con_fd, F_SETFL, con_flags & ~O_NONBLOCK);
+    }
+    {
+      std::lock_guard<std::mutex> lock(connections_mutex_);
+      if (!keep_running_.load()) {
+        break;
+      }
+      connections_.insert(con_fd);
+    }
+
+    if (first_connection_.exchange(false)) {
       LOG_INFO << "Primary connected.";
-      first_connection = false;
     } else {
       LOG_DEBUG << "Primary reconnected.";
     }
-    auto continue_running = HandleOneConnection(*Socket(con_fd));
+    auto continue_running = HandleOneConnection(con_fd);
+    LOG_DEBUG << "Primary disconnected.";
+    {
+      std::lock_guard<std::mutex> lock(connections_mutex_);
+      connections_.erase(con_fd);
+    }
     if (!continue_running) {
-      keep_running_.store(false);
+      break;
     }
-    LOG_DEBUG << "Primary disconnected.";
   }
 
-  {
-    std::unique_lock<std::mutex> lock(running_condition_mutex_);
-    is_running_ = false;
-    running_condition_.notify_all();
-  }
+  // The first worker to leave takes the others down with it.
+  Shutdown();
+}
 
-  LOG_INFO << "Secondary TCP server exiting.";
+void SecondaryTcpServer::Shutdown() {
+  std::lock_guard<std::mutex> lock(connections_mutex_);
+  keep_running_.store(false);
+  // The pipe is never read from, so it wakes up every worker for good
+  const char wake_up = 0;
+  if (write(wake_pipe_[1], &wake_up, 1) < 0) {
+    LOG_ERROR << "Failed to wake up the Secondary TCP server workers: " << strerror(errno);
+  }
+  // recv() returns 0 on a connection that has been shut down, as if the
+  // Primary had closed it
+  for (const int con_fd : connections_) {
+    shutdown(con_fd, SHUT_RDWR);
+  }
 }
 
 void SecondaryTcpServer::stop() {
   LOG_DEBUG << "Stopping Secondary TCP server...";
-  keep_running_.store(false);
-  // unblock accept
-  ConnectionSocket("localhost", listen_socket_.port()).connect();
+  Shutdown();
 }
 
 in_port_t SecondaryTcpServer::port() const { return listen_socket_.port(); }
@@ -95,6 +176,76 @@ SecondaryTcpServer::ExitReason SecondaryTcpServer::exit_reason() const { return
 
 static bool sendResponseMessage(int socket_fd, const Asn1Message::Ptr &resp_msg);
 
+namespace {
+
+enum class RawUpload { kNo, kIncomplete, kComplete };
+
+// Parse a BER tag and definite length. Returns the size of the header, 0 if
+// more data is needed or -1 if the header does not match.
+int ParseBerHeader(const uint8_t *buf, size_t size, uint8_t tag, size_t *length) {
+  if (size < 2) {
+    return 0;
+  }
+  if (buf[0] != tag) {
+    return -1;
+  }
+  if ((buf[1] & 0x80U) == 0) {
+    *length = buf[1];
+    return 2;
+  }
+  const size_t length_bytes = buf[1] & 0x7FU;
+  if (length_bytes == 0 || length_bytes > 3) {
+    // indefinite length or far bigger than anything we could buffer
+    return -1;
+  }
+  if (size < 2 + length_bytes) {
+    return 0;
+  }
+  *length = 0;
+  for (size_t i = 0; i < length_bytes; ++i) {
+    *length = (*length << 8U) | buf[2 + i];
+  }
+  return static_cast<int>(2 + length_bytes);
+}
+
+// Recognize an uploadDataReq message that carries nothing but its data and
+// fits into the receive buffer, so that the payload can be handed over
+// without being decoded (and copied) into an Asn1Message.
+RawUpload PeekUploadDataReq(const uint8_t *buf, size_t size, size_t capacity, size_t *msg_size, const uint8_t **data,
+                            size_t *data_size) {
+  // uploadDataReq [10] EXPLICIT, AKUploadDataReqMes SEQUENCE, data OCTET STRING
+  const std::array<uint8_t, 3> tags{0xAA, 0x30, 0x04};
+  size_t offset = 0;
+  for (size_t i = 0; i < tags.size(); ++i) {
+    size_t length = 0;
+    const int header = ParseBerHeader(buf + offset, size - offset, tags[i], &length);
+    if (header < 0) {
+      return RawUpload::kNo;
+    }
+    if (header == 0) {
+      return RawUpload::kIncomplete;
+    }
+    offset += static_cast<size_t>(header);
+    if (i == 0) {
+      *msg_size = offset + length;
+      if (*msg_size > capacity) {
+        return RawUpload::kNo;
+      }
+    } else if (offset + length != *msg_size) {
+      // there are other elements (extensions) in the message
+      return RawUpload::kNo;
+    }
+    *data_size = length;
+  }
+  if (size < *msg_size) {
+    return RawUpload::kIncomplete;
+  }
+  *data = buf + offset;
+  return RawUpload::kComplete;
+}
+
+}  // namespace
+
 bool SecondaryTcpServer::HandleOneConnection(int socket) {
   // Outside the message loop, because one recv() may have parts of 2 messages
   // Note that one recv() call returning 2+ messages doesn't work at the
@@ -107,13 +258,35 @@ bool SecondaryTcpServer::HandleOneConnection(int socket) {
   while (keep_running_current_session) {  // Keep reading until we get an error
     // Read an incomming message
     AKIpUptaneMes_t *m = nullptr;
-    asn_dec_rval_t res;
+    asn_dec_rval_t res{RC_WMORE, 0};
     asn_codec_ctx_s context{};
     ssize_t received;
+    RawUpload raw_upload = RawUpload::kNo;
+    size_t raw_upload_size = 0;
+    const uint8_t *upload_data = nullptr;
+    size_t upload_data_size = 0;
+    bool decoder_started = false;
 
     do {
       received = recv(socket, buffer.Tail(), buffer.TailSpace(), 0);
-      buffer.HaveEnqueued(static_cast<size_t>(received));
+      if (received > 0) {
+        buffer.HaveEnqueued(static_cast<size_t>(received));
+      }
+      if (!decoder_started) {
+        // Firmware data is written straight from the receive buffer. Only
+        // try this before the decoder has started on the message.
+        raw_upload = PeekUploadDataReq(reinterpret_cast<const uint8_t *>(buffer.Head()), buffer.Size(),
+                                       buffer.Size() + buffer.TailSpace(), &raw_upload_size, &upload_data,
+                                       &upload_data_size);
+        if (raw_upload == RawUpload::kComplete) {
+          res.code = RC_OK;
+          break;
+        }
+        if (raw_upload == RawUpload::kIncomplete) {
+          continue;
+        }
+      }
+      decoder_started = true;
       res = ber_decode(&context, &asn_DEF_AKIpUptaneMes, reinterpret_cast<void **>(&m), buffer.Head(), buffer.Size());
       buffer.Consume(res.consumed);
     } while (res.code == RC_WMORE && received > 0);
@@ -135,9 +308,28 @@ bool SecondaryTcpServer::HandleOneConnection(int socket) {
       break;
     }
 
-    LOG_DEBUG << "Received a request from Primary: " << request_msg->toStr();
     Asn1Message::Ptr response_msg = Asn1Message::Empty();
-    MsgHandler::ReturnCode handle_status_code = msg_handler_.handleMsg(request_msg, response_msg);
+    MsgHandler::ReturnCode handle_status_code = MsgHandler::kUnkownMsg;
+    if (raw_upload == RawUpload::kComplete) {
+      LOG_TRACE << "Received " << upload_data_size << " bytes of firmware data from Primary";
+      handle_status_code = msg_handler_.handleUploadData(upload_data, upload_data_size, response_msg);
+      if (handle_status_code == MsgHandler::kUnkownMsg) {
+        // the handler only takes decoded messages
+        res = ber_decode(&context, &asn_DEF_AKIpUptaneMes, reinterpret_cast<void **>(&m), buffer.Head(),
+                         raw_upload_size);
+        request_msg = Asn1Message::FromRaw(&m);
+        if (res.code != RC_OK) {
+          LOG_ERROR << "Failed to decode a message received from Primary";
+          break;
+        }
+      }
+      buffer.Consume(raw_upload_size);
+    }
+
+    if (raw_upload != RawUpload::kComplete || handle_status_code == MsgHandler::kUnkownMsg) {
+      LOG_DEBUG << "Received a request from Primary: " << request_msg->toStr();
+      handle_status_code = msg_handler_.handleMsg(request_msg, response_msg);
+    }
 
     switch (handle_status_code) {
       case MsgHandler::ReturnCode::kRebootRequired: {
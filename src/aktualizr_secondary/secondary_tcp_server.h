@@ -4,6 +4,7 @@
 #include <atomic>
 #include <condition_variable>
 #include <mutex>
+#include <set>
 
 #include "utilities/utils.h"
 
@@ -12,6 +13,10 @@ class MsgHandler;
 /**
  * Listens on a socket, decodes calls (ASN.1) and forwards them to an Uptane Secondary
  * implementation
+ *
+ * Up to `max_connections` connections are served concurrently, each one by its own
+ * worker thread. Serializing the calls that mutate the Secondary state is up to the
+ * MsgHandler implementation (see MsgDispatcher).
  */
 class SecondaryTcpServer {
  public:
@@ -22,8 +27,9 @@ class SecondaryTcpServer {
   };
 
   SecondaryTcpServer(MsgHandler& msg_handler, const std::string& primary_ip, in_port_t primary_port, in_port_t port = 0,
-                     bool reboot_after_install = false);
+                     bool reboot_after_install = false, size_t max_connections = 1);
 
+  ~SecondaryTcpServer();
   SecondaryTcpServer(const SecondaryTcpServer&) = delete;
   SecondaryTcpServer& operator=(const SecondaryTcpServer&) = delete;
 
@@ -40,6 +46,10 @@ class SecondaryTcpServer {
   ExitReason exit_reason() const;
 
  private:
+  void AcceptConnections();
+  // Make every worker return: wake up the ones waiting for a connection and
+  // shut down the connections being served
+  void Shutdown();
   bool HandleOneConnection(int socket);
 
  private:
@@ -47,7 +57,13 @@ class SecondaryTcpServer {
   ListenSocket listen_socket_;
   std::atomic<bool> keep_running_;
   bool reboot_after_install_;
-  ExitReason exit_reason_{ExitReason::kNotApplicable};
+  const size_t max_connections_;
+  std::atomic<bool> first_connection_{true};
+  std::atomic<ExitReason> exit_reason_{ExitReason::kNotApplicable};
+  int wake_pipe_[2]{-1, -1};  // written to by Shutdown()
+
+  std::mutex connections_mutex_;
+  std::set<int> connections_;  // sockets of the connections being served
 
   bool is_running_;
   std::mutex running_condition_mutex_;
@@ -1,5 +1,13 @@
 #include "update_agent_file.h"
-#include <fstream>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
 #include "crypto/crypto.h"
 #include "logging/logging.h"
 #include "uptane/manifest.h"
@@ -9,12 +17,12 @@
 bool FileUpdateAgent::isTargetSupported(const Uptane::Target& target) const { return target.type() != "OSTREE"; }
 
 bool FileUpdateAgent::getInstalledImageInfo(Uptane::InstalledImageInfo& installed_image_info) const {
-  if (boost::filesystem::exists(target_filepath_)) {
-    auto file_content = Utils::readFile(target_filepath_);
-
+  std::string hash;
+  uint64_t len = 0;
+  if (image_cache_.get(&hash, &len)) {
     installed_image_info.name = current_target_name_;
-    installed_image_info.len = file_content.size();
-    installed_image_info.hash = Uptane::ManifestIssuer::generateVersionHashStr(file_content);
+    installed_image_info.len = len;
+    installed_image_info.hash = hash;
   } else {
     // mimic the Primary's fake package manager behavior
     auto unknown_target = Uptane::Target::Unknown();
@@ -26,7 +34,17 @@ bool FileUpdateAgent::getInstalledImageInfo(Uptane::InstalledImageInfo& installe
   return true;
 }
 
+bool FileUpdateAgent::verifyInstalledImage() const {
+  if (!boost::filesystem::exists(target_filepath_)) {
+    return true;
+  }
+  return image_cache_.verify();
+}
+
+FileUpdateAgent::~FileUpdateAgent() { closeNewTarget(); }
+
 data::InstallationResult FileUpdateAgent::install(const Uptane::Target& target) {
+  closeNewTarget();
   if (!boost::filesystem::exists(new_target_filepath_)) {
     LOG_ERROR << "The target image has not been received";
     return data::InstallationResult(data::ResultCode::Numeric::kDownloadFailed,
@@ -44,13 +62,14 @@ data::InstallationResult FileUpdateAgent::install(const Uptane::Target& target)
                                         " != " + std::to_string(target.length()));
   }
 
-  if (!target.MatchHash(new_target_hasher_->getHash())) {
-    LOG_ERROR << "The received image's hash does not match the hash specified in Target metadata: "
-              << new_target_hasher_->getHash() << " != " << getTargetHash(target).HashString();
+  // Note that getHash() finalizes the hasher, so it can only be called once.
+  const Hash received_hash = new_target_hasher_->getHash();
+  if (!target.MatchHash(received_hash)) {
+    LOG_ERROR << "The received image's hash does not match the hash specified in Target metadata: " << received_hash
+              << " != " << getTargetHash(target).HashString();
     return data::InstallationResult(data::ResultCode::Numeric::kDownloadFailed,
                                     "The received image's hash does not match the hash specified in Target metadata: " +
-                                        new_target_hasher_->getHash().HashString() +
-                                        " != " + getTargetHash(target).HashString());
+                                        received_hash.HashString() + " != " + getTargetHash(target).HashString());
   }
 
   boost::filesystem::rename(new_target_filepath_, target_filepath_);
@@ -65,6 +84,14 @@ data::InstallationResult FileUpdateAgent::install(const Uptane::Target& target)
                                     "The target image has not been installed");
   }
 
+  // The manifest reports the SHA-256 of the image; if that is what we have
+  // just verified, there is no need to read the image again later.
+  if (received_hash.type() == Hash::Type::kSha256) {
+    image_cache_.store(received_hash, received_target_image_size);
+  } else {
+    image_cache_.invalidate();
+  }
+
   current_target_name_ = target.filename();
   new_target_hasher_.reset();
   return data::InstallationResult(data::ResultCode::Numeric::kOk, "");
@@ -79,64 +106,120 @@ data::InstallationResult FileUpdateAgent::applyPendingInstall(const Uptane::Targ
 }
 
 data::InstallationResult FileUpdateAgent::receiveData(const Uptane::Target& target, const uint8_t* data, size_t size) {
-  std::ofstream target_file(new_target_filepath_.c_str(),
-                            std::ofstream::out | std::ofstream::binary | std::ofstream::app);
-
-  if (!target_file.good()) {
-    LOG_ERROR << "Failed to open a new target image file";
-    return data::InstallationResult(data::ResultCode::Numeric::kDownloadFailed,
-                                    "Failed to open a new target image file");
+  // The new image file is kept open until the image is installed, instead of
+  // being reopened for each chunk.
+  if (new_target_fd_ < 0) {
+    new_target_fd_ = open(new_target_filepath_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0666);
+    if (new_target_fd_ < 0) {
+      LOG_ERROR << "Failed to open a new target image file: " << std::strerror(errno);
+      return data::InstallationResult(data::ResultCode::Numeric::kDownloadFailed,
+                                      "Failed to open a new target image file");
+    }
+
+    struct stat st {};
+    if (fstat(new_target_fd_, &st) != 0) {
+      LOG_ERROR << "Failed to obtain a size of the new target image that is being uploaded";
+      closeNewTarget();
+      return data::InstallationResult(data::ResultCode::Numeric::kDownloadFailed,
+                                      "Failed to obtain a size of the new target image that is being uploaded");
+    }
+    new_target_size_ = static_cast<uint64_t>(st.st_size);
+
+    if (new_target_size_ != 0 && !new_target_hasher_) {
+      // left over from an upload interrupted by a restart, it cannot be resumed
+      LOG_WARNING << "Discarding a partially received target image of " << new_target_size_ << " bytes";
+      if (ftruncate(new_target_fd_, 0) != 0) {
+        LOG_ERROR << "Failed to discard the partially received target image: " << std::strerror(errno);
+        closeNewTarget();
+        return data::InstallationResult(data::ResultCode::Numeric::kDownloadFailed,
+                                        "Failed to discard the partially received target image");
+      }
+      new_target_size_ = 0;
+    }
   }
 
-  auto current_new_image_size = target_file.tellp();
-  if (-1 == current_new_image_size) {
-    LOG_ERROR << "Failed to obtain a size of the new target image that is being uploaded";
-    target_file.close();
-    return data::InstallationResult(data::ResultCode::Numeric::kDownloadFailed,
-                                    "Failed to obtain a size of the new target image that is being uploaded");
-  }
-
-  if (static_cast<uint64_t>(current_new_image_size) >= target.length()) {
-    LOG_ERROR << "The size of the received image data exceeds the expected Target image size: "
-              << current_new_image_size << " != " << target.length();
-    target_file.close();
+  if (new_target_size_ >= target.length()) {
+    LOG_ERROR << "The size of the received image data exceeds the expected Target image size: " << new_target_size_
+              << " != " << target.length();
+    closeNewTarget();
     return data::InstallationResult(data::ResultCode::Numeric::kDownloadFailed,
                                     "The size of the received image data exceeds the expected Target image size: " +
-                                        std::to_string(current_new_image_size) +
-                                        " != " + std::to_string(target.length()));
+                                        std::to_string(new_target_size_) + " != " + std::to_string(target.length()));
   }
 
-  if (current_new_image_size == 0) {
+  if (new_target_size_ == 0) {
     new_target_hasher_ = MultiPartHasher::create(getTargetHash(target).type());
+    receive_stats_.start();
   }
 
-  target_file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
-  auto written_data_size = target_file.tellp() - current_new_image_size;
+  size_t written_data_size = 0;
+  while (written_data_size < size) {
+    const ssize_t written = write(new_target_fd_, data + written_data_size, size - written_data_size);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      break;
+    }
+    written_data_size += static_cast<size_t>(written);
+  }
 
-  if (written_data_size < 0 || static_cast<size_t>(written_data_size) != size) {
+  if (written_data_size != size) {
     LOG_ERROR << "The size of data written is not equal to the received data size: " << written_data_size
               << " != " << size;
-    target_file.close();
+    closeNewTarget();
     return data::InstallationResult(data::ResultCode::Numeric::kDownloadFailed,
                                     "The size of data written is not equal to the received data size: " +
                                         std::to_string(written_data_size) + " != " + std::to_string(size));
   }
 
-  target_file.close();
+  // hash the data while it is still in the receive buffer
+  new_target_hasher_->update(data, size);
+  new_target_size_ += size;
 
-  auto total_size = current_new_image_size + written_data_size;
   LOG_DEBUG << "Received and stored data of a new target image."
                " Received in this request (bytes): "
-            << size << "; total received so far: " << total_size << "; expected total: " << target.length();
-  if (static_cast<uint64_t>(total_size) == target.length()) {
-    LOG_INFO << "Successfully received and stored new target image of " << total_size << " bytes.";
+            << size << "; total received so far: " << new_target_size_ << "; expected total: " << target.length();
+  if (new_target_size_ == target.length()) {
+    LOG_INFO << "Successfully received and stored new target image of " << new_target_size_ << " bytes.";
+    receive_stats_.log(new_target_size_);
   }
 
-  new_target_hasher_->update(data, size);
-
   return data::InstallationResult(data::ResultCode::Numeric::kOk, "");
 }
 
+void FileUpdateAgent::closeNewTarget() {
+  if (new_target_fd_ >= 0) {
+    close(new_target_fd_);
+    new_target_fd_ = -1;
+  }
+}
+
+static int64_t cpuTimeUs() {
+  struct rusage usage {};
+  getrusage(RUSAGE_SELF, &usage);
+  return (static_cast<int64_t>(usage.ru_utime.tv_sec) + usage.ru_stime.tv_sec) * 1000000 + usage.ru_utime.tv_usec +
+         usage.ru_stime.tv_usec;
+}
+
+void FileUpdateAgent::ReceiveStats::start() {
+  start_time = std::chrono::steady_clock::now();
+  start_cpu_us = cpuTimeUs();
+}
+
+void FileUpdateAgent::ReceiveStats::log(uint64_t received) const {
+  const auto cpu_us = cpuTimeUs() - start_cpu_us;
+  struct rusage usage {};
+  getrusage(RUSAGE_SELF, &usage);
+  const auto elapsed_ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
+  const double mbytes = static_cast<double>(received) / (1024 * 1024);
+  // ru_maxrss is in kilobytes on Linux
+  LOG_INFO << "Target image received in " << elapsed_ms << " ms; CPU time per MB: "
+           << (mbytes > 0 ? static_cast<double>(cpu_us) / 1000 / mbytes : 0) << " ms; peak RSS: " << usage.ru_maxrss
+           << " KB";
+}
+
 Hash FileUpdateAgent::getTargetHash(const Uptane::Target& target) {
   // TODO(OTA-4831): check target.hashes() size.
   return target.hashes()[0];
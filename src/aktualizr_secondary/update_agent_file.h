@@ -1,18 +1,25 @@
 #ifndef AKTUALIZR_SECONDARY_UPDATE_AGENT_FILE_H
 #define AKTUALIZR_SECONDARY_UPDATE_AGENT_FILE_H
 
+#include <chrono>
+
 #include "update_agent.h"
+#include "uptane/installedimagecache.h"
 
 class FileUpdateAgent : public UpdateAgent {
  public:
   FileUpdateAgent(boost::filesystem::path target_filepath, std::string target_name)
       : target_filepath_{std::move(target_filepath)},
         new_target_filepath_{target_filepath_.string() + ".newtarget"},
-        current_target_name_{std::move(target_name)} {}
+        current_target_name_{std::move(target_name)},
+        image_cache_{target_filepath_} {}
+  ~FileUpdateAgent() override;
 
  public:
   bool isTargetSupported(const Uptane::Target& target) const override;
   bool getInstalledImageInfo(Uptane::InstalledImageInfo& installed_image_info) const override;
+  // Re-hash the installed image and refresh its cached hash.
+  bool verifyInstalledImage() const;
 
   virtual data::InstallationResult receiveData(const Uptane::Target& target, const uint8_t* data, size_t size);
   data::InstallationResult install(const Uptane::Target& target) override;
@@ -22,12 +29,26 @@ class FileUpdateAgent : public UpdateAgent {
 
  private:
   static Hash getTargetHash(const Uptane::Target& target);
+  void closeNewTarget();
+
+  // CPU time and memory used to receive an image, logged once it is complete.
+  struct ReceiveStats {
+    void start();
+    void log(uint64_t received) const;
+
+    std::chrono::steady_clock::time_point start_time;
+    int64_t start_cpu_us{0};
+  };
 
  private:
   const boost::filesystem::path target_filepath_;
   const boost::filesystem::path new_target_filepath_;
   std::string current_target_name_;
   std::shared_ptr<MultiPartHasher> new_target_hasher_;
+  int new_target_fd_{-1};
+  uint64_t new_target_size_{0};
+  ReceiveStats receive_stats_;
+  Uptane::InstalledImageCache image_cache_;
 };
 
 #endif  // AKTUALIZR_SECONDARY_UPDATE_AGENT_FILE_H
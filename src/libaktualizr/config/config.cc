@@ -95,6 +95,11 @@ void UptaneConfig::updateFromPropertyTree(const boost::property_tree::ptree& pt)
   CopyFromConfig(force_install_completion, "force_install_completion", pt);
   CopyFromConfig(secondary_config_file, "secondary_config_file", pt);
   CopyFromConfig(secondary_preinstall_wait_sec, "secondary_preinstall_wait_sec", pt);
+  CopyFromConfig(secondary_install_max_parallel, "secondary_install_max_parallel", pt);
+  CopyFromConfig(secondary_install_max_parallel_per_type, "secondary_install_max_parallel_per_type", pt);
+  CopyFromConfig(secondary_install_largest_first, "secondary_install_largest_first", pt);
+  CopyFromConfig(verification_max_parallel, "verification_max_parallel", pt);
+  CopyFromConfig(delegations_fetch_max_parallel, "delegations_fetch_max_parallel", pt);
 }
 
 void UptaneConfig::writeToStream(std::ostream& out_stream) const {
@@ -106,6 +111,11 @@ void UptaneConfig::writeToStream(std::ostream& out_stream) const {
   writeOption(out_stream, force_install_completion, "force_install_completion");
   writeOption(out_stream, secondary_config_file, "secondary_config_file");
   writeOption(out_stream, secondary_preinstall_wait_sec, "secondary_preinstall_wait_sec");
+  writeOption(out_stream, secondary_install_max_parallel, "secondary_install_max_parallel");
+  writeOption(out_stream, secondary_install_max_parallel_per_type, "secondary_install_max_parallel_per_type");
+  writeOption(out_stream, secondary_install_largest_first, "secondary_install_largest_first");
+  writeOption(out_stream, verification_max_parallel, "verification_max_parallel");
+  writeOption(out_stream, delegations_fetch_max_parallel, "delegations_fetch_max_parallel");
 }
 
 /**
@@ -1,8 +1,13 @@
 #include "crypto.h"
 
+#include <algorithm>
 #include <array>
+#include <cctype>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <random>
+#include <unordered_map>
 
 #include <sodium.h>
 #include <boost/algorithm/hex.hpp>
@@ -11,6 +16,7 @@
 #include "libaktualizr/types.h"
 #include "logging/logging.h"
 #include "openssl_compat.h"
+#include "utilities/parallel.h"
 #include "utilities/utils.h"
 
 PublicKey::PublicKey(const boost::filesystem::path &path) : value_(Utils::readFile(path)) {
@@ -70,16 +76,7 @@ PublicKey::PublicKey(const std::string &value, KeyType type) : value_(value), ty
 }
 
 bool PublicKey::VerifySignature(const std::string &signature, const std::string &message) const {
-  switch (type_) {
-    case KeyType::kED25519:
-      return Crypto::ED25519Verify(boost::algorithm::unhex(value_), Utils::fromBase64(signature), message);
-    case KeyType::kRSA2048:
-    case KeyType::kRSA3072:
-    case KeyType::kRSA4096:
-      return Crypto::RSAPSSVerify(value_, Utils::fromBase64(signature), message);
-    default:
-      return false;
-  }
+  return Crypto::signatureVerifier()->verify(*this, signature, message);
 }
 
 bool PublicKey::operator==(const PublicKey &rhs) const { return value_ == rhs.value_ && type_ == rhs.type_; }
@@ -113,6 +110,44 @@ std::string PublicKey::KeyId() const {
   return keyid;
 }
 
+bool SignatureVerifier::verify(const PublicKey &key, const std::string &signature, const std::string &message) const {
+  switch (key.Type()) {
+    case KeyType::kED25519:
+      return Crypto::ED25519Verify(boost::algorithm::unhex(key.Value()), Utils::fromBase64(signature), message);
+    case KeyType::kRSA2048:
+    case KeyType::kRSA3072:
+    case KeyType::kRSA4096:
+      return Crypto::RSAPSSVerify(key.Value(), Utils::fromBase64(signature), message);
+    default:
+      return false;
+  }
+}
+
+std::vector<bool> SignatureVerifier::verifyBatch(const std::vector<SignatureCheck> &checks, size_t max_threads) const {
+  // std::vector<bool> can't be written from several threads
+  std::vector<char> valid(checks.size(), 0);
+  parallelFor(checks.size(), max_threads, [&](size_t i) {
+    valid[i] = verify(*checks[i].key, checks[i].signature, *checks[i].message) ? 1 : 0;
+  });
+  return std::vector<bool>(valid.cbegin(), valid.cend());
+}
+
+namespace {
+SignatureVerifier::Ptr &installedSignatureVerifier() {
+  static SignatureVerifier::Ptr verifier = std::make_shared<SignatureVerifier>();
+  return verifier;
+}
+}  // namespace
+
+SignatureVerifier::Ptr Crypto::signatureVerifier() { return std::atomic_load(&installedSignatureVerifier()); }
+
+void Crypto::setSignatureVerifier(SignatureVerifier::Ptr verifier) {
+  if (verifier == nullptr) {
+    verifier = std::make_shared<SignatureVerifier>();
+  }
+  std::atomic_store(&installedSignatureVerifier(), std::move(verifier));
+}
+
 std::string Crypto::sha256digest(const std::string &text) {
   std::array<unsigned char, crypto_hash_sha256_BYTES> sha256_hash{};
   crypto_hash_sha256(sha256_hash.data(), reinterpret_cast<const unsigned char *>(text.c_str()), text.size());
@@ -198,24 +233,72 @@ std::string Crypto::ED25519Sign(const std::string &private_key, const std::strin
   return std::string(reinterpret_cast<char *>(sig.data()), crypto_sign_BYTES);
 }
 
-bool Crypto::RSAPSSVerify(const std::string &public_key, const std::string &signature, const std::string &message) {
-  StructGuard<RSA> rsa(nullptr, RSA_free);
-  StructGuard<BIO> bio(BIO_new_mem_buf(const_cast<char *>(public_key.c_str()), static_cast<int>(public_key.size())),
-                       BIO_vfree);
-  {
+namespace {
+
+// Parsed RSA public keys, keyed by their PEM encoding. The same few keys are
+// used to verify all the metadata and manifests, and parsing a key costs about
+// as much as verifying a signature with it.
+class RsaPublicKeyCache {
+ public:
+  std::shared_ptr<RSA> get(const std::string &public_key) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = keys_.find(public_key);
+      if (it != keys_.end()) {
+        return it->second;
+      }
+    }
+
+    std::shared_ptr<RSA> rsa = parse(public_key);
+    if (rsa == nullptr) {
+      return rsa;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (keys_.size() >= kMaxKeys) {
+      keys_.clear();
+    }
+    keys_.emplace(public_key, rsa);
+    return rsa;
+  }
+
+ private:
+  static std::shared_ptr<RSA> parse(const std::string &public_key) {
+    StructGuard<BIO> bio(BIO_new_mem_buf(const_cast<char *>(public_key.c_str()), static_cast<int>(public_key.size())),
+                         BIO_vfree);
     RSA *r = nullptr;
     if (PEM_read_bio_RSA_PUBKEY(bio.get(), &r, nullptr, nullptr) == nullptr) {
       LOG_ERROR << "PEM_read_bio_RSA_PUBKEY failed with error " << ERR_error_string(ERR_get_error(), nullptr);
-      return false;
+      return std::shared_ptr<RSA>();
     }
-    rsa.reset(r);
-  }
+    std::shared_ptr<RSA> rsa(r, RSA_free);
 
 #if AKTUALIZR_OPENSSL_PRE_11
-  RSA_set_method(rsa.get(), RSA_PKCS1_SSLeay());
+    RSA_set_method(rsa.get(), RSA_PKCS1_SSLeay());
 #else
-  RSA_set_method(rsa.get(), RSA_PKCS1_OpenSSL());
+    RSA_set_method(rsa.get(), RSA_PKCS1_OpenSSL());
 #endif
+    return rsa;
+  }
+
+  static const size_t kMaxKeys = 64;
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<RSA>> keys_;
+};
+
+RsaPublicKeyCache &rsaPublicKeyCache() {
+  static RsaPublicKeyCache cache;
+  return cache;
+}
+
+}  // namespace
+
+bool Crypto::RSAPSSVerify(const std::string &public_key, const std::string &signature, const std::string &message) {
+  const std::shared_ptr<RSA> rsa = rsaPublicKeyCache().get(public_key);
+  if (rsa == nullptr) {
+    return false;
+  }
 
   const auto size = static_cast<unsigned int>(RSA_size(rsa.get()));
   boost::scoped_array<unsigned char> pDecrypted(new unsigned char[size]);
@@ -684,15 +767,15 @@ MultiPartHasher::Ptr MultiPartHasher::create(Hash::Type hash_type) {
 }
 
 Hash Hash::generate(Type type, const std::string &data) {
-  std::string hash;
+  Hash res(type, std::string());
 
   switch (type) {
     case Type::kSha256: {
-      hash = boost::algorithm::hex(Crypto::sha256digest(data));
+      res.hash_ = Crypto::sha256digest(data);
       break;
     }
     case Type::kSha512: {
-      hash = boost::algorithm::hex(Crypto::sha512digest(data));
+      res.hash_ = Crypto::sha512digest(data);
       break;
     }
     default: {
@@ -700,10 +783,10 @@ Hash Hash::generate(Type type, const std::string &data) {
     }
   }
 
-  return Hash(type, hash);
+  return res;
 }
 
-Hash::Hash(const std::string &type, const std::string &hash) : hash_(boost::algorithm::to_upper_copy(hash)) {
+Hash::Hash(const std::string &type, const std::string &hash) {
   if (type == "sha512") {
     type_ = Hash::Type::kSha512;
   } else if (type == "sha256") {
@@ -711,11 +794,21 @@ Hash::Hash(const std::string &type, const std::string &hash) : hash_(boost::algo
   } else {
     type_ = Hash::Type::kUnknownAlgorithm;
   }
+  setHash(hash);
 }
 
-Hash::Hash(Type type, const std::string &hash) : type_(type), hash_(boost::algorithm::to_upper_copy(hash)) {}
+Hash::Hash(Type type, const std::string &hash) : type_(type) { setHash(hash); }
 
-bool Hash::operator==(const Hash &other) const { return type_ == other.type_ && hash_ == other.hash_; }
+void Hash::setHash(const std::string &hash) {
+  binary_ = hash.size() % 2 == 0 && std::all_of(hash.cbegin(), hash.cend(), [](char c) { return isxdigit(c) != 0; });
+  hash_ = binary_ ? boost::algorithm::unhex(hash) : boost::algorithm::to_upper_copy(hash);
+}
+
+std::string Hash::HashString() const { return binary_ ? boost::algorithm::hex(hash_) : hash_; }
+
+bool Hash::operator==(const Hash &other) const {
+  return type_ == other.type_ && binary_ == other.binary_ && hash_ == other.hash_;
+}
 
 std::string Hash::TypeString(Type type) {
   switch (type) {
@@ -733,6 +826,6 @@ std::string Hash::TypeString() const { return TypeString(type_); }
 Hash::Type Hash::type() const { return type_; }
 
 std::ostream &operator<<(std::ostream &os, const Hash &h) {
-  os << "Hash: " << h.hash_;
+  os << "Hash: " << h.HashString();
   return os;
 }
@@ -12,8 +12,10 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/case_conv.hpp>
 
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "libaktualizr/types.h"
 #include "utilities/utils.h"
@@ -71,8 +73,49 @@ class MultiPartSHA256Hasher : public MultiPartHasher {
   crypto_hash_sha256_state state_{};
 };
 
+/**
+ * A signature to check against a message, as submitted to a
+ * SignatureVerifier. The key and the message must outlive the check.
+ */
+struct SignatureCheck {
+  SignatureCheck(const PublicKey &key_in, std::string signature_in, const std::string &message_in)
+      : key(&key_in), signature(std::move(signature_in)), message(&message_in) {}
+  const PublicKey *key;
+  std::string signature;  // base64 encoded, as found in metadata
+  const std::string *message;
+};
+
+/**
+ * Backend that checks signatures for PublicKey::VerifySignature() and the
+ * Uptane metadata verification. The default backend checks one signature at a
+ * time with libsodium and OpenSSL. Another one (e.g. one doing batched ED25519
+ * verification or using an accelerated OpenSSL provider) can be installed with
+ * Crypto::setSignatureVerifier().
+ */
+class SignatureVerifier {
+ public:
+  using Ptr = std::shared_ptr<SignatureVerifier>;
+  SignatureVerifier() = default;
+  virtual ~SignatureVerifier() = default;
+  SignatureVerifier(const SignatureVerifier &) = delete;
+  SignatureVerifier &operator=(const SignatureVerifier &) = delete;
+
+  virtual bool verify(const PublicKey &key, const std::string &signature, const std::string &message) const;
+  /**
+   * Check a batch of independent signatures, such as all the signatures of a
+   * metadata object. The default implementation calls verify() for every
+   * check, on up to `max_threads` threads.
+   * @return the result of every check, in order
+   */
+  virtual std::vector<bool> verifyBatch(const std::vector<SignatureCheck> &checks, size_t max_threads) const;
+};
+
 class Crypto {
  public:
+  static SignatureVerifier::Ptr signatureVerifier();
+  /** Install a signature verification backend; nullptr restores the default one. */
+  static void setSignatureVerifier(SignatureVerifier::Ptr verifier);
+
   static std::string sha256digest(const std::string &text);
   static std::string sha512digest(const std::string &text);
   static std::string RSAPSSSign(ENGINE *engine, const std::string &private_key, const std::string &message);
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "crypto/crypto.h"
+#include "logging/logging.h"
+#include "utilities/utils.h"
+
+/*
+ * Benchmarks of the signature verification. Not part of the test suite, run
+ * with `make benchmark-crypto` or give the name of one benchmark to
+ * `b_crypto`.
+ */
+
+namespace {
+
+const std::string text = "{\"_type\":\"Targets\",\"expires\":\"2038-01-19T03:14:06Z\",\"version\":1}";
+
+void check(const bool condition, const std::string& what) {
+  if (!condition) {
+    throw std::runtime_error("Check failed: " + what);
+  }
+}
+
+template <typename T>
+long long elapsedUs(const T& duration) {  // NOLINT(google-runtime-int)
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+/* Repeated verifications with the same key, as done when checking metadata,
+ * only pay the key parsing cost once. */
+void verify() {
+  const int iterations = 200;
+  for (const auto key_type : {KeyType::kRSA2048, KeyType::kRSA4096, KeyType::kED25519}) {
+    std::string public_key;
+    std::string private_key;
+    check(Crypto::generateKeyPair(key_type, &public_key, &private_key), "key generation");
+    const std::string signature = Utils::toBase64(Crypto::Sign(key_type, nullptr, private_key, text));
+    const PublicKey pkey(public_key, key_type);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+      check(pkey.VerifySignature(signature, text), "signature verification");
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Key type " << key_type << ": " << elapsedUs(elapsed) / iterations << " us per verification\n";
+  }
+}
+
+/* Checking the signatures of a metadata set one by one against submitting
+ * them as a batch to the default verification backend. */
+void verifyBatch() {
+  const size_t count = 64;
+  const size_t threads = std::max(1U, std::thread::hardware_concurrency());
+  for (const auto key_type : {KeyType::kRSA2048, KeyType::kED25519}) {
+    std::vector<PublicKey> keys;
+    std::vector<SignatureCheck> checks;
+    keys.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      std::string public_key;
+      std::string private_key;
+      check(Crypto::generateKeyPair(key_type, &public_key, &private_key), "key generation");
+      keys.emplace_back(public_key, key_type);
+      checks.emplace_back(keys.back(), Utils::toBase64(Crypto::Sign(key_type, nullptr, private_key, text)), text);
+    }
+
+    // parse and cache the keys first, so that both ways are timed alike
+    Crypto::signatureVerifier()->verifyBatch(checks, 1);
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& c : checks) {
+      check(c.key->VerifySignature(c.signature, text), "signature verification");
+    }
+    const auto single = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    const std::vector<bool> valid = Crypto::signatureVerifier()->verifyBatch(checks, threads);
+    const auto batch = std::chrono::steady_clock::now() - start;
+    check(valid == std::vector<bool>(count, true), "batch verification");
+
+    std::cout << "Key type " << key_type << ": " << count << " signatures checked in " << elapsedUs(single)
+              << " us one by one and in " << elapsedUs(batch) << " us as a batch on " << threads << " threads\n";
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  logger_init();
+  logger_set_threshold(boost::log::trivial::warning);
+
+  const std::map<std::string, std::function<void()>> benchmarks{
+      {"verify", verify},
+      {"verify-batch", verifyBatch},
+  };
+  if (argc != 2 || benchmarks.count(argv[1]) == 0) {
+    std::cerr << "Usage: " << argv[0] << " <benchmark>\nBenchmarks:";
+    for (const auto& b : benchmarks) {
+      std::cerr << " " << b.first;
+    }
+    std::cerr << "\n";
+    return EXIT_FAILURE;
+  }
+
+  try {
+    benchmarks.at(argv[1])();
+  } catch (const std::exception& e) {
+    std::cerr << argv[1] << ": " << e.what() << "\n";
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+// vim: set tabstop=2 shiftwidth=2 expandtab:
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <json/json.h>
 #include <boost/algorithm/hex.hpp>
@@ -309,6 +310,49 @@ TEST(crypto, parseBadPublicKeyJson) {
   EXPECT_EQ(PublicKey{o}.Type(), KeyType::kUnknown);
 }
 
+/* Parsed RSA keys are cached: repeated verifications with the same key keep
+ * giving the right answer, and a key that fails to parse keeps failing. */
+TEST(crypto, verify_rsa_cached_key) {
+  const std::string text = "{\"_type\":\"Targets\",\"expires\":\"2038-01-19T03:14:06Z\",\"version\":1}";
+  std::string public_key;
+  std::string private_key;
+  ASSERT_TRUE(Crypto::generateKeyPair(KeyType::kRSA2048, &public_key, &private_key));
+  const std::string signature = Utils::toBase64(Crypto::Sign(KeyType::kRSA2048, nullptr, private_key, text));
+  const PublicKey pkey(public_key, KeyType::kRSA2048);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(pkey.VerifySignature(signature, text));
+    EXPECT_FALSE(pkey.VerifySignature(signature, text + " "));
+  }
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_FALSE(Crypto::RSAPSSVerify("this is bad key", signature, text));
+  }
+}
+
+/* The default verification backend gives the result of every signature of a
+ * batch, whatever the number of threads. */
+TEST(crypto, verify_batch) {
+  const std::string text = "{\"_type\":\"Targets\",\"expires\":\"2038-01-19T03:14:06Z\",\"version\":1}";
+  std::vector<PublicKey> keys;
+  std::vector<SignatureCheck> checks;
+  std::vector<bool> expected;
+  keys.reserve(4);
+  for (const auto key_type : {KeyType::kRSA2048, KeyType::kED25519}) {
+    for (const bool valid : {true, false}) {
+      std::string public_key;
+      std::string private_key;
+      ASSERT_TRUE(Crypto::generateKeyPair(key_type, &public_key, &private_key));
+      keys.emplace_back(public_key, key_type);
+      const std::string signed_text = valid ? text : text + " ";
+      checks.emplace_back(keys.back(), Utils::toBase64(Crypto::Sign(key_type, nullptr, private_key, signed_text)),
+                          text);
+      expected.push_back(valid);
+    }
+  }
+  for (const size_t threads : {1, 4}) {
+    EXPECT_EQ(Crypto::signatureVerifier()->verifyBatch(checks, threads), expected);
+  }
+}
+
 #ifndef __NO_MAIN__
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
@@ -88,6 +88,7 @@ HttpClient::HttpClient(const std::string& socket) {
 }
 
 HttpClient::HttpClient(const HttpClient& curl_in) : pkcs11_key(curl_in.pkcs11_key), pkcs11_cert(curl_in.pkcs11_key) {
+  std::lock_guard<std::mutex> guard(curl_in.curl_mutex_);
   curl = curl_easy_duphandle(curl_in.curl);
   headers = curl_slist_dup(curl_in.headers);
 }
@@ -101,6 +102,7 @@ HttpClient::~HttpClient() {
 
 void HttpClient::setCerts(const std::string& ca, CryptoSource ca_source, const std::string& cert,
                           CryptoSource cert_source, const std::string& pkey, CryptoSource pkey_source) {
+  std::lock_guard<std::mutex> guard(curl_mutex_);
   curlEasySetoptWrapper(curl, CURLOPT_SSL_VERIFYPEER, 1);
   curlEasySetoptWrapper(curl, CURLOPT_SSL_VERIFYHOST, 2);
   curlEasySetoptWrapper(curl, CURLOPT_USE_SSL, CURLUSESSL_ALL);
@@ -140,8 +142,13 @@ void HttpClient::setCerts(const std::string& ca, CryptoSource ca_source, const s
   pkcs11_key = (pkey_source == CryptoSource::kPkcs11);
 }
 
+CURL* HttpClient::dupHandle() const {
+  std::lock_guard<std::mutex> guard(curl_mutex_);
+  return Utils::curlDupHandleWrapper(curl, pkcs11_key);
+}
+
 HttpResponse HttpClient::get(const std::string& url, int64_t maxsize) {
-  CURL* curl_get = Utils::curlDupHandleWrapper(curl, pkcs11_key);
+  CURL* curl_get = dupHandle();
 
   curlEasySetoptWrapper(curl_get, CURLOPT_HTTPHEADER, headers);
 
@@ -161,7 +168,7 @@ HttpResponse HttpClient::get(const std::string& url, int64_t maxsize) {
 }
 
 HttpResponse HttpClient::post(const std::string& url, const std::string& content_type, const std::string& data) {
-  CURL* curl_post = Utils::curlDupHandleWrapper(curl, pkcs11_key);
+  CURL* curl_post = dupHandle();
   curl_slist* req_headers = curl_slist_dup(headers);
   req_headers = curl_slist_append(req_headers, (std::string("Content-Type: ") + content_type).c_str());
   curlEasySetoptWrapper(curl_post, CURLOPT_HTTPHEADER, req_headers);
@@ -181,7 +188,7 @@ HttpResponse HttpClient::post(const std::string& url, const Json::Value& data) {
 }
 
 HttpResponse HttpClient::put(const std::string& url, const std::string& content_type, const std::string& data) {
-  CURL* curl_put = Utils::curlDupHandleWrapper(curl, pkcs11_key);
+  CURL* curl_put = dupHandle();
   curl_slist* req_headers = curl_slist_dup(headers);
   req_headers = curl_slist_append(req_headers, (std::string("Content-Type: ") + content_type).c_str());
   curlEasySetoptWrapper(curl_put, CURLOPT_HTTPHEADER, req_headers);
@@ -239,7 +246,7 @@ HttpResponse HttpClient::download(const std::string& url, curl_write_callback wr
 std::future<HttpResponse> HttpClient::downloadAsync(const std::string& url, curl_write_callback write_cb,
                                                     curl_xferinfo_callback progress_cb, void* userp, curl_off_t from,
                                                     CurlHandler* easyp) {
-  CURL* curl_download = Utils::curlDupHandleWrapper(curl, pkcs11_key);
+  CURL* curl_download = dupHandle();
 
   CurlHandler curlp = CurlHandler(curl_download, curl_easy_cleanup);
 
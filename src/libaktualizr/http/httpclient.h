@@ -3,6 +3,7 @@
 
 #include <future>
 #include <memory>
+#include <mutex>
 
 #include <curl/curl.h>
 #include "gtest/gtest_prod.h"
@@ -50,8 +51,13 @@ class HttpClient : public HttpInterface {
   FRIEND_TEST(GetTest, download_speed_limit);
 
   static CurlGlobalInitWrapper manageCurlGlobalInit_;
+  // Requests run on a copy of `curl`, possibly from several threads at once
+  // (see Uptane::getTrustedDelegations). A curl handle must not be used from
+  // two threads at the same time, copying it included.
+  mutable std::mutex curl_mutex_;
   CURL *curl;
   curl_slist *headers;
+  CURL *dupHandle() const;
   HttpResponse perform(CURL *curl_handler, int retry_times, int64_t size_limit);
   static curl_slist *curl_slist_dup(curl_slist *sl);
 
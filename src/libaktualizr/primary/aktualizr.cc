@@ -36,6 +36,18 @@ void Aktualizr::Initialize() {
 }
 
 bool Aktualizr::UptaneCycle() {
+  bool res;
+  try {
+    res = RunUptaneCycleSteps();
+  } catch (...) {
+    uptane_client_->reportCycleMetrics();
+    throw;
+  }
+  uptane_client_->reportCycleMetrics();
+  return res;
+}
+
+bool Aktualizr::RunUptaneCycleSteps() {
   result::UpdateCheck update_result = CheckUpdates().get();
   if (update_result.updates.empty()) {
     if (update_result.status == result::UpdateStatus::kError) {
@@ -115,6 +127,8 @@ std::vector<SecondaryInfo> Aktualizr::GetSecondaries() const {
   return info;
 }
 
+result::MetadataMetrics Aktualizr::GetMetadataMetrics() const { return uptane_client_->metadataMetrics(); }
+
 std::future<result::CampaignCheck> Aktualizr::CampaignCheck() {
   std::function<result::CampaignCheck()> task([this] { return uptane_client_->campaignCheck(); });
   return api_queue_->enqueue(task);
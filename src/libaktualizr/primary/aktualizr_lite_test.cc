@@ -157,12 +157,12 @@ class AkliteMock {
 
     std::shared_ptr<const Uptane::Targets> targets = image_repo_.getTargets();
 
-    if (0 == targets->targets.size()) {
+    if (0 == targets->targets().size()) {
       return data::InstallationResult(data::ResultCode::Numeric::kAlreadyProcessed,
                                       "Target has been already processed");
     }
 
-    Uptane::Target target{targets->targets[0]};
+    Uptane::Target target{targets->targets()[0]};
 
     if (TargetStatus::kNotFound != package_manager_->verifyTarget(target)) {
       return data::InstallationResult(data::ResultCode::Numeric::kAlreadyProcessed,
@@ -65,7 +65,7 @@ TEST(Aktualizr, FullNoUpdates) {
   ev_state.future = ev_state.promise.get_future();
 
   auto f_cb = [&ev_state](const std::shared_ptr<event::BaseEvent>& event) {
-    if (event->isTypeOf<event::DownloadProgressReport>()) {
+    if (event->isTypeOf<event::DownloadProgressReport>() || event->isTypeOf<event::MetadataMetricsReport>()) {
       return;
     }
     LOG_INFO << "Got " << event->variant;
@@ -253,7 +253,7 @@ TEST(Aktualizr, FullWithUpdates) {
   ev_state.future = ev_state.promise.get_future();
 
   auto f_cb = [&ev_state](const std::shared_ptr<event::BaseEvent>& event) {
-    if (event->isTypeOf<event::DownloadProgressReport>()) {
+    if (event->isTypeOf<event::DownloadProgressReport>() || event->isTypeOf<event::MetadataMetricsReport>()) {
       return;
     }
     LOG_INFO << "Got " << event->variant;
@@ -425,7 +425,7 @@ TEST(Aktualizr, SplitUpdates) {
   ev_state.future = ev_state.promise.get_future();
 
   auto f_cb = [&ev_state](const std::shared_ptr<event::BaseEvent>& event) {
-    if (event->isTypeOf<event::DownloadProgressReport>()) {
+    if (event->isTypeOf<event::DownloadProgressReport>() || event->isTypeOf<event::MetadataMetricsReport>()) {
       return;
     }
     LOG_INFO << "Got " << event->variant;
@@ -757,6 +757,9 @@ class EventHandler {
 
   void operator()(const std::shared_ptr<event::BaseEvent>& event) {
     ASSERT_NE(event, nullptr);
+    if (event->isTypeOf<event::MetadataMetricsReport>()) {
+      return;
+    }
     received_events_.push_back(event->variant);
   }
 
@@ -1280,7 +1283,7 @@ TEST(Aktualizr, CheckNoUpdates) {
   ev_state.future = ev_state.promise.get_future();
 
   auto f_cb = [&ev_state](const std::shared_ptr<event::BaseEvent>& event) {
-    if (event->isTypeOf<event::DownloadProgressReport>()) {
+    if (event->isTypeOf<event::DownloadProgressReport>() || event->isTypeOf<event::MetadataMetricsReport>()) {
       return;
     }
     LOG_INFO << "Got " << event->variant;
@@ -1356,7 +1359,7 @@ TEST(Aktualizr, DownloadWithUpdates) {
   ev_state.future = ev_state.promise.get_future();
 
   auto f_cb = [&ev_state](const std::shared_ptr<event::BaseEvent>& event) {
-    if (event->isTypeOf<event::DownloadProgressReport>()) {
+    if (event->isTypeOf<event::DownloadProgressReport>() || event->isTypeOf<event::MetadataMetricsReport>()) {
       return;
     }
     LOG_INFO << "Got " << event->variant;
@@ -1716,7 +1719,7 @@ TEST(Aktualizr, InstallWithUpdates) {
   auto f_cb = [&ev_state](const std::shared_ptr<event::BaseEvent>& event) {
     // Note that we do not expect a PutManifestComplete since we don't call
     // UptaneCycle() and that's the only function that generates that.
-    if (event->isTypeOf<event::DownloadProgressReport>()) {
+    if (event->isTypeOf<event::DownloadProgressReport>() || event->isTypeOf<event::MetadataMetricsReport>()) {
       return;
     }
     LOG_INFO << "Got " << event->variant;
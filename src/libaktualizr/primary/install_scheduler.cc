@@ -0,0 +1,69 @@
+#include "install_scheduler.h"
+
+#include <algorithm>
+#include <thread>
+
+void InstallScheduler::run() {
+  size_t workers;
+  {
+    std::lock_guard<std::mutex> lock(m_);
+    workers = jobs_.size();
+  }
+  if (max_parallel_ != 0) {
+    workers = std::min(workers, max_parallel_);
+  }
+
+  std::vector<std::thread> threads;
+  threads.reserve(workers);
+  for (size_t i = 0; i < workers; ++i) {
+    threads.emplace_back([this] { worker(); });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+size_t InstallScheduler::pending() const {
+  std::lock_guard<std::mutex> lock(m_);
+  return jobs_.size();
+}
+
+std::vector<InstallScheduler::Job>::iterator InstallScheduler::nextRunnable() {
+  auto best = jobs_.end();
+  for (auto it = jobs_.begin(); it != jobs_.end(); ++it) {
+    if (max_parallel_per_group_ != 0 && running_per_group_[it->group] >= max_parallel_per_group_) {
+      continue;
+    }
+    if (best == jobs_.end() || it->priority > best->priority ||
+        (it->priority == best->priority && it->seq < best->seq)) {
+      best = it;
+    }
+  }
+  return best;
+}
+
+void InstallScheduler::worker() {
+  std::unique_lock<std::mutex> lock(m_);
+  while (!jobs_.empty()) {
+    auto it = nextRunnable();
+    if (it == jobs_.end()) {
+      // every remaining job belongs to a saturated group
+      cv_.wait(lock);
+      continue;
+    }
+
+    Job job = std::move(*it);
+    jobs_.erase(it);
+    ++running_per_group_[job.group];
+
+    lock.unlock();
+    // exceptions are captured by the packaged_task and rethrown from the future
+    job.task();
+    lock.lock();
+
+    --running_per_group_[job.group];
+    cv_.notify_all();
+  }
+  // wake up the workers still waiting for a group slot so that they can exit
+  cv_.notify_all();
+}
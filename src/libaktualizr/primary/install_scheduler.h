@@ -0,0 +1,72 @@
+#ifndef INSTALL_SCHEDULER_H_
+#define INSTALL_SCHEDULER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Runs a batch of Secondary installation jobs on a bounded number of worker
+ * threads.
+ *
+ * Jobs are queued with enqueue() and executed once run() is called. At most
+ * `max_parallel` jobs run at the same time (0 means one thread per job) and at
+ * most `max_parallel_per_group` jobs of the same group (typically the
+ * Secondary's interface type) run at the same time (0 means no limit). Among
+ * the jobs that are allowed to start, the one with the highest priority is
+ * picked first; jobs with the same priority are started in FIFO order.
+ */
+class InstallScheduler {
+ public:
+  explicit InstallScheduler(size_t max_parallel = 0, size_t max_parallel_per_group = 0)
+      : max_parallel_(max_parallel), max_parallel_per_group_(max_parallel_per_group) {}
+
+  template <class R>
+  std::future<R> enqueue(const std::function<R()>& f, std::string group = "", uint64_t priority = 0) {
+    std::packaged_task<R()> task(f);
+    auto r = task.get_future();
+    {
+      std::lock_guard<std::mutex> lock(m_);
+      jobs_.emplace_back(std::move(group), priority, next_seq_++, std::packaged_task<void()>(std::move(task)));
+    }
+    return r;
+  }
+
+  /**
+   * Execute all queued jobs and block until every one of them has finished.
+   * Results and exceptions are available through the futures returned by
+   * enqueue().
+   */
+  void run();
+
+  size_t pending() const;
+
+ private:
+  struct Job {
+    Job(std::string group_in, uint64_t priority_in, uint64_t seq_in, std::packaged_task<void()> task_in)
+        : group(std::move(group_in)), priority(priority_in), seq(seq_in), task(std::move(task_in)) {}
+    std::string group;
+    uint64_t priority;
+    uint64_t seq;
+    std::packaged_task<void()> task;
+  };
+
+  void worker();
+  std::vector<Job>::iterator nextRunnable();
+
+  const size_t max_parallel_;
+  const size_t max_parallel_per_group_;
+  std::vector<Job> jobs_;
+  std::map<std::string, size_t> running_per_group_;
+  uint64_t next_seq_{0};
+  mutable std::mutex m_;
+  std::condition_variable cv_;
+};
+
+#endif  // INSTALL_SCHEDULER_H_
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "install_scheduler.h"
+
+namespace {
+
+/*
+ * Records how many jobs run at the same time. Started jobs are held until
+ * `peak` jobs have run at the same time once, or until every one of the `total`
+ * jobs has started, so that the expected concurrency is reached whatever the
+ * thread timing is.
+ */
+class ConcurrencyProbe {
+ public:
+  ConcurrencyProbe(int peak_in, int total_in) : peak(peak_in), total(total_in) {}
+
+  std::function<int()> job(int id, const std::string &group = "") {
+    return [this, id, group]() {
+      enter(group);
+      leave(group, id);
+      return id;
+    };
+  }
+
+  void enter(const std::string &group) {
+    std::unique_lock<std::mutex> lock(m);
+    ++started;
+    ++running;
+    max_running = std::max(max_running, running);
+    reached = reached || running >= peak;
+    ++running_per_group[group];
+    max_running_per_group[group] = std::max(max_running_per_group[group], running_per_group[group]);
+    cv.notify_all();
+    // bounded, so that a scheduler that never reaches the peak fails the test instead of hanging it
+    cv.wait_for(lock, std::chrono::seconds(10), [this]() { return reached || started >= total; });
+  }
+
+  void leave(const std::string &group, int id) {
+    std::lock_guard<std::mutex> lock(m);
+    --running;
+    --running_per_group[group];
+    order.push_back(id);
+  }
+
+  const int peak;
+  const int total;
+  std::mutex m;
+  std::condition_variable cv;
+  bool reached{false};
+  int started{0};
+  int running{0};
+  int max_running{0};
+  std::map<std::string, int> running_per_group;
+  std::map<std::string, int> max_running_per_group;
+  std::vector<int> order;
+};
+
+}  // namespace
+
+/*
+ * Without limits, every job gets its own thread.
+ */
+TEST(InstallScheduler, Unbounded) {
+  ConcurrencyProbe probe(5, 5);
+  InstallScheduler scheduler;
+  std::vector<std::future<int>> futures;
+  for (int i = 0; i < 5; ++i) {
+    futures.push_back(scheduler.enqueue(probe.job(i)));
+  }
+  EXPECT_EQ(scheduler.pending(), 5u);
+  scheduler.run();
+  EXPECT_EQ(scheduler.pending(), 0u);
+  EXPECT_EQ(probe.max_running, 5);
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(futures[static_cast<size_t>(i)].get(), i);
+  }
+}
+
+/*
+ * No more than max_parallel jobs run at the same time.
+ */
+TEST(InstallScheduler, MaxParallel) {
+  ConcurrencyProbe probe(2, 6);
+  InstallScheduler scheduler(2);
+  std::vector<std::future<int>> futures;
+  for (int i = 0; i < 6; ++i) {
+    futures.push_back(scheduler.enqueue(probe.job(i)));
+  }
+  scheduler.run();
+  EXPECT_EQ(probe.max_running, 2);
+  EXPECT_EQ(probe.order.size(), 6u);
+}
+
+/*
+ * No more than max_parallel_per_group jobs of the same group run at the same
+ * time, while other groups can still make progress.
+ */
+TEST(InstallScheduler, MaxParallelPerGroup) {
+  ConcurrencyProbe probe(2, 8);
+  InstallScheduler scheduler(0, 1);
+  std::vector<std::future<int>> futures;
+  for (int i = 0; i < 4; ++i) {
+    futures.push_back(scheduler.enqueue(probe.job(i, "IP"), "IP"));
+    futures.push_back(scheduler.enqueue(probe.job(10 + i, "virtual"), "virtual"));
+  }
+  scheduler.run();
+  EXPECT_EQ(probe.max_running_per_group["IP"], 1);
+  EXPECT_EQ(probe.max_running_per_group["virtual"], 1);
+  EXPECT_EQ(probe.max_running, 2);
+  EXPECT_EQ(probe.order.size(), 8u);
+}
+
+/*
+ * Jobs with a higher priority are started first, ties are started in FIFO
+ * order.
+ */
+TEST(InstallScheduler, Priority) {
+  ConcurrencyProbe probe(1, 4);
+  InstallScheduler scheduler(1);
+  scheduler.enqueue(probe.job(1), "", 10);
+  scheduler.enqueue(probe.job(2), "", 300);
+  scheduler.enqueue(probe.job(3), "", 10);
+  scheduler.enqueue(probe.job(4), "", 200);
+  scheduler.run();
+  EXPECT_EQ(probe.order, (std::vector<int>{2, 4, 1, 3}));
+}
+
+/*
+ * An exception thrown by a job is delivered through its future and does not
+ * prevent the remaining jobs from running.
+ */
+TEST(InstallScheduler, Exception) {
+  InstallScheduler scheduler(1);
+  std::function<int()> failing = []() -> int { throw std::runtime_error("failed"); };
+  std::function<int()> working = []() { return 42; };
+  auto f1 = scheduler.enqueue(failing);
+  auto f2 = scheduler.enqueue(working);
+  scheduler.run();
+  EXPECT_THROW(f1.get(), std::runtime_error);
+  EXPECT_EQ(f2.get(), 42);
+}
+
+#ifndef __NO_MAIN__
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+#endif
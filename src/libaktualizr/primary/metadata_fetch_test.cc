@@ -143,6 +143,17 @@ TEST(Aktualizr, MetadataFetch) {
   EXPECT_EQ(http->image_timestamp_count, 3);
   EXPECT_EQ(http->image_snapshot_count, 2);
   EXPECT_EQ(http->image_targets_count, 1);
+
+  // Nothing changed: the Image repo Timestamp is identical to the previous one,
+  // so the Snapshot and Targets metadata verified in the previous check are
+  // reused.
+  update_result = aktualizr.CheckUpdates().get();
+  EXPECT_EQ(update_result.status, result::UpdateStatus::kUpdatesAvailable);
+  EXPECT_EQ(update_result.updates.size(), 1u);
+  EXPECT_EQ(http->director_targets_count, 5);
+  EXPECT_EQ(http->image_timestamp_count, 4);
+  EXPECT_EQ(http->image_snapshot_count, 2);
+  EXPECT_EQ(http->image_targets_count, 1);
 }
 
 #ifndef __NO_MAIN__
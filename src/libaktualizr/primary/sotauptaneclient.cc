@@ -1,7 +1,7 @@
 #include "sotauptaneclient.h"
 
-#include <fnmatch.h>
 #include <unistd.h>
+#include <chrono>
 #include <memory>
 #include <utility>
 
@@ -495,7 +495,7 @@ void SotaUptaneClient::computeDeviceInstallationResult(data::InstallationResult
 }
 
 void SotaUptaneClient::getNewTargets(std::vector<Uptane::Target> *new_targets, unsigned int *ecus_count) {
-  const std::vector<Uptane::Target> targets = director_repo.getTargets().targets;
+  const std::vector<Uptane::Target> targets = director_repo.getTargets().targets();
   const Uptane::EcuSerial primary_ecu_serial = primaryEcuSerial();
   if (ecus_count != nullptr) {
     *ecus_count = 0;
@@ -567,38 +567,38 @@ std::unique_ptr<Uptane::Target> SotaUptaneClient::findTargetHelper(const Uptane:
                                                                    const Uptane::Target &queried_target,
                                                                    const int level, const bool terminating,
                                                                    const bool offline) {
-  TargetCompare target_comp(queried_target);
-  const auto it = std::find_if(cur_targets.targets.cbegin(), cur_targets.targets.cend(), target_comp);
-  if (it != cur_targets.targets.cend()) {
-    return std_::make_unique<Uptane::Target>(*it);
+  const Uptane::Target *found = cur_targets.findTarget(queried_target);
+  if (found != nullptr) {
+    return std_::make_unique<Uptane::Target>(*found);
   }
 
   if (terminating || level >= Uptane::kDelegationsMaxDepth) {
     return std::unique_ptr<Uptane::Target>(nullptr);
   }
 
+  std::vector<Uptane::Role> matching_roles;
   for (const auto &delegate_name : cur_targets.delegated_role_names_) {
     Uptane::Role delegate_role = Uptane::Role::Delegation(delegate_name);
-    auto patterns = cur_targets.paths_for_role_.find(delegate_role);
-    if (patterns == cur_targets.paths_for_role_.end()) {
-      continue;
-    }
-
-    bool match = false;
-    for (const auto &pattern : patterns->second) {
-      if (fnmatch(pattern.c_str(), queried_target.filename().c_str(), 0) == 0) {
-        match = true;
-        break;
-      }
-    }
-    if (!match) {
-      continue;
+    if (Uptane::delegationMatches(cur_targets, delegate_role, queried_target.filename())) {
+      matching_roles.push_back(delegate_role);
     }
+  }
 
-    // Target name matches one of the patterns
+  // Target name matches the patterns of these delegations. With parallel
+  // verification enabled, verify the sibling delegations all at once; errors
+  // are still raised in order, once the search reaches the failed delegation.
+  std::vector<std::future<Uptane::Targets>> verified;
+  const size_t max_parallel = image_repo.maxParallelVerifications();
+  if (matching_roles.size() > 1 && max_parallel > 1) {
+    verified = Uptane::getTrustedDelegations(matching_roles, cur_targets, image_repo, *storage, *uptane_fetcher,
+                                             offline, config.uptane.delegations_fetch_max_parallel, max_parallel);
+  }
 
-    auto delegation =
-        Uptane::getTrustedDelegation(delegate_role, cur_targets, image_repo, *storage, *uptane_fetcher, offline);
+  for (size_t i = 0; i < matching_roles.size(); ++i) {
+    const Uptane::Role &delegate_role = matching_roles[i];
+    auto delegation = verified.empty() ? Uptane::getTrustedDelegation(delegate_role, cur_targets, image_repo,
+                                                                      *storage, *uptane_fetcher, offline)
+                                       : verified[i].get();
     if (delegation.isExpired(TimeStamp::Now())) {
       continue;
     }
@@ -624,6 +624,12 @@ std::unique_ptr<Uptane::Target> SotaUptaneClient::findTargetInDelegationTree(con
     return std::unique_ptr<Uptane::Target>(nullptr);
   }
 
+  if (!offline && config.uptane.delegations_fetch_max_parallel > 1) {
+    Uptane::prefetchDelegations(target, image_repo, *storage, *uptane_fetcher,
+                                config.uptane.delegations_fetch_max_parallel,
+                                image_repo.maxParallelVerifications());
+  }
+
   return findTargetHelper(*toplevel_targets, target, 0, false, offline);
 }
 
@@ -1315,23 +1321,36 @@ void SotaUptaneClient::sendMetadataToEcus(const std::vector<Uptane::Target> &tar
   }
 }
 
-std::future<data::InstallationResult> SotaUptaneClient::sendFirmwareAsync(SecondaryInterface &secondary,
+std::future<data::InstallationResult> SotaUptaneClient::sendFirmwareAsync(InstallScheduler &scheduler,
+                                                                          SecondaryInterface &secondary,
                                                                           const Uptane::Target &target) {
-  auto f = [this, &secondary, target]() {
+  const auto queued_at = std::chrono::steady_clock::now();
+  std::function<data::InstallationResult()> f = [this, &secondary, target, queued_at]() {
     const std::string &correlation_id = director_repo.getCorrelationId();
+    const auto started_at = std::chrono::steady_clock::now();
 
     sendEvent<event::InstallStarted>(secondary.getSerial());
     report_queue->enqueue(std_::make_unique<EcuInstallationStartedReport>(secondary.getSerial(), correlation_id));
 
     data::InstallationResult result;
+    auto transferred_at = started_at;
     try {
       result = secondary.sendFirmware(target);
+      transferred_at = std::chrono::steady_clock::now();
       if (result.isSuccess()) {
         result = secondary.install(target);
       }
     } catch (const std::exception &ex) {
       result = data::InstallationResult(data::ResultCode::Numeric::kInternalError, ex.what());
     }
+    const auto finished_at = std::chrono::steady_clock::now();
+
+    using std::chrono::duration_cast;
+    using std::chrono::milliseconds;
+    LOG_INFO << "Installation on Secondary " << secondary.getSerial() << " finished: queue wait "
+             << duration_cast<milliseconds>(started_at - queued_at).count() << " ms, transfer "
+             << duration_cast<milliseconds>(transferred_at - started_at).count() << " ms, install "
+             << duration_cast<milliseconds>(finished_at - transferred_at).count() << " ms";
 
     if (result.result_code == data::ResultCode::Numeric::kNeedCompletion) {
       report_queue->enqueue(std_::make_unique<EcuInstallationAppliedReport>(secondary.getSerial(), correlation_id));
@@ -1344,12 +1363,15 @@ std::future<data::InstallationResult> SotaUptaneClient::sendFirmwareAsync(Second
     return result;
   };
 
-  return std::async(std::launch::async, f);
+  const uint64_t priority = config.uptane.secondary_install_largest_first ? target.length() : 0;
+  return scheduler.enqueue(f, secondary.Type(), priority);
 }
 
 std::vector<result::Install::EcuReport> SotaUptaneClient::sendImagesToEcus(const std::vector<Uptane::Target> &targets) {
   std::vector<result::Install::EcuReport> reports;
   std::vector<std::pair<result::Install::EcuReport, std::future<data::InstallationResult>>> firmwareFutures;
+  InstallScheduler scheduler(config.uptane.secondary_install_max_parallel,
+                             config.uptane.secondary_install_max_parallel_per_type);
 
   const Uptane::EcuSerial &primary_ecu_serial = primaryEcuSerial();
   // target images should already have been downloaded to metadata_path/targets/
@@ -1369,10 +1391,12 @@ std::vector<result::Install::EcuReport> SotaUptaneClient::sendImagesToEcus(const
 
       SecondaryInterface &sec = *f->second;
       firmwareFutures.emplace_back(result::Install::EcuReport(*targets_it, ecu_serial, data::InstallationResult()),
-                                   sendFirmwareAsync(sec, *targets_it));
+                                   sendFirmwareAsync(scheduler, sec, *targets_it));
     }
   }
 
+  scheduler.run();
+
   for (auto &f : firmwareFutures) {
     data::InstallationResult fut_result = f.second.get();
 
@@ -21,6 +21,7 @@
 
 #include "bootloader/bootloader.h"
 #include "http/httpclient.h"
+#include "primary/install_scheduler.h"
 #include "primary/secondary_provider_builder.h"
 #include "reportqueue.h"
 #include "uptane/directorrepository.h"
@@ -43,11 +44,17 @@ class SotaUptaneClient {
         http(std::move(http_in)),
         package_manager_(PackageManagerFactory::makePackageManager(config.pacman, config.bootloader, storage, http)),
         uptane_fetcher(new Uptane::Fetcher(config, http)),
+        metadata_metrics_(std::make_shared<Uptane::MetadataMetrics>()),
         events_channel(std::move(events_channel_in)),
         primary_ecu_serial_(primary_serial),
         primary_ecu_hw_id_(hwid) {
     report_queue = std_::make_unique<ReportQueue>(config, http, storage);
     secondary_provider_ = SecondaryProviderBuilder::Build(config, storage, package_manager_);
+    director_repo.setMaxParallelVerifications(config.uptane.verification_max_parallel);
+    image_repo.setMaxParallelVerifications(config.uptane.verification_max_parallel);
+    uptane_fetcher->setMetrics(metadata_metrics_);
+    director_repo.setMetrics(metadata_metrics_);
+    image_repo.setMetrics(metadata_metrics_);
   }
 
   SotaUptaneClient(Config &config_in, const std::shared_ptr<INvStorage> &storage_in,
@@ -96,6 +103,9 @@ class SotaUptaneClient {
   data::InstallationResult PackageInstall(const Uptane::Target &target);
   TargetStatus VerifyTarget(const Uptane::Target &target) const { return package_manager_->verifyTarget(target); }
   std::string treehubCredentials() const;
+  result::MetadataMetrics metadataMetrics() const { return metadata_metrics_->totals(); }
+  // Report the metadata metrics of the Uptane cycle that has just ended.
+  void reportCycleMetrics() { sendEvent<event::MetadataMetricsReport>(metadata_metrics_->takeCycle()); }
 
  private:
   FRIEND_TEST(Aktualizr, FullNoUpdates);
@@ -146,7 +156,8 @@ class SotaUptaneClient {
   data::InstallationResult rotateSecondaryRoot(Uptane::RepositoryType repo, SecondaryInterface &secondary);
   void sendMetadataToEcus(const std::vector<Uptane::Target> &targets, data::InstallationResult *result,
                           std::string *raw_installation_report);
-  std::future<data::InstallationResult> sendFirmwareAsync(SecondaryInterface &secondary, const Uptane::Target &target);
+  std::future<data::InstallationResult> sendFirmwareAsync(InstallScheduler &scheduler, SecondaryInterface &secondary,
+                                                          const Uptane::Target &target);
   std::vector<result::Install::EcuReport> sendImagesToEcus(const std::vector<Uptane::Target> &targets);
 
   bool putManifestSimple(const Json::Value &custom = Json::nullValue);
@@ -180,6 +191,7 @@ class SotaUptaneClient {
   std::shared_ptr<HttpInterface> http;
   std::shared_ptr<PackageManagerInterface> package_manager_;
   std::shared_ptr<Uptane::Fetcher> uptane_fetcher;
+  std::shared_ptr<Uptane::MetadataMetrics> metadata_metrics_;
   std::unique_ptr<ReportQueue> report_queue;
   std::shared_ptr<SecondaryProvider> secondary_provider_;
   std::shared_ptr<event::Channel> events_channel;
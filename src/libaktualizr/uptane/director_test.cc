@@ -23,8 +23,8 @@ TEST(Director, EmptyTargets) {
                                     Utils::readFile(meta_dir.Path() / "repo/director/root.json")));
 
   EXPECT_NO_THROW(director.verifyTargets(Utils::readFile(meta_dir.Path() / "repo/director/targets.json")));
-  EXPECT_TRUE(director.targets.targets.empty());
-  EXPECT_TRUE(director.latest_targets.targets.empty());
+  EXPECT_TRUE(director.targets.targets().empty());
+  EXPECT_TRUE(director.latest_targets.targets().empty());
 
   uptane_gen.run({"image", "--path", meta_dir.PathString(), "--filename", "tests/test_data/firmware.txt",
                   "--targetname", "firmware.txt", "--hwid", "primary_hw"});
@@ -33,17 +33,17 @@ TEST(Director, EmptyTargets) {
   uptane_gen.run({"signtargets", "--path", meta_dir.PathString()});
 
   EXPECT_NO_THROW(director.verifyTargets(Utils::readFile(meta_dir.Path() / "repo/director/targets.json")));
-  EXPECT_EQ(director.targets.targets.size(), 1);
-  EXPECT_EQ(director.targets.targets[0].filename(), "firmware.txt");
-  EXPECT_EQ(director.targets.targets.size(), director.latest_targets.targets.size());
+  EXPECT_EQ(director.targets.targets().size(), 1);
+  EXPECT_EQ(director.targets.targets()[0].filename(), "firmware.txt");
+  EXPECT_EQ(director.targets.targets().size(), director.latest_targets.targets().size());
 
   uptane_gen.run({"emptytargets", "--path", meta_dir.PathString()});
   uptane_gen.run({"signtargets", "--path", meta_dir.PathString(), "--correlationid", "abc123"});
 
   EXPECT_NO_THROW(director.verifyTargets(Utils::readFile(meta_dir.Path() / "repo/director/targets.json")));
-  EXPECT_EQ(director.targets.targets.size(), 1);
-  EXPECT_EQ(director.targets.targets[0].filename(), "firmware.txt");
-  EXPECT_TRUE(director.latest_targets.targets.empty());
+  EXPECT_EQ(director.targets.targets().size(), 1);
+  EXPECT_EQ(director.targets.targets()[0].filename(), "firmware.txt");
+  EXPECT_TRUE(director.latest_targets.targets().empty());
 }
 
 }  // namespace Uptane
@@ -23,7 +23,7 @@ void DirectorRepository::targetsSanityCheck() {
   //  5.4.4.6.7. If checking Targets metadata from the Director repository,
   //  check that no ECU identifier is represented more than once.
   std::set<Uptane::EcuSerial> ecu_ids;
-  for (const auto& target : targets.targets) {
+  for (const auto& target : targets.targets()) {
     for (const auto& ecu : target.ecus()) {
       if (ecu_ids.find(ecu.first) == ecu_ids.end()) {
         ecu_ids.insert(ecu.first);
@@ -38,17 +38,22 @@ void DirectorRepository::targetsSanityCheck() {
 bool DirectorRepository::usePreviousTargets() const {
   // Don't store the new targets if they are empty and we've previously received
   // a non-empty list.
-  return !targets.targets.empty() && latest_targets.targets.empty();
+  return !targets.targets().empty() && latest_targets.targets().empty();
 }
 
 void DirectorRepository::verifyTargets(const std::string& targets_raw) {
+  MetadataMetrics::Measurement measurement(metrics_, type, Role::Targets(), MetadataMetrics::Step::kVerify);
   try {
     // Verify the signature:
-    latest_targets = Targets(RepositoryType::Director(), Role::Targets(), Utils::parseJSON(targets_raw),
-                             std::make_shared<MetaWithKeys>(root));
+    std::string digest;
+    const Json::Value targets_json = Utils::parseJSON(targets_raw);
+    latest_targets = Targets(RepositoryType::Director(), Role::Targets(), SignedMeta(targets_json),
+                             signerFor(Role::Targets(), targets_raw, &digest));
+    markVerified(Role::Targets(), digest, latest_targets.version());
     if (!usePreviousTargets()) {
       targets = latest_targets;
     }
+    measurement.success(targets_raw.size());
   } catch (const Uptane::Exception& e) {
     LOG_ERROR << "Signature verification for Director Targets metadata failed";
     throw;
@@ -128,7 +133,9 @@ void DirectorRepository::updateMeta(INvStorage& storage, const IMetadataFetcher&
     if (local_version > remote_version) {
       throw Uptane::SecurityException(RepositoryType::DIRECTOR, "Rollback attempt");
     } else if (local_version < remote_version && !usePreviousTargets()) {
+      MetadataMetrics::Measurement measurement(metrics_, type, Role::Targets(), MetadataMetrics::Step::kStore);
       storage.storeNonRoot(director_targets, RepositoryType::Director(), Role::Targets());
+      measurement.success(director_targets.size());
     }
 
     checkTargetsExpired();
@@ -153,15 +160,8 @@ bool DirectorRepository::matchTargetsWithImageTargets(const Uptane::Targets& ima
   // Currently this is only used by aktualizr-secondary, but according to the
   // Standard, "A Secondary ECU MAY elect to perform this check only on the
   // metadata for the image it will install".
-  const auto& image_target_array = image_targets.targets;
-  const auto& director_target_array = targets.targets;
-
-  for (const auto& director_target : director_target_array) {
-    auto found_it = std::find_if(
-        image_target_array.begin(), image_target_array.end(),
-        [&director_target](const Target& image_target) { return director_target.MatchTarget(image_target); });
-
-    if (found_it == image_target_array.end()) {
+  for (const auto& director_target : targets.targets()) {
+    if (image_targets.findTarget(director_target) == nullptr) {
       return false;
     }
   }
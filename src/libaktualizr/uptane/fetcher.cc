@@ -11,11 +11,13 @@ void Fetcher::fetchRole(std::string* result, int64_t maxsize, RepositoryType rep
     url += "/delegations";
   }
   url += "/" + version.RoleFileName(role);
+  MetadataMetrics::Measurement measurement(metrics_, repo, role, MetadataMetrics::Step::kFetch);
   HttpResponse response = http->get(url, maxsize);
   if (!response.isOk()) {
     throw Uptane::MetadataFetchFailure(repo.toString(), role.ToString());
   }
   *result = response.body;
+  measurement.success(result->size());
 }
 
 }  // namespace Uptane
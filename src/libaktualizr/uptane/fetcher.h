@@ -4,6 +4,7 @@
 #include "http/httpinterface.h"
 #include "libaktualizr/config.h"
 #include "storage/invstorage.h"
+#include "uptane/metadatametrics.h"
 
 namespace Uptane {
 
@@ -46,9 +47,12 @@ class Fetcher : public IMetadataFetcher {
   }
 
   std::string getRepoServer() const { return repo_server; }
+  // Record the latency and size of every fetch.
+  void setMetrics(std::shared_ptr<MetadataMetrics> metrics) { metrics_ = std::move(metrics); }
 
  private:
   std::shared_ptr<HttpInterface> http;
+  std::shared_ptr<MetadataMetrics> metrics_;
   std::string repo_server;
   std::string director_server;
 };
@@ -7,13 +7,33 @@ void ImageRepository::resetMeta() {
   targets.reset();
   snapshot = Snapshot();
   timestamp = TimestampMeta();
+  verified_timestamp_digest_.clear();
+  verified_root_version_ = -1;
+  std::lock_guard<std::mutex> lock(delegations_mutex_);
+  delegations_.clear();
+}
+
+std::shared_ptr<const Uptane::Targets> ImageRepository::cachedDelegation(const std::string& key) const {
+  std::lock_guard<std::mutex> lock(delegations_mutex_);
+  auto it = delegations_.find(key);
+  return it != delegations_.end() ? it->second : nullptr;
+}
+
+void ImageRepository::cacheDelegation(const std::string& key, std::shared_ptr<const Uptane::Targets> delegation) const {
+  std::lock_guard<std::mutex> lock(delegations_mutex_);
+  delegations_[key] = std::move(delegation);
 }
 
 void ImageRepository::verifyTimestamp(const std::string& timestamp_raw) {
+  MetadataMetrics::Measurement measurement(metrics_, type, Role::Timestamp(), MetadataMetrics::Step::kVerify);
   try {
     // Verify the signature:
-    timestamp =
-        TimestampMeta(RepositoryType::Image(), Utils::parseJSON(timestamp_raw), std::make_shared<MetaWithKeys>(root));
+    std::string digest;
+    const Json::Value timestamp_json = Utils::parseJSON(timestamp_raw);
+    timestamp = TimestampMeta(RepositoryType::Image(), SignedMeta(timestamp_json),
+                              signerFor(Role::Timestamp(), timestamp_raw, &digest));
+    markVerified(Role::Timestamp(), digest, timestamp.version());
+    measurement.success(timestamp_raw.size());
   } catch (const Exception& e) {
     LOG_ERROR << "Signature verification for Timestamp metadata failed";
     throw;
@@ -43,46 +63,32 @@ void ImageRepository::fetchSnapshot(INvStorage& storage, const IMetadataFetcher&
   if (local_version > remote_version) {
     throw Uptane::SecurityException(RepositoryType::IMAGE, "Rollback attempt");
   } else if (local_version < remote_version) {
+    MetadataMetrics::Measurement measurement(metrics_, type, Role::Snapshot(), MetadataMetrics::Step::kStore);
     storage.storeNonRoot(image_snapshot, RepositoryType::Image(), Role::Snapshot());
+    measurement.success(image_snapshot.size());
   }
 }
 
 void ImageRepository::verifySnapshot(const std::string& snapshot_raw, bool prefetch) {
-  const std::string canonical = Utils::jsonToCanonicalStr(Utils::parseJSON(snapshot_raw));
-  bool hash_exists = false;
-  for (const auto& it : timestamp.snapshot_hashes()) {
-    switch (it.type()) {
-      case Hash::Type::kSha256:
-        if (Hash(Hash::Type::kSha256, boost::algorithm::hex(Crypto::sha256digest(canonical))) != it) {
-          if (!prefetch) {
-            LOG_ERROR << "Hash verification for Snapshot metadata failed";
-          }
-          throw Uptane::SecurityException(RepositoryType::IMAGE, "Snapshot metadata hash verification failed");
-        }
-        hash_exists = true;
-        break;
-      case Hash::Type::kSha512:
-        if (Hash(Hash::Type::kSha512, boost::algorithm::hex(Crypto::sha512digest(canonical))) != it) {
-          if (!prefetch) {
-            LOG_ERROR << "Hash verification for Snapshot metadata failed";
-          }
-          throw Uptane::SecurityException(RepositoryType::IMAGE, "Snapshot metadata hash verification failed");
-        }
-        hash_exists = true;
-        break;
-      default:
-        break;
-    }
-  }
-
+  MetadataMetrics::Measurement measurement(metrics_, type, Role::Snapshot(), MetadataMetrics::Step::kVerify);
+  const Json::Value snapshot_json = Utils::parseJSON(snapshot_raw);
+  const SignedMeta snapshot_meta(snapshot_json);
+  const std::vector<Hash> snapshot_hashes = timestamp.snapshot_hashes();
+  const bool hash_exists = std::any_of(snapshot_hashes.cbegin(), snapshot_hashes.cend(), [](const Hash& hash) {
+    return hash.type() == Hash::Type::kSha256 || hash.type() == Hash::Type::kSha512;
+  });
   if (!hash_exists) {
     LOG_ERROR << "No hash found for shapshot.json";
     throw Uptane::SecurityException(RepositoryType::IMAGE, "Snapshot metadata hash verification failed");
   }
+  checkHashes(snapshot_hashes, snapshot_meta, Role::Snapshot(), prefetch,
+              "Snapshot metadata hash verification failed");
 
   try {
     // Verify the signature:
-    snapshot = Snapshot(RepositoryType::Image(), Utils::parseJSON(snapshot_raw), std::make_shared<MetaWithKeys>(root));
+    std::string digest;
+    snapshot = Snapshot(RepositoryType::Image(), snapshot_meta, signerFor(Role::Snapshot(), snapshot_raw, &digest));
+    markVerified(Role::Snapshot(), digest, snapshot.version());
   } catch (const Exception& e) {
     LOG_ERROR << "Signature verification for Snapshot metadata failed";
     throw;
@@ -91,6 +97,7 @@ void ImageRepository::verifySnapshot(const std::string& snapshot_raw, bool prefe
   if (snapshot.version() != timestamp.snapshot_version()) {
     throw Uptane::VersionMismatch(RepositoryType::IMAGE, Uptane::Role::SNAPSHOT);
   }
+  measurement.success(snapshot_raw.size());
 }
 
 void ImageRepository::checkSnapshotExpired() {
@@ -117,30 +124,23 @@ void ImageRepository::fetchTargets(INvStorage& storage, const IMetadataFetcher&
   if (local_version > remote_version) {
     throw Uptane::SecurityException(RepositoryType::IMAGE, "Rollback attempt");
   } else if (local_version < remote_version) {
+    MetadataMetrics::Measurement measurement(metrics_, type, targets_role, MetadataMetrics::Step::kStore);
     storage.storeNonRoot(image_targets, RepositoryType::Image(), targets_role);
+    measurement.success(image_targets.size());
   }
 }
 
-void ImageRepository::verifyRoleHashes(const std::string& role_data, const Uptane::Role& role, bool prefetch) const {
-  const std::string canonical = Utils::jsonToCanonicalStr(Utils::parseJSON(role_data));
-  // Hashes are not required. If present, however, we may as well check them.
-  // This provides no security benefit, but may help with fault detection.
-  for (const auto& it : snapshot.role_hashes(role)) {
+void ImageRepository::checkHashes(const std::vector<Hash>& hashes, const SignedMeta& meta, const Uptane::Role& role,
+                                  const bool prefetch, const std::string& error) {
+  for (const auto& it : hashes) {
     switch (it.type()) {
       case Hash::Type::kSha256:
-        if (Hash(Hash::Type::kSha256, boost::algorithm::hex(Crypto::sha256digest(canonical))) != it) {
-          if (!prefetch) {
-            LOG_ERROR << "Hash verification for " << role.ToString() << " metadata failed";
-          }
-          throw Uptane::SecurityException(RepositoryType::IMAGE, "Hash metadata mismatch");
-        }
-        break;
       case Hash::Type::kSha512:
-        if (Hash(Hash::Type::kSha512, boost::algorithm::hex(Crypto::sha512digest(canonical))) != it) {
+        if (meta.canonicalHash(it.type()) != it) {
           if (!prefetch) {
             LOG_ERROR << "Hash verification for " << role.ToString() << " metadata failed";
           }
-          throw Uptane::SecurityException(RepositoryType::IMAGE, "Hash metadata mismatch");
+          throw Uptane::SecurityException(RepositoryType::IMAGE, error);
         }
         break;
       default:
@@ -149,40 +149,56 @@ void ImageRepository::verifyRoleHashes(const std::string& role_data, const Uptan
   }
 }
 
+void ImageRepository::verifyRoleHashes(const std::string& role_data, const Uptane::Role& role, bool prefetch) const {
+  const Json::Value role_json = Utils::parseJSON(role_data);
+  verifyRoleHashes(SignedMeta(role_json), role, prefetch);
+}
+
+void ImageRepository::verifyRoleHashes(const SignedMeta& role_meta, const Uptane::Role& role, bool prefetch) const {
+  // Hashes are not required. If present, however, we may as well check them.
+  // This provides no security benefit, but may help with fault detection.
+  const std::vector<Hash> hashes = snapshot.role_hashes(role);
+  if (!hashes.empty()) {
+    checkHashes(hashes, role_meta, role, prefetch, "Hash metadata mismatch");
+  }
+}
+
 int ImageRepository::getRoleVersion(const Uptane::Role& role) const { return snapshot.role_version(role); }
 
 int64_t ImageRepository::getRoleSize(const Uptane::Role& role) const { return snapshot.role_size(role); }
 
 void ImageRepository::verifyTargets(const std::string& targets_raw, bool prefetch) {
+  MetadataMetrics::Measurement measurement(metrics_, type, Role::Targets(), MetadataMetrics::Step::kVerify);
   try {
-    verifyRoleHashes(targets_raw, Uptane::Role::Targets(), prefetch);
-
-    auto targets_json = Utils::parseJSON(targets_raw);
+    Json::Value targets_json = Utils::parseJSON(targets_raw);
+    const auto targets_meta = SignedMeta::Consumable(targets_json);
+    verifyRoleHashes(targets_meta, Uptane::Role::Targets(), prefetch);
 
     // Verify the signature:
-    auto signer = std::make_shared<MetaWithKeys>(root);
-    targets = std::make_shared<Uptane::Targets>(
-        Targets(RepositoryType::Image(), Uptane::Role::Targets(), targets_json, signer));
+    std::string digest;
+    auto signer = signerFor(Uptane::Role::Targets(), targets_raw, &digest);
+    targets = std::make_shared<Uptane::Targets>(RepositoryType::Image(), Uptane::Role::Targets(), targets_meta, signer);
+    markVerified(Uptane::Role::Targets(), digest, targets->version());
 
     if (targets->version() != snapshot.role_version(Uptane::Role::Targets())) {
       throw Uptane::VersionMismatch(RepositoryType::IMAGE, Uptane::Role::TARGETS);
     }
+    measurement.success(targets_raw.size());
   } catch (const Exception& e) {
     LOG_ERROR << "Signature verification for Image repo Targets metadata failed";
     throw;
   }
 }
 
-std::shared_ptr<Uptane::Targets> ImageRepository::verifyDelegation(const std::string& delegation_raw,
+std::shared_ptr<Uptane::Targets> ImageRepository::verifyDelegation(const SignedMeta& delegation,
                                                                    const Uptane::Role& role,
-                                                                   const Targets& parent_target) {
+                                                                   const Targets& parent_target,
+                                                                   const size_t max_parallel_verifications) {
   try {
-    const Json::Value delegation_json = Utils::parseJSON(delegation_raw);
-    const std::string canonical = Utils::jsonToCanonicalStr(delegation_json);
-
     // Verify the signature:
     auto signer = std::make_shared<MetaWithKeys>(parent_target);
-    return std::make_shared<Uptane::Targets>(Targets(RepositoryType::Image(), role, delegation_json, signer));
+    signer->setMaxParallelVerifications(max_parallel_verifications);
+    return std::make_shared<Uptane::Targets>(RepositoryType::Image(), role, delegation, signer);
   } catch (const Exception& e) {
     LOG_ERROR << "Signature verification for Image repo delegated Targets metadata failed";
     throw;
@@ -198,15 +214,39 @@ void ImageRepository::checkTargetsExpired() {
 }
 
 void ImageRepository::updateMeta(INvStorage& storage, const IMetadataFetcher& fetcher) {
+  const std::string last_timestamp_digest = verified_timestamp_digest_;
+  const int last_root_version = verified_root_version_;
+  auto last_targets = targets;
+  auto last_snapshot = std::move(snapshot);
+  auto last_timestamp = std::move(timestamp);
   resetMeta();
 
   updateRoot(storage, fetcher, RepositoryType::Image());
 
+  std::string timestamp_digest;
+
   // Update Image repo Timestamp metadata
   {
     std::string image_timestamp;
 
     fetcher.fetchLatestRole(&image_timestamp, kMaxTimestampSize, RepositoryType::Image(), Role::Timestamp());
+    timestamp_digest = Crypto::sha256digest(image_timestamp);
+
+    // Nothing has changed since the last update cycle: the Snapshot and Targets
+    // metadata from then are still current and have been verified already.
+    if (last_targets && timestamp_digest == last_timestamp_digest && rootVersion() == last_root_version) {
+      timestamp = std::move(last_timestamp);
+      snapshot = std::move(last_snapshot);
+      targets = std::move(last_targets);
+      checkTimestampExpired();
+      checkSnapshotExpired();
+      checkTargetsExpired();
+      LOG_DEBUG << "Image repo Timestamp metadata is unchanged; skipping Snapshot and Targets verification.";
+      verified_timestamp_digest_ = timestamp_digest;
+      verified_root_version_ = rootVersion();
+      return;
+    }
+
     int remote_version = extractVersionUntrusted(image_timestamp);
 
     int local_version;
@@ -222,7 +262,9 @@ void ImageRepository::updateMeta(INvStorage& storage, const IMetadataFetcher& fe
     if (local_version > remote_version) {
       throw Uptane::SecurityException(RepositoryType::IMAGE, "Rollback attempt");
     } else if (local_version < remote_version) {
+      MetadataMetrics::Measurement measurement(metrics_, type, Role::Timestamp(), MetadataMetrics::Step::kStore);
       storage.storeNonRoot(image_timestamp, RepositoryType::Image(), Role::Timestamp());
+      measurement.success(image_timestamp.size());
     }
 
     checkTimestampExpired();
@@ -283,6 +325,9 @@ void ImageRepository::updateMeta(INvStorage& storage, const IMetadataFetcher& fe
 
     checkTargetsExpired();
   }
+
+  verified_timestamp_digest_ = timestamp_digest;
+  verified_root_version_ = rootVersion();
 }
 
 void ImageRepository::checkMetaOffline(INvStorage& storage) {
@@ -2,6 +2,7 @@
 #define IMAGE_REPOSITORY_H_
 
 #include <map>
+#include <mutex>
 #include <vector>
 
 #include "uptanerepository.h"
@@ -22,17 +23,25 @@ class ImageRepository : public RepositoryCommon {
 
   void verifySnapshot(const std::string& snapshot_raw, bool prefetch);
 
-  static std::shared_ptr<Uptane::Targets> verifyDelegation(const std::string& delegation_raw, const Uptane::Role& role,
-                                                           const Targets& parent_target);
+  // The signatures are checked on up to `max_parallel_verifications` threads.
+  static std::shared_ptr<Uptane::Targets> verifyDelegation(const SignedMeta& delegation, const Uptane::Role& role,
+                                                           const Targets& parent_target,
+                                                           size_t max_parallel_verifications);
   std::shared_ptr<const Uptane::Targets> getTargets() const { return targets; }
 
   void verifyRoleHashes(const std::string& role_data, const Uptane::Role& role, bool prefetch) const;
+  void verifyRoleHashes(const SignedMeta& role_meta, const Uptane::Role& role, bool prefetch) const;
   int getRoleVersion(const Uptane::Role& role) const;
   int64_t getRoleSize(const Uptane::Role& role) const;
 
   void checkMetaOffline(INvStorage& storage);
   void updateMeta(INvStorage& storage, const IMetadataFetcher& fetcher) override;
 
+  // Delegations verified since the metadata was last updated, see
+  // getTrustedDelegation().
+  std::shared_ptr<const Uptane::Targets> cachedDelegation(const std::string& key) const;
+  void cacheDelegation(const std::string& key, std::shared_ptr<const Uptane::Targets> delegation) const;
+
  private:
   void checkTimestampExpired();
   void checkSnapshotExpired();
@@ -40,10 +49,22 @@ class ImageRepository : public RepositoryCommon {
   void fetchSnapshot(INvStorage& storage, const IMetadataFetcher& fetcher, int local_version);
   void fetchTargets(INvStorage& storage, const IMetadataFetcher& fetcher, int local_version);
   void checkTargetsExpired();
+  static void checkHashes(const std::vector<Hash>& hashes, const SignedMeta& meta, const Uptane::Role& role,
+                          bool prefetch, const std::string& error);
 
   std::shared_ptr<Uptane::Targets> targets;
   Uptane::TimestampMeta timestamp;
   Uptane::Snapshot snapshot;
+
+  // Digest of the Timestamp metadata and version of the Root metadata of the
+  // last successful updateMeta(). If both are unchanged in the next cycle, the
+  // metadata verified in memory is still current and only its expiration needs
+  // to be checked again.
+  std::string verified_timestamp_digest_;
+  int verified_root_version_{-1};
+
+  mutable std::mutex delegations_mutex_;
+  mutable std::map<std::string, std::shared_ptr<const Uptane::Targets>> delegations_;
 };
 
 }  // namespace Uptane
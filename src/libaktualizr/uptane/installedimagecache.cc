@@ -0,0 +1,148 @@
+#include "installedimagecache.h"
+
+#include <sys/stat.h>
+
+#include <array>
+#include <fstream>
+
+#include <boost/algorithm/string.hpp>
+
+#include "crypto/crypto.h"
+#include "logging/logging.h"
+#include "utilities/utils.h"
+
+namespace Uptane {
+
+InstalledImageCache::InstalledImageCache(boost::filesystem::path image_path)
+    : image_path_(std::move(image_path)), cache_path_(image_path_.string() + ".hashcache") {}
+
+void InstalledImageCache::store(const Hash& sha256_hash, uint64_t length) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  storeUnlocked(sha256_hash, length);
+}
+
+void InstalledImageCache::storeUnlocked(const Hash& sha256_hash, uint64_t length) const {
+  Json::Value cache;
+  if (sha256_hash.type() != Hash::Type::kSha256 || !fileSignature(&cache["file"])) {
+    invalidateUnlocked();
+    return;
+  }
+  cache["sha256"] = boost::algorithm::to_lower_copy(sha256_hash.HashString());
+  cache["length"] = Json::UInt64(length);
+  try {
+    Utils::writeFile(cache_path_, cache);
+  } catch (const std::exception& ex) {
+    LOG_WARNING << "Unable to store the installed image hash: " << ex.what();
+    invalidateUnlocked();
+  }
+}
+
+bool InstalledImageCache::get(std::string* sha256_hash, uint64_t* length) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Json::Value signature;
+  if (!fileSignature(&signature)) {
+    return false;
+  }
+
+  if (boost::filesystem::exists(cache_path_)) {
+    try {
+      const Json::Value cache = Utils::parseJSONFile(cache_path_);
+      if (cache["file"] == signature && cache["sha256"].isString() && cache["length"].isIntegral()) {
+        *sha256_hash = cache["sha256"].asString();
+        *length = cache["length"].asUInt64();
+        return true;
+      }
+    } catch (const std::exception& ex) {
+      LOG_WARNING << "Ignoring invalid installed image hash cache: " << ex.what();
+    }
+    LOG_DEBUG << "Installed image " << image_path_ << " has changed, hashing it again";
+  }
+
+  return rehash(sha256_hash, length);
+}
+
+bool InstalledImageCache::verify() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string cached_hash;
+  uint64_t cached_length = 0;
+  Json::Value signature;
+  if (!fileSignature(&signature)) {
+    return false;
+  }
+  bool have_cache = false;
+  if (boost::filesystem::exists(cache_path_)) {
+    try {
+      const Json::Value cache = Utils::parseJSONFile(cache_path_);
+      cached_hash = cache["sha256"].asString();
+      cached_length = cache["length"].asUInt64();
+      have_cache = true;
+    } catch (const std::exception& ex) {
+      LOG_WARNING << "Ignoring invalid installed image hash cache: " << ex.what();
+    }
+  }
+
+  std::string hash;
+  uint64_t length = 0;
+  if (!rehash(&hash, &length)) {
+    return false;
+  }
+  if (have_cache && (hash != cached_hash || length != cached_length)) {
+    LOG_WARNING << "Installed image " << image_path_ << " does not match its cached hash";
+    return false;
+  }
+  return true;
+}
+
+void InstalledImageCache::invalidate() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  invalidateUnlocked();
+}
+
+void InstalledImageCache::invalidateUnlocked() const {
+  boost::system::error_code ec;
+  boost::filesystem::remove(cache_path_, ec);
+}
+
+bool InstalledImageCache::rehash(std::string* sha256_hash, uint64_t* length) const {
+  std::ifstream image(image_path_.c_str(), std::ios::binary);
+  if (!image.good()) {
+    return false;
+  }
+
+  auto hasher = MultiPartHasher::create(Hash::Type::kSha256);
+  std::array<char, 64 * 1024> buf{};
+  uint64_t total = 0;
+  while (image.good()) {
+    image.read(buf.data(), buf.size());
+    const auto read = image.gcount();
+    if (read > 0) {
+      hasher->update(reinterpret_cast<const unsigned char*>(buf.data()), static_cast<uint64_t>(read));
+      total += static_cast<uint64_t>(read);
+    }
+  }
+  if (image.bad()) {
+    LOG_ERROR << "Error reading installed image " << image_path_;
+    return false;
+  }
+
+  const Hash hash = hasher->getHash();
+  *sha256_hash = boost::algorithm::to_lower_copy(hash.HashString());
+  *length = total;
+  storeUnlocked(hash, total);
+  return true;
+}
+
+bool InstalledImageCache::fileSignature(Json::Value* signature) const {
+  struct stat st {};
+  if (stat(image_path_.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    return false;
+  }
+  (*signature)["dev"] = Json::UInt64(st.st_dev);
+  (*signature)["ino"] = Json::UInt64(st.st_ino);
+  (*signature)["size"] = Json::Int64(st.st_size);
+  (*signature)["mtime"] = Json::Int64(st.st_mtim.tv_sec);
+  (*signature)["mtime_nsec"] = Json::Int64(st.st_mtim.tv_nsec);
+  return true;
+}
+
+}  // namespace Uptane
@@ -0,0 +1,61 @@
+#ifndef AKTUALIZR_UPTANE_INSTALLEDIMAGECACHE_H
+#define AKTUALIZR_UPTANE_INSTALLEDIMAGECACHE_H
+
+#include <mutex>
+#include <string>
+
+#include <boost/filesystem.hpp>
+
+#include "libaktualizr/types.h"
+
+namespace Uptane {
+
+/**
+ * Persists the SHA-256 hash and the length of an installed image file next to
+ * it (in `<image>.hashcache`), so that manifests can be assembled without
+ * reading and hashing the whole image every time.
+ *
+ * The cached values are bound to the image file's metadata (inode, size and
+ * modification time). If any of them changes, the image is hashed again. An
+ * explicit integrity sweep can be requested with verify().
+ */
+class InstalledImageCache {
+ public:
+  explicit InstalledImageCache(boost::filesystem::path image_path);
+
+  /**
+   * Record the hash and length of a freshly installed image. The hash is
+   * expected to have been computed while the image was received or written.
+   */
+  void store(const Hash& sha256_hash, uint64_t length) const;
+
+  /**
+   * Get the SHA-256 hash (lower case hex) and length of the image, from the
+   * cache if it is still valid, by hashing the image otherwise.
+   * @return false if the image does not exist.
+   */
+  bool get(std::string* sha256_hash, uint64_t* length) const;
+
+  /**
+   * Hash the image unconditionally and refresh the cache.
+   * @return false if the image does not exist or the cached values did not
+   * match the image contents.
+   */
+  bool verify() const;
+
+  void invalidate() const;
+
+ private:
+  void storeUnlocked(const Hash& sha256_hash, uint64_t length) const;
+  void invalidateUnlocked() const;
+  bool rehash(std::string* sha256_hash, uint64_t* length) const;
+  bool fileSignature(Json::Value* signature) const;
+
+  const boost::filesystem::path image_path_;
+  const boost::filesystem::path cache_path_;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace Uptane
+
+#endif  // AKTUALIZR_UPTANE_INSTALLEDIMAGECACHE_H
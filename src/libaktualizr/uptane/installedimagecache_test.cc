@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <boost/algorithm/string.hpp>
+
+#include "crypto/crypto.h"
+#include "test_utils.h"
+#include "uptane/installedimagecache.h"
+#include "utilities/utils.h"
+
+static std::string sha256Hex(const std::string &data) {
+  return boost::algorithm::to_lower_copy(Hash::generate(Hash::Type::kSha256, data).HashString());
+}
+
+/*
+ * The hash of an image without a cache entry is computed from the file.
+ */
+TEST(InstalledImageCache, HashWithoutCache) {
+  TemporaryDirectory temp_dir;
+  const auto image = temp_dir / "firmware.bin";
+  Utils::writeFile(image, std::string("firmware content"));
+
+  Uptane::InstalledImageCache cache(image);
+  std::string hash;
+  uint64_t len = 0;
+  ASSERT_TRUE(cache.get(&hash, &len));
+  EXPECT_EQ(hash, sha256Hex("firmware content"));
+  EXPECT_EQ(len, 16u);
+  EXPECT_TRUE(boost::filesystem::exists(image.string() + ".hashcache"));
+}
+
+/*
+ * A missing image is reported as such.
+ */
+TEST(InstalledImageCache, NoImage) {
+  TemporaryDirectory temp_dir;
+  Uptane::InstalledImageCache cache(temp_dir / "firmware.bin");
+  std::string hash;
+  uint64_t len = 0;
+  EXPECT_FALSE(cache.get(&hash, &len));
+  EXPECT_FALSE(cache.verify());
+}
+
+/*
+ * The stored hash is returned as long as the image is unchanged, without
+ * reading the image again.
+ */
+TEST(InstalledImageCache, StoredHashIsUsed) {
+  TemporaryDirectory temp_dir;
+  const auto image = temp_dir / "firmware.bin";
+  Utils::writeFile(image, std::string("firmware content"));
+
+  Uptane::InstalledImageCache cache(image);
+  // deliberately wrong to prove that the image is not hashed again
+  const Hash stored = Hash::generate(Hash::Type::kSha256, "something else");
+  cache.store(stored, 42);
+
+  std::string hash;
+  uint64_t len = 0;
+  ASSERT_TRUE(cache.get(&hash, &len));
+  EXPECT_EQ(hash, sha256Hex("something else"));
+  EXPECT_EQ(len, 42u);
+
+  // an explicit integrity sweep detects the mismatch and fixes the cache
+  EXPECT_FALSE(cache.verify());
+  ASSERT_TRUE(cache.get(&hash, &len));
+  EXPECT_EQ(hash, sha256Hex("firmware content"));
+  EXPECT_EQ(len, 16u);
+  EXPECT_TRUE(cache.verify());
+}
+
+/*
+ * Replacing the image invalidates the cached hash.
+ */
+TEST(InstalledImageCache, ChangedImage) {
+  TemporaryDirectory temp_dir;
+  const auto image = temp_dir / "firmware.bin";
+  Utils::writeFile(image, std::string("firmware content"));
+
+  Uptane::InstalledImageCache cache(image);
+  cache.store(Hash::generate(Hash::Type::kSha256, "firmware content"), 16);
+
+  // Utils::writeFile() renames a new file over the old one, so the inode changes
+  Utils::writeFile(image, std::string("new firmware"));
+  std::string hash;
+  uint64_t len = 0;
+  ASSERT_TRUE(cache.get(&hash, &len));
+  EXPECT_EQ(hash, sha256Hex("new firmware"));
+  EXPECT_EQ(len, 12u);
+}
+
+/*
+ * Only SHA-256 hashes can be cached.
+ */
+TEST(InstalledImageCache, WrongHashType) {
+  TemporaryDirectory temp_dir;
+  const auto image = temp_dir / "firmware.bin";
+  Utils::writeFile(image, std::string("firmware content"));
+
+  Uptane::InstalledImageCache cache(image);
+  cache.store(Hash::generate(Hash::Type::kSha512, "firmware content"), 16);
+  EXPECT_FALSE(boost::filesystem::exists(image.string() + ".hashcache"));
+}
+
+#ifndef __NO_MAIN__
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+#endif
@@ -1,60 +1,280 @@
 #include "iterator.h"
 
+#include <fnmatch.h>
+
+#include <algorithm>
+#include <exception>
+
+#include "utilities/parallel.h"
+
 namespace Uptane {
 
-Targets getTrustedDelegation(const Role &delegate_role, const Targets &parent_targets,
-                             const ImageRepository &image_repo, INvStorage &storage, Fetcher &fetcher,
-                             const bool offline) {
-  std::string delegation_meta;
+namespace {
+
+// Load a delegation from the storage, unless the stored one is outdated.
+// @return false if the delegation has to be fetched.
+bool loadStoredDelegation(const Role &delegate_role, const ImageRepository &image_repo, INvStorage &storage,
+                          std::string *delegation_meta) {
   auto version_in_snapshot = image_repo.getRoleVersion(delegate_role);
 
-  if (storage.loadDelegation(&delegation_meta, delegate_role)) {
-    auto version = extractVersionUntrusted(delegation_meta);
+  if (storage.loadDelegation(delegation_meta, delegate_role)) {
+    auto version = extractVersionUntrusted(*delegation_meta);
 
     if (version > version_in_snapshot) {
       throw SecurityException("image", "Rollback attempt on delegated targets");
     } else if (version < version_in_snapshot) {
-      delegation_meta.clear();
+      delegation_meta->clear();
       storage.deleteDelegation(delegate_role);
     }
   }
+  return !delegation_meta->empty();
+}
 
-  bool delegation_remote = delegation_meta.empty();
-  if (delegation_remote) {
-    // Don't fetch anything remote if we are supposed to already have it.
-    if (offline) {
-      throw Uptane::DelegationMissing(delegate_role.ToString());
-    }
-    try {
-      fetcher.fetchLatestRole(&delegation_meta, Uptane::kMaxImageTargetsSize, RepositoryType::Image(), delegate_role);
-    } catch (const std::exception &e) {
-      LOG_ERROR << "Fetch role error: " << e.what();
-      throw Uptane::DelegationMissing(delegate_role.ToString());
-    }
+void fetchDelegation(const Role &delegate_role, const Fetcher &fetcher, const bool offline,
+                     std::string *delegation_meta) {
+  // Don't fetch anything remote if we are supposed to already have it.
+  if (offline) {
+    throw Uptane::DelegationMissing(delegate_role.ToString());
+  }
+  try {
+    fetcher.fetchLatestRole(delegation_meta, Uptane::kMaxImageTargetsSize, RepositoryType::Image(), delegate_role);
+  } catch (const std::exception &e) {
+    LOG_ERROR << "Fetch role error: " << e.what();
+    throw Uptane::DelegationMissing(delegate_role.ToString());
   }
+}
 
+// Check the hashes, the signatures and the version of a loaded delegation.
+// Only reads the (immutable) metadata, so it can be run concurrently.
+std::shared_ptr<Targets> verifyLoadedDelegation(const Role &delegate_role, const Targets &parent_targets,
+                                                const ImageRepository &image_repo,
+                                                const std::string &delegation_meta, const bool remote,
+                                                const size_t max_parallel_verifications) {
+  MetadataMetrics::Measurement measurement(image_repo.metrics(), RepositoryType::Image(), delegate_role,
+                                           MetadataMetrics::Step::kVerify);
+  Json::Value delegation_json = Utils::parseJSON(delegation_meta);
+  const auto delegation_signed = SignedMeta::Consumable(delegation_json);
   try {
-    image_repo.verifyRoleHashes(delegation_meta, delegate_role, false);
+    image_repo.verifyRoleHashes(delegation_signed, delegate_role, false);
   } catch (const std::exception &e) {
     LOG_ERROR << "Role hashes error: " << e.what();
     throw Uptane::DelegationHashMismatch(delegate_role.ToString());
   }
 
-  auto delegation = ImageRepository::verifyDelegation(delegation_meta, delegate_role, parent_targets);
+  auto delegation = ImageRepository::verifyDelegation(delegation_signed, delegate_role, parent_targets,
+                                                      max_parallel_verifications);
   if (delegation == nullptr) {
     throw SecurityException("image", "Delegation verification failed");
   }
 
-  if (delegation_remote) {
-    if (delegation->version() != version_in_snapshot) {
-      throw VersionMismatch("image", delegate_role.ToString());
+  if (remote && delegation->version() != image_repo.getRoleVersion(delegate_role)) {
+    throw VersionMismatch("image", delegate_role.ToString());
+  }
+  measurement.success(delegation_meta.size());
+  return delegation;
+}
+
+void storeDelegation(const Role &delegate_role, const ImageRepository &image_repo, INvStorage &storage,
+                     const std::string &delegation_meta) {
+  MetadataMetrics::Measurement measurement(image_repo.metrics(), RepositoryType::Image(), delegate_role,
+                                           MetadataMetrics::Step::kStore);
+  storage.storeDelegation(delegation_meta, delegate_role);
+  measurement.success(delegation_meta.size());
+}
+
+// The same delegated role may be delegated by different parents, with
+// different keys.
+std::string delegationCacheKey(const Role &delegate_role, const Targets &parent_targets) {
+  return delegate_role.ToString() + "\n" + parent_targets.rolePolicy(delegate_role);
+}
+
+struct LoadedDelegation {
+  std::string meta;
+  bool remote{false};
+  std::shared_ptr<const Targets> delegation;
+  std::exception_ptr error;
+};
+
+// Load, fetch and verify several delegations. Every step that touches the
+// storage is done serially, fetching and verification are done in parallel.
+std::vector<LoadedDelegation> loadDelegations(const std::vector<std::pair<Role, const Targets *>> &delegations,
+                                              const ImageRepository &image_repo, INvStorage &storage,
+                                              const Fetcher &fetcher, const bool offline,
+                                              const size_t max_parallel_fetches,
+                                              const size_t max_parallel_verifications) {
+  std::vector<LoadedDelegation> loaded(delegations.size());
+
+  for (size_t i = 0; i < delegations.size(); ++i) {
+    const Role &role = delegations[i].first;
+    loaded[i].delegation = image_repo.cachedDelegation(delegationCacheKey(role, *delegations[i].second));
+    if (loaded[i].delegation) {
+      continue;
+    }
+    try {
+      loaded[i].remote = !loadStoredDelegation(role, image_repo, storage, &loaded[i].meta);
+    } catch (...) {
+      loaded[i].error = std::current_exception();
     }
-    storage.storeDelegation(delegation_meta, delegate_role);
   }
 
+  parallelFor(delegations.size(), max_parallel_fetches, [&](size_t i) {
+    if (loaded[i].error || loaded[i].delegation || !loaded[i].remote) {
+      return;
+    }
+    try {
+      fetchDelegation(delegations[i].first, fetcher, offline, &loaded[i].meta);
+    } catch (...) {
+      loaded[i].error = std::current_exception();
+    }
+  });
+
+  // The threads are shared out between the delegations rather than used by
+  // every one of them for its own signatures.
+  const size_t per_delegation =
+      std::max<size_t>(1, max_parallel_verifications / std::max<size_t>(1, delegations.size()));
+  parallelFor(delegations.size(), max_parallel_verifications, [&](size_t i) {
+    if (loaded[i].error || loaded[i].delegation) {
+      return;
+    }
+    try {
+      loaded[i].delegation = verifyLoadedDelegation(delegations[i].first, *delegations[i].second, image_repo,
+                                                    loaded[i].meta, loaded[i].remote, per_delegation);
+    } catch (...) {
+      loaded[i].error = std::current_exception();
+    }
+  });
+
+  for (size_t i = 0; i < delegations.size(); ++i) {
+    if (loaded[i].error || loaded[i].meta.empty()) {
+      // failed, or already verified in this update cycle
+      continue;
+    }
+    try {
+      if (loaded[i].remote) {
+        storeDelegation(delegations[i].first, image_repo, storage, loaded[i].meta);
+      }
+      image_repo.cacheDelegation(delegationCacheKey(delegations[i].first, *delegations[i].second),
+                                 loaded[i].delegation);
+    } catch (...) {
+      loaded[i].error = std::current_exception();
+    }
+  }
+  return loaded;
+}
+
+}  // namespace
+
+bool delegationMatches(const Targets &parent_targets, const Role &delegate_role, const std::string &filename) {
+  auto patterns = parent_targets.paths_for_role_.find(delegate_role);
+  if (patterns == parent_targets.paths_for_role_.end()) {
+    return false;
+  }
+  for (const auto &pattern : patterns->second) {
+    if (fnmatch(pattern.c_str(), filename.c_str(), 0) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+Targets getTrustedDelegation(const Role &delegate_role, const Targets &parent_targets,
+                             const ImageRepository &image_repo, INvStorage &storage, Fetcher &fetcher,
+                             const bool offline) {
+  const std::string cache_key = delegationCacheKey(delegate_role, parent_targets);
+  auto cached = image_repo.cachedDelegation(cache_key);
+  if (cached) {
+    return *cached;
+  }
+
+  std::string delegation_meta;
+  const bool remote = !loadStoredDelegation(delegate_role, image_repo, storage, &delegation_meta);
+  if (remote) {
+    fetchDelegation(delegate_role, fetcher, offline, &delegation_meta);
+  }
+  auto delegation = verifyLoadedDelegation(delegate_role, parent_targets, image_repo, delegation_meta, remote,
+                                           image_repo.maxParallelVerifications());
+  if (remote) {
+    storeDelegation(delegate_role, image_repo, storage, delegation_meta);
+  }
+  image_repo.cacheDelegation(cache_key, delegation);
+
   return *delegation;
 }
 
+std::vector<std::future<Targets>> getTrustedDelegations(const std::vector<Role> &delegate_roles,
+                                                        const Targets &parent_targets,
+                                                        const ImageRepository &image_repo, INvStorage &storage,
+                                                        Fetcher &fetcher, const bool offline,
+                                                        const size_t max_parallel_fetches,
+                                                        const size_t max_parallel_verifications) {
+  std::vector<std::pair<Role, const Targets *>> delegations;
+  delegations.reserve(delegate_roles.size());
+  for (const auto &role : delegate_roles) {
+    delegations.emplace_back(role, &parent_targets);
+  }
+  auto loaded = loadDelegations(delegations, image_repo, storage, fetcher, offline, max_parallel_fetches,
+                                max_parallel_verifications);
+
+  std::vector<std::future<Targets>> result;
+  result.reserve(loaded.size());
+  for (auto &l : loaded) {
+    std::promise<Targets> promise;
+    if (l.error) {
+      promise.set_exception(l.error);
+    } else {
+      promise.set_value(*l.delegation);
+    }
+    result.push_back(promise.get_future());
+  }
+  return result;
+}
+
+void prefetchDelegations(const Target &target, const ImageRepository &image_repo, INvStorage &storage,
+                         Fetcher &fetcher, const size_t max_parallel_fetches,
+                         const size_t max_parallel_verifications) {
+  auto toplevel = image_repo.getTargets();
+  if (toplevel == nullptr || max_parallel_fetches < 2) {
+    return;
+  }
+
+  // Delegations whose own delegations are to be searched, along with the
+  // Targets metadata they come from.
+  std::vector<std::shared_ptr<const Targets>> parents{toplevel};
+  for (int level = 0; level < kDelegationsMaxDepth && !parents.empty(); ++level) {
+    std::vector<std::pair<Role, const Targets *>> delegations;
+    for (const auto &parent : parents) {
+      for (const auto &name : parent->delegated_role_names_) {
+        const Role role = Role::Delegation(name);
+        // Only the roles listed in the Snapshot metadata can be verified.
+        if (image_repo.getRoleVersion(role) >= 0 && delegationMatches(*parent, role, target.filename())) {
+          delegations.emplace_back(role, parent.get());
+        }
+      }
+    }
+    if (delegations.empty()) {
+      break;
+    }
+
+    // Errors are reported when the search gets to the failed delegation.
+    auto loaded = loadDelegations(delegations, image_repo, storage, fetcher, false, max_parallel_fetches,
+                                  max_parallel_verifications);
+
+    std::vector<std::shared_ptr<const Targets>> next_parents;
+    for (size_t i = 0; i < delegations.size(); ++i) {
+      if (loaded[i].error || loaded[i].delegation->isExpired(TimeStamp::Now())) {
+        continue;
+      }
+      const auto terminating = delegations[i].second->terminating_role_.find(delegations[i].first);
+      if (terminating == delegations[i].second->terminating_role_.end() || terminating->second) {
+        continue;
+      }
+      next_parents.push_back(loaded[i].delegation);
+    }
+    // keep the parents alive until their delegations have been verified
+    parents = std::move(next_parents);
+  }
+}
+
 LazyTargetsList::DelegationIterator::DelegationIterator(const ImageRepository &repo,
                                                         std::shared_ptr<INvStorage> storage,
                                                         std::shared_ptr<Fetcher> fetcher, bool is_end)
@@ -111,11 +331,11 @@ const Target &LazyTargetsList::DelegationIterator::operator*() {
     renewTargetsData();
   }
 
-  if (!cur_targets_ || target_idx_ >= cur_targets_->targets.size()) {
+  if (!cur_targets_ || target_idx_ >= cur_targets_->targets().size()) {
     throw std::runtime_error("Inconsistent delegation iterator");
   }
 
-  return cur_targets_->targets[target_idx_];
+  return cur_targets_->targets()[target_idx_];
 }
 
 LazyTargetsList::DelegationIterator LazyTargetsList::DelegationIterator::operator++() {
@@ -128,7 +348,7 @@ LazyTargetsList::DelegationIterator LazyTargetsList::DelegationIterator::operato
   }
 
   // first iterate over current role's targets
-  if (target_idx_ + 1 < cur_targets_->targets.size()) {
+  if (target_idx_ + 1 < cur_targets_->targets().size()) {
     ++target_idx_;
     return *this;
   }
@@ -183,7 +403,7 @@ LazyTargetsList::DelegationIterator LazyTargetsList::DelegationIterator::operato
     cur_targets_.reset();
     tree_node_ = new_tree_node;
     renewTargetsData();
-    target_idx_ = cur_targets_->targets.size();  // mark targets as exhausted
+    target_idx_ = cur_targets_->targets().size();  // mark targets as exhausted
     return ++(*this);                            // reiterate to find the next target
   }
 
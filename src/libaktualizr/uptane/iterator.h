@@ -1,14 +1,47 @@
 #ifndef AKTUALIZR_UPTANE_ITERATOR_H_
 #define AKTUALIZR_UPTANE_ITERATOR_H_
 
+#include <future>
+#include <vector>
+
 #include "fetcher.h"
 #include "imagerepository.h"
 
 namespace Uptane {
 
+/**
+ * Get a verified delegation of `parent_targets`. Delegations are kept in
+ * memory by the ImageRepository until its metadata is updated again.
+ */
 Targets getTrustedDelegation(const Role &delegate_role, const Targets &parent_targets,
                              const ImageRepository &image_repo, INvStorage &storage, Fetcher &fetcher, bool offline);
 
+/**
+ * Get several delegations of the same parent. The stored metadata is loaded
+ * one delegation after another, the missing metadata is fetched on up to
+ * `max_parallel_fetches` threads and everything is verified on up to
+ * `max_parallel_verifications` threads. The results are returned in the order
+ * of `delegate_roles`; a delegation that could not be verified holds the same
+ * exception getTrustedDelegation() would have thrown.
+ */
+std::vector<std::future<Targets>> getTrustedDelegations(const std::vector<Role> &delegate_roles,
+                                                        const Targets &parent_targets,
+                                                        const ImageRepository &image_repo, INvStorage &storage,
+                                                        Fetcher &fetcher, bool offline, size_t max_parallel_fetches,
+                                                        size_t max_parallel_verifications);
+
+/**
+ * Fetch and verify, one level of the delegation tree at a time, every
+ * delegation (listed in the Snapshot metadata) that may contain `target`, so
+ * that a later search through getTrustedDelegation() does not wait for the
+ * network. Failures are ignored here, they are reported by the search.
+ */
+void prefetchDelegations(const Target &target, const ImageRepository &image_repo, INvStorage &storage,
+                         Fetcher &fetcher, size_t max_parallel_fetches, size_t max_parallel_verifications);
+
+// Whether the paths of a delegation of `parent_targets` match the file name.
+bool delegationMatches(const Targets &parent_targets, const Role &delegate_role, const std::string &filename);
+
 class LazyTargetsList {
  public:
   struct DelegatedTargetTreeNode {
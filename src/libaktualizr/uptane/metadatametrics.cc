@@ -0,0 +1,93 @@
+#include "metadatametrics.h"
+
+#include <algorithm>
+
+namespace Uptane {
+
+MetadataMetrics::Measurement::Measurement(std::shared_ptr<MetadataMetrics> metrics, RepositoryType repo,
+                                          const Role &role, Step step)
+    : metrics_(std::move(metrics)),
+      repo_(repo),
+      role_(role),
+      step_(step),
+      start_(std::chrono::steady_clock::now()) {}
+
+MetadataMetrics::Measurement::~Measurement() {
+  if (metrics_ != nullptr) {
+    metrics_->record(repo_, role_, step_, std::chrono::steady_clock::now() - start_, bytes_, ok_);
+  }
+}
+
+std::string MetadataMetrics::StepString(Step step) {
+  switch (step) {
+    case Step::kFetch:
+      return "fetch";
+    case Step::kVerify:
+      return "verify";
+    case Step::kStore:
+      return "store";
+    default:
+      return "unknown";
+  }
+}
+
+void MetadataMetrics::record(RepositoryType repo, const Role &role, Step step,
+                             std::chrono::steady_clock::duration duration, uint64_t bytes, bool ok) {
+  const auto duration_us =
+      static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+  const Key key{repo.toString(), role.ToString(), step};
+  std::lock_guard<std::mutex> lock(mutex_);
+  add(&totals_, key, duration_us, bytes, ok);
+  add(&cycle_, key, duration_us, bytes, ok);
+}
+
+result::MetadataMetrics MetadataMetrics::totals() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return toResult(totals_);
+}
+
+result::MetadataMetrics MetadataMetrics::takeCycle() {
+  Table cycle;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::swap(cycle, cycle_);
+  }
+  return toResult(cycle);
+}
+
+void MetadataMetrics::add(Table *table, const Key &key, const uint64_t duration_us, const uint64_t bytes,
+                          const bool ok) {
+  auto it = table->find(key);
+  if (it == table->end()) {
+    it = table->emplace(key, result::MetadataStepMetrics(std::get<0>(key), std::get<1>(key),
+                                                         StepString(std::get<2>(key))))
+             .first;
+  }
+  result::MetadataStepMetrics &m = it->second;
+  ++m.count;
+  if (!ok) {
+    ++m.failures;
+  }
+  m.bytes += bytes;
+  m.total_us += duration_us;
+  m.max_us = std::max(m.max_us, duration_us);
+
+  const auto bucket = [](const std::vector<uint64_t> &bounds, const uint64_t value) {
+    return static_cast<size_t>(std::lower_bound(bounds.cbegin(), bounds.cend(), value) - bounds.cbegin());
+  };
+  ++m.latency_histogram[bucket(result::MetadataStepMetrics::LatencyBoundsUs(), duration_us)];
+  if (ok) {
+    ++m.size_histogram[bucket(result::MetadataStepMetrics::SizeBoundsBytes(), bytes)];
+  }
+}
+
+result::MetadataMetrics MetadataMetrics::toResult(const Table &table) {
+  std::vector<result::MetadataStepMetrics> steps;
+  steps.reserve(table.size());
+  for (const auto &entry : table) {
+    steps.push_back(entry.second);
+  }
+  return result::MetadataMetrics(std::move(steps));
+}
+
+}  // namespace Uptane
@@ -0,0 +1,74 @@
+#ifndef AKTUALIZR_UPTANE_METADATAMETRICS_H
+#define AKTUALIZR_UPTANE_METADATAMETRICS_H
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include "libaktualizr/results.h"
+#include "uptane/tuf.h"
+
+namespace Uptane {
+
+/**
+ * Collects the latency and size of the steps of the metadata processing
+ * (fetching, verifying and storing every role), both since its creation and
+ * for the current Uptane cycle. Can be fed from several threads.
+ */
+class MetadataMetrics {
+ public:
+  enum class Step { kFetch, kVerify, kStore };
+
+  /**
+   * Measures a step from its construction to its destruction. The step is
+   * counted as failed unless success() has been called, so that exceptions
+   * are accounted for. Does nothing if `metrics` is null.
+   */
+  class Measurement {
+   public:
+    Measurement(std::shared_ptr<MetadataMetrics> metrics, RepositoryType repo, const Role &role, Step step);
+    ~Measurement();
+    Measurement(const Measurement &) = delete;
+    Measurement &operator=(const Measurement &) = delete;
+    void success(uint64_t bytes) {
+      ok_ = true;
+      bytes_ = bytes;
+    }
+
+   private:
+    std::shared_ptr<MetadataMetrics> metrics_;
+    RepositoryType repo_;
+    Role role_;
+    Step step_;
+    std::chrono::steady_clock::time_point start_;
+    bool ok_{false};
+    uint64_t bytes_{0};
+  };
+
+  static std::string StepString(Step step);
+
+  void record(RepositoryType repo, const Role &role, Step step, std::chrono::steady_clock::duration duration,
+              uint64_t bytes, bool ok);
+  /** Everything recorded so far. */
+  result::MetadataMetrics totals() const;
+  /** What has been recorded since the previous call, i.e. during the current cycle. */
+  result::MetadataMetrics takeCycle();
+
+ private:
+  using Key = std::tuple<std::string, std::string, Step>;
+  using Table = std::map<Key, result::MetadataStepMetrics>;
+
+  static void add(Table *table, const Key &key, uint64_t duration_us, uint64_t bytes, bool ok);
+  static result::MetadataMetrics toResult(const Table &table);
+
+  mutable std::mutex mutex_;
+  Table totals_;
+  Table cycle_;
+};
+
+}  // namespace Uptane
+
+#endif  // AKTUALIZR_UPTANE_METADATAMETRICS_H
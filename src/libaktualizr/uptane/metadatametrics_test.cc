@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdexcept>
+
+#include "uptane/metadatametrics.h"
+
+namespace {
+
+const result::MetadataStepMetrics *findStep(const result::MetadataMetrics &metrics, const std::string &repo,
+                                            const std::string &role, const std::string &step) {
+  for (const auto &s : metrics.steps) {
+    if (s.repo == repo && s.role == role && s.step == step) {
+      return &s;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+/*
+ * Samples are aggregated per repository, role and step, and sorted into the
+ * latency and size histogram buckets.
+ */
+TEST(MetadataMetrics, Aggregation) {
+  Uptane::MetadataMetrics metrics;
+  metrics.record(Uptane::RepositoryType::Image(), Uptane::Role::Targets(), Uptane::MetadataMetrics::Step::kFetch,
+                 std::chrono::microseconds(50), 500, true);
+  metrics.record(Uptane::RepositoryType::Image(), Uptane::Role::Targets(), Uptane::MetadataMetrics::Step::kFetch,
+                 std::chrono::milliseconds(20), 100 * 1024, true);
+  metrics.record(Uptane::RepositoryType::Director(), Uptane::Role::Root(), Uptane::MetadataMetrics::Step::kVerify,
+                 std::chrono::microseconds(10), 0, true);
+
+  const auto totals = metrics.totals();
+  ASSERT_EQ(totals.steps.size(), 2u);
+
+  const auto *fetch = findStep(totals, "image", "targets", "fetch");
+  ASSERT_NE(fetch, nullptr);
+  EXPECT_EQ(fetch->count, 2u);
+  EXPECT_EQ(fetch->failures, 0u);
+  EXPECT_EQ(fetch->bytes, 500u + 100u * 1024u);
+  EXPECT_EQ(fetch->total_us, 50u + 20000u);
+  EXPECT_EQ(fetch->max_us, 20000u);
+  ASSERT_EQ(fetch->latency_histogram.size(), result::MetadataStepMetrics::LatencyBoundsUs().size() + 1);
+  EXPECT_EQ(fetch->latency_histogram[0], 1u);
+  EXPECT_EQ(fetch->latency_histogram[3], 1u);
+  ASSERT_EQ(fetch->size_histogram.size(), result::MetadataStepMetrics::SizeBoundsBytes().size() + 1);
+  EXPECT_EQ(fetch->size_histogram[0], 1u);
+  EXPECT_EQ(fetch->size_histogram[3], 1u);
+
+  EXPECT_NE(findStep(totals, "director", "root", "verify"), nullptr);
+}
+
+/*
+ * takeCycle() only reports what was recorded since its previous call, while
+ * the totals keep growing.
+ */
+TEST(MetadataMetrics, Cycles) {
+  Uptane::MetadataMetrics metrics;
+  metrics.record(Uptane::RepositoryType::Director(), Uptane::Role::Targets(), Uptane::MetadataMetrics::Step::kStore,
+                 std::chrono::microseconds(10), 10, true);
+  auto cycle = metrics.takeCycle();
+  ASSERT_EQ(cycle.steps.size(), 1u);
+  EXPECT_EQ(cycle.steps[0].count, 1u);
+
+  EXPECT_TRUE(metrics.takeCycle().steps.empty());
+
+  metrics.record(Uptane::RepositoryType::Director(), Uptane::Role::Targets(), Uptane::MetadataMetrics::Step::kStore,
+                 std::chrono::microseconds(10), 10, true);
+  cycle = metrics.takeCycle();
+  ASSERT_EQ(cycle.steps.size(), 1u);
+  EXPECT_EQ(cycle.steps[0].count, 1u);
+
+  const auto totals = metrics.totals();
+  ASSERT_EQ(totals.steps.size(), 1u);
+  EXPECT_EQ(totals.steps[0].count, 2u);
+}
+
+/*
+ * A measurement left without calling success(), e.g. because of an
+ * exception, is counted as a failure and does not contribute to the size
+ * histogram.
+ */
+TEST(MetadataMetrics, MeasurementFailure) {
+  auto metrics = std::make_shared<Uptane::MetadataMetrics>();
+  {
+    Uptane::MetadataMetrics::Measurement m(metrics, Uptane::RepositoryType::Image(), Uptane::Role::Snapshot(),
+                                           Uptane::MetadataMetrics::Step::kVerify);
+    m.success(42);
+  }
+  try {
+    Uptane::MetadataMetrics::Measurement m(metrics, Uptane::RepositoryType::Image(), Uptane::Role::Snapshot(),
+                                           Uptane::MetadataMetrics::Step::kVerify);
+    throw std::runtime_error("verification failed");
+  } catch (const std::runtime_error &) {
+  }
+  // Without a collector, measurements are no-ops.
+  {
+    Uptane::MetadataMetrics::Measurement m(nullptr, Uptane::RepositoryType::Image(), Uptane::Role::Snapshot(),
+                                           Uptane::MetadataMetrics::Step::kVerify);
+  }
+
+  const auto totals = metrics->totals();
+  const auto *verify = findStep(totals, "image", "snapshot", "verify");
+  ASSERT_NE(verify, nullptr);
+  EXPECT_EQ(verify->count, 2u);
+  EXPECT_EQ(verify->failures, 1u);
+  EXPECT_EQ(verify->bytes, 42u);
+  uint64_t sized = 0;
+  for (const auto n : verify->size_histogram) {
+    sized += n;
+  }
+  EXPECT_EQ(sized, 1u);
+}
+
+#ifndef __NO_MAIN__
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+#endif
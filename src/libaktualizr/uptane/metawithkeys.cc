@@ -5,9 +5,9 @@
 using Uptane::MetaWithKeys;
 
 MetaWithKeys::MetaWithKeys(const Json::Value &json) : BaseMeta(json) {}
-MetaWithKeys::MetaWithKeys(RepositoryType repo, const Role &role, const Json::Value &json,
+MetaWithKeys::MetaWithKeys(RepositoryType repo, const Role &role, const SignedMeta &meta,
                            const std::shared_ptr<MetaWithKeys> &signer)
-    : BaseMeta(repo, role, json, signer) {}
+    : BaseMeta(repo, role, meta, signer) {}
 
 void Uptane::MetaWithKeys::ParseKeys(const RepositoryType repo, const Json::Value &keys) {
   for (auto it = keys.begin(); it != keys.end(); ++it) {
@@ -55,9 +55,22 @@ void Uptane::MetaWithKeys::ParseRole(const RepositoryType repo, const Json::Valu
   }
 }
 
+std::string Uptane::MetaWithKeys::rolePolicy(const Role &role) const {
+  std::string policy;
+  const auto threshold = thresholds_for_role_.find(role);
+  policy += std::to_string(threshold != thresholds_for_role_.end() ? threshold->second : 0);
+  for (const auto &key : keys_for_role_) {
+    if (key.first == role && keys_.count(key.second) != 0U) {
+      policy += " " + key.second + ":" + keys_.at(key.second).Value();
+    }
+  }
+  return policy;
+}
+
 void Uptane::MetaWithKeys::UnpackSignedObject(const RepositoryType repo, const Role &role,
-                                              const Json::Value &signed_object) {
+                                              const SignedMeta &meta) {
   const std::string repository = repo;
+  const Json::Value &signed_object = meta.json();
 
   const Uptane::Role type(signed_object["signed"]["_type"].asString());
   if (role.IsDelegation()) {
@@ -71,11 +84,13 @@ void Uptane::MetaWithKeys::UnpackSignedObject(const RepositoryType repo, const R
                             "Metadata type " + type.ToString() + " does not match expected role " + role.ToString());
   }
 
-  const std::string canonical = Utils::jsonToCanonicalStr(signed_object["signed"]);
-  const Json::Value signatures = signed_object["signatures"];
+  const std::string &canonical = meta.signedCanonical();
+  const Json::Value &signatures = signed_object["signatures"];
   int valid_signatures = 0;
 
   std::set<std::string> used_keyids;
+  std::vector<KeyId> candidates;
+  std::vector<SignatureCheck> checks;
   for (auto sig = signatures.begin(); sig != signatures.end(); ++sig) {
     const std::string keyid = (*sig)["keyid"].asString();
     if (used_keyids.count(keyid) != 0) {
@@ -99,11 +114,18 @@ void Uptane::MetaWithKeys::UnpackSignedObject(const RepositoryType repo, const R
       LOG_WARNING << "KeyId " << keyid << " is not valid to sign for this role (" << role.ToString() << ").";
       continue;
     }
-    const std::string signature = (*sig)["sig"].asString();
-    if (keys_[keyid].VerifySignature(signature, canonical)) {
+    candidates.push_back(keyid);
+    checks.emplace_back(keys_.at(keyid), (*sig)["sig"].asString(), canonical);
+  }
+
+  // The signatures are independent of each other: submit them to the
+  // verification backend as one batch, but report the results in order.
+  const std::vector<bool> valid = Crypto::signatureVerifier()->verifyBatch(checks, max_parallel_verifications_);
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    if (valid.at(i)) {
       valid_signatures++;
     } else {
-      LOG_WARNING << "Signature was present but invalid: " << signature << " with KeyId: " << keyid;
+      LOG_WARNING << "Signature was present but invalid: " << checks[i].signature << " with KeyId: " << candidates[i];
     }
   }
   const int64_t threshold = thresholds_for_role_[role];
@@ -5,8 +5,10 @@
 using Uptane::Root;
 
 Root::Root(const RepositoryType repo, const Json::Value &json, Root &root) : Root(repo, json) {
-  root.UnpackSignedObject(repo, Role::Root(), json);
-  this->Root::UnpackSignedObject(repo, Role::Root(), json);
+  max_parallel_verifications_ = root.max_parallel_verifications_;
+  const SignedMeta meta(json);
+  root.UnpackSignedObject(repo, Role::Root(), meta);
+  this->Root::UnpackSignedObject(repo, Role::Root(), meta);
 }
 
 Root::Root(const RepositoryType repo, const Json::Value &json) : MetaWithKeys(json), policy_(Policy::kCheck) {
@@ -26,7 +28,7 @@ Root::Root(const RepositoryType repo, const Json::Value &json) : MetaWithKeys(js
   }
 }
 
-void Uptane::Root::UnpackSignedObject(const RepositoryType repo, const Role &role, const Json::Value &signed_object) {
+void Uptane::Root::UnpackSignedObject(const RepositoryType repo, const Role &role, const SignedMeta &signed_object) {
   const std::string repository = repo;
 
   if (policy_ == Policy::kAcceptAll) {
@@ -1,8 +1,11 @@
 #include "uptane/tuf.h"
 
+#include <algorithm>
 #include <ctime>
+#include <mutex>
 #include <ostream>
 #include <sstream>
+#include <unordered_map>
 
 #include <boost/algorithm/hex.hpp>
 #include <boost/algorithm/string/case_conv.hpp>
@@ -12,6 +15,7 @@
 #include "libaktualizr/types.h"
 #include "logging/logging.h"
 #include "utilities/exceptions.h"
+#include "utilities/utils.h"
 
 using Uptane::Target;
 using Uptane::Version;
@@ -25,8 +29,29 @@ std::ostream &Uptane::operator<<(std::ostream &os, const Version &v) {
   return os;
 }
 
+std::shared_ptr<const std::string> Uptane::HardwareIdentifier::intern(const std::string &hwid) {
+  static std::mutex m;
+  static std::unordered_map<std::string, std::weak_ptr<const std::string>> pool;
+  static size_t purge_size = 64;
+
+  std::lock_guard<std::mutex> lock(m);
+  auto &entry = pool[hwid];
+  auto res = entry.lock();
+  if (!res) {
+    res = std::make_shared<const std::string>(hwid);
+    entry = res;
+  }
+  if (pool.size() >= purge_size) {
+    for (auto it = pool.begin(); it != pool.end();) {
+      it = it->second.expired() ? pool.erase(it) : std::next(it);
+    }
+    purge_size = std::max<size_t>(64, 2 * pool.size());
+  }
+  return res;
+}
+
 std::ostream &Uptane::operator<<(std::ostream &os, const HardwareIdentifier &hwid) {
-  os << hwid.hwid_;
+  os << *hwid.hwid_;
   return os;
 }
 
@@ -86,43 +111,61 @@ Target::Target(std::string filename, const Json::Value &content) : filename_(std
   if (content.isMember("custom")) {
     updateCustom(content["custom"]);
   }
+  init(content);
+}
+
+Target::Target(std::string filename, Json::Value &&content) : filename_(std::move(filename)) {
+  if (content.isMember("custom")) {
+    updateCustom(std::move(content["custom"]));
+  }
+  init(content);
+}
 
+void Target::init(const Json::Value &content) {
   length_ = content["length"].asUInt64();
 
-  const Json::Value hashes = content["hashes"];
+  const Json::Value &hashes = content["hashes"];
+  hashes_.reserve(hashes.size());
   for (auto i = hashes.begin(); i != hashes.end(); ++i) {
     Hash h(i.key().asString(), (*i).asString());
     if (h.HaveAlgorithm()) {
-      hashes_.push_back(h);
+      hashes_.push_back(std::move(h));
     }
   }
   // sort hashes so that higher priority hash algorithm goes first
   std::sort(hashes_.begin(), hashes_.end(), [](const Hash &l, const Hash &r) { return l.type() < r.type(); });
 }
 
-void Target::updateCustom(const Json::Value &custom) {
-  custom_ = custom;
+const Json::Value &Target::custom_data() const {
+  static const Json::Value null_custom;
+  return custom_ ? *custom_ : null_custom;
+}
+
+void Target::updateCustom(Json::Value &&custom) {
+  auto shared_custom = std::make_shared<const Json::Value>(std::move(custom));
+  custom_ = shared_custom;
+  const Json::Value &c = *shared_custom;
 
   // Image repo provides an array of hardware IDs.
-  if (custom_.isMember("hardwareIds")) {
-    Json::Value hwids = custom_["hardwareIds"];
+  if (c.isMember("hardwareIds")) {
+    const Json::Value &hwids = c["hardwareIds"];
     for (auto i = hwids.begin(); i != hwids.end(); ++i) {
       hwids_.emplace_back(HardwareIdentifier((*i).asString()));
     }
   }
 
   // Director provides a map of ECU serials to hardware IDs.
-  Json::Value ecus = custom_["ecuIdentifiers"];
+  const Json::Value &ecus = c["ecuIdentifiers"];
   for (auto i = ecus.begin(); i != ecus.end(); ++i) {
     ecus_.insert({EcuSerial(i.key().asString()), HardwareIdentifier((*i)["hardwareId"].asString())});
   }
 
-  if (custom_.isMember("targetFormat")) {
-    type_ = custom_["targetFormat"].asString();
+  if (c.isMember("targetFormat")) {
+    type_ = c["targetFormat"].asString();
   }
 
-  if (custom_.isMember("uri")) {
-    std::string custom_uri = custom_["uri"].asString();
+  if (c.isMember("uri")) {
+    std::string custom_uri = c["uri"].asString();
     // Ignore this exact URL for backwards compatibility with old defaults that inserted it.
     if (custom_uri != "https://example.com/") {
       uri_ = std::move(custom_uri);
@@ -173,7 +216,7 @@ std::string Target::sha512Hash() const { return hashString(Hash::Type::kSha512);
 
 std::string Target::custom_version() const {
   try {
-    return custom_["version"].asString();
+    return custom_data()["version"].asString();
   } catch (const std::exception &ex) {
     LOG_ERROR << "Unable to parse custom version: " << ex.what();
     return "";
@@ -307,30 +350,97 @@ void Uptane::BaseMeta::init(const Json::Value &json) {
   } catch (const TimeStamp::InvalidTimeStamp &exc) {
     throw Uptane::InvalidMetadata("", "", "invalid timestamp");
   }
+}
+Uptane::BaseMeta::BaseMeta(const Json::Value &json) {
+  init(json);
   original_object_ = json;
 }
-Uptane::BaseMeta::BaseMeta(const Json::Value &json) { init(json); }
 
-Uptane::BaseMeta::BaseMeta(RepositoryType repo, const Role &role, const Json::Value &json,
+Uptane::SignedMeta Uptane::SignedMeta::Consumable(Json::Value &json) {
+  SignedMeta meta(json);
+  meta.consumable_ = &json;
+  return meta;
+}
+
+const std::string &Uptane::SignedMeta::signedCanonical() const {
+  if (!have_signed_canonical_) {
+    signed_canonical_ = Utils::jsonToCanonicalStr(json_["signed"]);
+    have_signed_canonical_ = true;
+  }
+  return signed_canonical_;
+}
+
+// Object members are written in sorted order, so the canonical form of a
+// regular document consists of its signatures followed by its signed portion.
+bool Uptane::SignedMeta::isRegular() const {
+  return json_.isObject() && json_.size() == 2 && json_.isMember("signatures") && json_.isMember("signed");
+}
+
+std::string Uptane::SignedMeta::canonical() const {
+  if (!isRegular()) {
+    return Utils::jsonToCanonicalStr(json_);
+  }
+  return "{\"signatures\":" + Utils::jsonToCanonicalStr(json_["signatures"]) + ",\"signed\":" + signedCanonical() +
+         "}";
+}
+
+Hash Uptane::SignedMeta::canonicalHash(Hash::Type type) const {
+  auto hasher = MultiPartHasher::create(type);
+  if (hasher == nullptr) {
+    throw std::invalid_argument("Unsupported hash type");
+  }
+  const auto update = [&hasher](const std::string &part) {
+    hasher->update(reinterpret_cast<const unsigned char *>(part.data()), part.size());
+  };
+  if (!isRegular()) {
+    update(Utils::jsonToCanonicalStr(json_));
+  } else {
+    update("{\"signatures\":");
+    update(Utils::jsonToCanonicalStr(json_["signatures"]));
+    update(",\"signed\":");
+    update(signedCanonical());
+    update("}");
+  }
+  return hasher->getHash();
+}
+
+Uptane::BaseMeta::BaseMeta(RepositoryType repo, const Role &role, const SignedMeta &meta,
                            const std::shared_ptr<MetaWithKeys> &signer) {
+  const Json::Value &json = meta.json();
   if (!json.isObject() || !json.isMember("signed")) {
     throw Uptane::InvalidMetadata("", "", "invalid metadata json");
   }
 
-  signer->UnpackSignedObject(repo, role, json);
+  signer->UnpackSignedObject(repo, role, meta);
 
   init(json);
+  if (meta.consumable() == nullptr) {
+    original_object_ = json;
+  }
 }
 
-void Uptane::Targets::init(const Json::Value &json) {
+void Uptane::Targets::init(const SignedMeta &meta) {
+  const Json::Value &json = meta.json();
   if (!json.isObject() || json["signed"]["_type"] != "Targets") {
     throw Uptane::InvalidMetadata("", "targets", "invalid targets.json");
   }
 
-  const Json::Value target_list = json["signed"]["targets"];
-  for (auto t_it = target_list.begin(); t_it != target_list.end(); t_it++) {
-    Target t(t_it.key().asString(), *t_it);
-    targets.push_back(t);
+  if (meta.consumable() != nullptr) {
+    // Move every target out of the document as it is converted, so that the
+    // parsed metadata shrinks while the target list grows.
+    Json::Value &target_list = (*meta.consumable())["signed"]["targets"];
+    targets_.reserve(target_list.size());
+    for (auto t_it = target_list.begin(); t_it != target_list.end(); t_it++) {
+      Json::Value content = std::move(*t_it);
+      targets_.emplace_back(t_it.key().asString(), std::move(content));
+    }
+    target_list = Json::Value();
+  } else {
+    const Json::Value &target_list = json["signed"]["targets"];
+    targets_.reserve(target_list.size());
+    for (auto t_it = target_list.begin(); t_it != target_list.end(); t_it++) {
+      targets_.emplace_back(t_it.key().asString(), *t_it);
+    }
   }
 
   if (json["signed"]["delegations"].isObject()) {
@@ -360,14 +470,49 @@ void Uptane::Targets::init(const Json::Value &json) {
   } else {
     correlation_id_ = "";
   }
+
+  buildIndex();
 }
 
-Uptane::Targets::Targets(const Json::Value &json) : MetaWithKeys(json) { init(json); }
+void Uptane::Targets::buildIndex() {
+  index_by_filename_.clear();
+  index_by_hash_.clear();
+  index_by_filename_.reserve(targets_.size());
+  for (size_t i = 0; i < targets_.size(); ++i) {
+    index_by_filename_.emplace(targets_[i].filename(), i);
+    for (const auto &hash : targets_[i].hashes()) {
+      // keep the first target with a given hash
+      index_by_hash_.emplace(hashKey(hash), i);
+    }
+  }
+}
+
+const Uptane::Target *Uptane::Targets::findTarget(const Target &target) const {
+  // Matching targets always have the same filename.
+  const Target *found = nullptr;
+  size_t found_idx = 0;
+  const auto range = index_by_filename_.equal_range(target.filename());
+  for (auto it = range.first; it != range.second; ++it) {
+    // the first match in file order wins, like a linear search would
+    if ((found == nullptr || it->second < found_idx) && targets_[it->second].MatchTarget(target)) {
+      found = &targets_[it->second];
+      found_idx = it->second;
+    }
+  }
+  return found;
+}
 
-Uptane::Targets::Targets(RepositoryType repo, const Role &role, const Json::Value &json,
+const Uptane::Target *Uptane::Targets::findTargetByHash(const Hash &hash) const {
+  const auto it = index_by_hash_.find(hashKey(hash));
+  return it == index_by_hash_.end() ? nullptr : &targets_[it->second];
+}
+
+Uptane::Targets::Targets(const Json::Value &json) : MetaWithKeys(json) { init(SignedMeta(json)); }
+
+Uptane::Targets::Targets(RepositoryType repo, const Role &role, const SignedMeta &meta,
                          const std::shared_ptr<MetaWithKeys> &signer)
-    : MetaWithKeys(repo, role, json, signer), name_(role.ToString()) {
-  init(json);
+    : MetaWithKeys(repo, role, meta, signer), name_(role.ToString()) {
+  init(meta);
 }
 
 void Uptane::TimestampMeta::init(const Json::Value &json) {
@@ -389,10 +534,10 @@ void Uptane::TimestampMeta::init(const Json::Value &json) {
 
 Uptane::TimestampMeta::TimestampMeta(const Json::Value &json) : BaseMeta(json) { init(json); }
 
-Uptane::TimestampMeta::TimestampMeta(RepositoryType repo, const Json::Value &json,
+Uptane::TimestampMeta::TimestampMeta(RepositoryType repo, const SignedMeta &meta,
                                      const std::shared_ptr<MetaWithKeys> &signer)
-    : BaseMeta(repo, Role::Timestamp(), json, signer) {
-  init(json);
+    : BaseMeta(repo, Role::Timestamp(), meta, signer) {
+  init(meta.json());
 }
 
 void Uptane::Snapshot::init(const Json::Value &json) {
@@ -438,9 +583,9 @@ void Uptane::Snapshot::init(const Json::Value &json) {
 
 Uptane::Snapshot::Snapshot(const Json::Value &json) : BaseMeta(json) { init(json); }
 
-Uptane::Snapshot::Snapshot(RepositoryType repo, const Json::Value &json, const std::shared_ptr<MetaWithKeys> &signer)
-    : BaseMeta(repo, Role::Snapshot(), json, signer) {
-  init(json);
+Uptane::Snapshot::Snapshot(RepositoryType repo, const SignedMeta &meta, const std::shared_ptr<MetaWithKeys> &signer)
+    : BaseMeta(repo, Role::Snapshot(), meta, signer) {
+  init(meta.json());
 }
 
 std::vector<Hash> Uptane::Snapshot::role_hashes(const Uptane::Role &role) const {
@@ -135,16 +135,56 @@ class Version {
 
 std::ostream &operator<<(std::ostream &os, const Version &v);
 
+/**
+ * A parsed metadata document ('signatures' and 'signed') along with its
+ * canonical forms. The canonical form of the 'signed' portion is what the
+ * signatures are computed over; the canonical form of the whole document is
+ * what the hashes in the Timestamp and Snapshot metadata are computed over.
+ * Both are computed at most once, and the latter reuses the former, so that
+ * large documents are only serialized once when they are hashed and verified.
+ *
+ * The object only refers to the JSON document, which must outlive it.
+ */
+class SignedMeta {
+ public:
+  explicit SignedMeta(const Json::Value &json) : json_(json) {}
+  // The object would refer to a destroyed document.
+  SignedMeta(Json::Value &&) = delete;
+  /**
+   * Metadata whose contents may be moved out of `json` by the object built
+   * from it, once its signatures have been verified. Large Targets metadata is
+   * built this way so that the parsed document is released while the targets
+   * are created instead of being held alongside them. Only the cached
+   * canonical forms remain valid afterwards.
+   */
+  static SignedMeta Consumable(Json::Value &json);
+  const Json::Value &json() const { return json_; }
+  Json::Value *consumable() const { return consumable_; }
+  const std::string &signedCanonical() const;
+  std::string canonical() const;
+  /** Hash of canonical(), computed without assembling it. */
+  Hash canonicalHash(Hash::Type type) const;
+
+ private:
+  bool isRegular() const;
+
+  const Json::Value &json_;
+  Json::Value *consumable_{nullptr};
+  mutable std::string signed_canonical_;
+  mutable bool have_signed_canonical_{false};
+};
+
 /* Metadata objects */
 class MetaWithKeys;
 class BaseMeta {
  public:
   BaseMeta() = default;
   explicit BaseMeta(const Json::Value &json);
-  BaseMeta(RepositoryType repo, const Role &role, const Json::Value &json, const std::shared_ptr<MetaWithKeys> &signer);
+  BaseMeta(RepositoryType repo, const Role &role, const SignedMeta &meta, const std::shared_ptr<MetaWithKeys> &signer);
   int version() const { return version_; }
   TimeStamp expiry() const { return expiry_; }
   bool isExpired(const TimeStamp &now) const { return expiry_.IsExpiredAt(now); }
+  // Empty for metadata built from SignedMeta::Consumable().
   Json::Value original() const { return original_object_; }
 
   bool operator==(const BaseMeta &rhs) const { return version_ == rhs.version() && expiry_ == rhs.expiry(); }
@@ -171,7 +211,7 @@ class MetaWithKeys : public BaseMeta {
    * @param json - The contents of the 'signed' portion
    */
   MetaWithKeys(const Json::Value &json);
-  MetaWithKeys(RepositoryType repo, const Role &role, const Json::Value &json,
+  MetaWithKeys(RepositoryType repo, const Role &role, const SignedMeta &meta,
                const std::shared_ptr<MetaWithKeys> &signer);
 
   virtual ~MetaWithKeys() = default;
@@ -196,16 +236,33 @@ class MetaWithKeys : public BaseMeta {
    * @param signed_object
    * @return
    */
-  virtual void UnpackSignedObject(RepositoryType repo, const Role &role, const Json::Value &signed_object);
+  virtual void UnpackSignedObject(RepositoryType repo, const Role &role, const SignedMeta &signed_object);
 
   bool operator==(const MetaWithKeys &rhs) const {
     return version_ == rhs.version_ && expiry_ == rhs.expiry_ && keys_ == rhs.keys_ &&
            keys_for_role_ == rhs.keys_for_role_ && thresholds_for_role_ == rhs.thresholds_for_role_;
   }
 
+  /**
+   * A description of the keys and the threshold required to sign the
+   * metadata of a role. Metadata verified against equal policies is equally
+   * trusted.
+   */
+  std::string rolePolicy(const Role &role) const;
+
+  /**
+   * Number of threads the signature verification backend may use to check
+   * the signatures of a single metadata object signed with these keys.
+   * Defaults to 1 (no parallelism). Copies keep it, and a Root verified
+   * against another one takes it over.
+   */
+  void setMaxParallelVerifications(size_t max_parallel) { max_parallel_verifications_ = max_parallel; }
+  size_t maxParallelVerifications() const { return max_parallel_verifications_; }
+
  protected:
   static const int64_t kMinSignatures = 1;
   static const int64_t kMaxSignatures = 1000;
+  size_t max_parallel_verifications_{1};
 
   std::map<KeyId, PublicKey> keys_;
   std::set<std::pair<Role, KeyId>> keys_for_role_;
@@ -243,7 +300,7 @@ class Root : public MetaWithKeys {
    * @param signed_object
    * @return
    */
-  void UnpackSignedObject(RepositoryType repo, const Role &role, const Json::Value &signed_object) override;
+  void UnpackSignedObject(RepositoryType repo, const Role &role, const SignedMeta &signed_object) override;
 
   bool operator==(const Root &rhs) const {
     return version_ == rhs.version_ && expiry_ == rhs.expiry_ && keys_ == rhs.keys_ &&
@@ -271,27 +328,44 @@ static bool MatchTargetVector(const std::vector<Uptane::Target> &v1, const std::
 class Targets : public MetaWithKeys {
  public:
   explicit Targets(const Json::Value &json);
-  Targets(RepositoryType repo, const Role &role, const Json::Value &json, const std::shared_ptr<MetaWithKeys> &signer);
+  Targets(RepositoryType repo, const Role &role, const SignedMeta &meta, const std::shared_ptr<MetaWithKeys> &signer);
   Targets() = default;
   ~Targets() override = default;
 
   bool operator==(const Targets &rhs) const {
-    return version_ == rhs.version() && expiry_ == rhs.expiry() && MatchTargetVector(targets, rhs.targets);
+    return version_ == rhs.version() && expiry_ == rhs.expiry() && MatchTargetVector(targets_, rhs.targets_);
   }
 
   const std::string &correlation_id() const { return correlation_id_; }
 
   void clear() {
-    targets.clear();
+    targets_.clear();
     delegated_role_names_.clear();
     paths_for_role_.clear();
     terminating_role_.clear();
+    index_by_filename_.clear();
+    index_by_hash_.clear();
   }
 
+  /**
+   * Find the target that matches the given one (see Target::MatchTarget),
+   * using an index built when the metadata is parsed.
+   * @return nullptr if there is no matching target.
+   */
+  const Target *findTarget(const Target &target) const;
+  /**
+   * Find a target with the given (SHA-256 or SHA-512) hash.
+   * @return nullptr if there is no such target.
+   */
+  const Target *findTargetByHash(const Hash &hash) const;
+
+  /** The targets, in the order of the metadata. They are only set by parsing. */
+  const std::vector<Uptane::Target> &targets() const { return targets_; }
+
   std::vector<Uptane::Target> getTargets(const Uptane::EcuSerial &ecu_id,
                                          const Uptane::HardwareIdentifier &hw_id) const {
     std::vector<Uptane::Target> result;
-    for (auto it = targets.begin(); it != targets.end(); ++it) {
+    for (auto it = targets_.begin(); it != targets_.end(); ++it) {
       auto found_loc = std::find_if(it->ecus().begin(), it->ecus().end(),
                                     [ecu_id, hw_id](const std::pair<EcuSerial, HardwareIdentifier> &val) {
                                       return ((ecu_id == val.first) && (hw_id == val.second));
@@ -304,22 +378,28 @@ class Targets : public MetaWithKeys {
     return result;
   }
 
-  std::vector<Uptane::Target> targets;
   std::vector<std::string> delegated_role_names_;
   std::map<Role, std::vector<std::string>> paths_for_role_;
   std::map<Role, bool> terminating_role_;
 
  private:
-  void init(const Json::Value &json);
+  void init(const SignedMeta &meta);
+  void buildIndex();
+  static std::string hashKey(const Hash &hash) { return Hash::TypeString(hash.type()) + ":" + hash.HashString(); }
 
   std::string name_;
   std::string correlation_id_;  // custom non-tuf
+
+  std::vector<Uptane::Target> targets_;
+  // Positions in `targets_`, rebuilt whenever it changes
+  std::unordered_multimap<std::string, size_t> index_by_filename_;
+  std::unordered_map<std::string, size_t> index_by_hash_;
 };
 
 class TimestampMeta : public BaseMeta {
  public:
   explicit TimestampMeta(const Json::Value &json);
-  TimestampMeta(RepositoryType repo, const Json::Value &json, const std::shared_ptr<MetaWithKeys> &signer);
+  TimestampMeta(RepositoryType repo, const SignedMeta &meta, const std::shared_ptr<MetaWithKeys> &signer);
   TimestampMeta() = default;
   std::vector<Hash> snapshot_hashes() const { return snapshot_hashes_; };
   int64_t snapshot_size() const { return snapshot_size_; };
@@ -336,7 +416,7 @@ class TimestampMeta : public BaseMeta {
 class Snapshot : public BaseMeta {
  public:
   explicit Snapshot(const Json::Value &json);
-  Snapshot(RepositoryType repo, const Json::Value &json, const std::shared_ptr<MetaWithKeys> &signer);
+  Snapshot(RepositoryType repo, const SignedMeta &meta, const std::shared_ptr<MetaWithKeys> &signer);
   Snapshot() = default;
   std::vector<Hash> role_hashes(const Uptane::Role &role) const;
   int64_t role_size(const Uptane::Role &role) const;
@@ -368,7 +448,7 @@ int extractVersionUntrusted(const std::string &meta);  // returns negative numbe
 namespace std {
 template <>
 struct hash<Uptane::HardwareIdentifier> {
-  size_t operator()(const Uptane::HardwareIdentifier &hwid) const { return std::hash<std::string>()(hwid.hwid_); }
+  size_t operator()(const Uptane::HardwareIdentifier &hwid) const { return std::hash<std::string>()(*hwid.hwid_); }
 };
 
 template <>
@@ -0,0 +1,230 @@
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/algorithm/hex.hpp>
+#include <json/json.h>
+
+#include "logging/logging.h"
+#include "uptane/tuf.h"
+#include "utilities/utils.h"
+
+/*
+ * Benchmarks of the Uptane metadata handling on synthetic Image repo Targets
+ * metadata. Not part of the test suite, run with `make benchmark-tuf` or give
+ * the name of one benchmark to `b_tuf`.
+ */
+
+namespace {
+
+std::string sha256Hex(const std::string& data) { return boost::algorithm::hex(Crypto::sha256digest(data)); }
+
+Json::Value generateTarget(const size_t i) {
+  Json::Value target;
+  target["hashes"]["sha256"] = sha256Hex(std::to_string(i));
+  target["length"] = static_cast<int>(i % 1000);
+  return target;
+}
+
+Json::Value generateImageTargets(const size_t count) {
+  Json::Value json;
+  json["signed"]["_type"] = "Targets";
+  json["signed"]["version"] = 1;
+  json["signed"]["expires"] = "2038-01-19T03:14:06Z";
+  for (size_t i = 0; i < count; ++i) {
+    Json::Value target = generateTarget(i);
+    target["custom"]["hardwareIds"][0] = "fake-test";
+    json["signed"]["targets"]["image-" + std::to_string(i)] = target;
+  }
+  return json;
+}
+
+Uptane::Target generateQueriedTarget(const size_t i) {
+  Json::Value target = generateTarget(i);
+  target["custom"]["ecuIdentifiers"]["serial"]["hardwareId"] = "fake-test";
+  return Uptane::Target("image-" + std::to_string(i), target);
+}
+
+void check(const bool condition, const std::string& what) {
+  if (!condition) {
+    throw std::runtime_error("Check failed: " + what);
+  }
+}
+
+long peakRss() {  // NOLINT(google-runtime-int)
+  struct rusage usage {};
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+template <typename T>
+long long elapsedMs(const T& duration) {  // NOLINT(google-runtime-int)
+  return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+}
+
+template <typename T>
+long long elapsedUs(const T& duration) {  // NOLINT(google-runtime-int)
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+/* Indexed lookups against a linear search, on 10k and 100k targets. */
+void lookup() {
+  for (const size_t count : {10000, 100000}) {
+    auto start = std::chrono::steady_clock::now();
+    const Uptane::Targets targets(generateImageTargets(count));
+    const auto parse_time = std::chrono::steady_clock::now() - start;
+
+    const size_t lookups = 200;
+    std::vector<Uptane::Target> queried;
+    for (size_t i = 0; i < lookups; ++i) {
+      // every other lookup misses, like lookups in delegations do
+      queried.push_back(generateQueriedTarget((i * count) / lookups + (i % 2) * count));
+    }
+
+    size_t linear_found = 0;
+    start = std::chrono::steady_clock::now();
+    for (const auto& target : queried) {
+      const auto it = std::find_if(targets.targets().cbegin(), targets.targets().cend(),
+                                   [&target](const Uptane::Target& t) { return t.MatchTarget(target); });
+      linear_found += it != targets.targets().cend() ? 1 : 0;
+    }
+    const auto linear_time = std::chrono::steady_clock::now() - start;
+
+    size_t indexed_found = 0;
+    start = std::chrono::steady_clock::now();
+    for (const auto& target : queried) {
+      indexed_found += targets.findTarget(target) != nullptr ? 1 : 0;
+    }
+    const auto indexed_time = std::chrono::steady_clock::now() - start;
+
+    check(linear_found == lookups / 2, "half of the lookups find a target");
+    check(indexed_found == linear_found, "the index finds the same targets");
+    std::cout << count << " targets: parsed in " << elapsedMs(parse_time) << " ms, " << lookups << " lookups took "
+              << elapsedUs(linear_time) << " us with a linear search and " << elapsedUs(indexed_time)
+              << " us with the index\n";
+  }
+}
+
+/* Parsing, hashing and unpacking 100k targets once per step against parsing
+ * them once. */
+void pipeline() {
+  Json::Value targets_json = generateImageTargets(100000);
+  targets_json["signatures"][0]["keyid"] = "id";
+  targets_json["signatures"][0]["method"] = "ed25519";
+  targets_json["signatures"][0]["sig"] = "sig";
+  const std::string raw = Utils::jsonToCanonicalStr(targets_json);
+  targets_json = Json::Value();
+
+  auto start = std::chrono::steady_clock::now();
+  std::string single_hash;
+  {
+    const Json::Value json = Utils::parseJSON(raw);
+    const Uptane::SignedMeta meta(json);
+    single_hash = sha256Hex(meta.canonical());
+    sha256Hex(meta.signedCanonical());
+    const Uptane::Targets targets(json);
+    check(targets.targets().size() == 100000, "all targets are parsed");
+  }
+  const auto single_time = std::chrono::steady_clock::now() - start;
+  const auto single_rss = peakRss();
+
+  start = std::chrono::steady_clock::now();
+  std::string multi_hash;
+  {
+    // what hashing, unpacking and parsing the Targets used to do separately
+    multi_hash = sha256Hex(Utils::jsonToCanonicalStr(Utils::parseJSON(raw)));
+    const Json::Value json = Utils::parseJSON(raw);
+    sha256Hex(Utils::jsonToCanonicalStr(json["signed"]));
+    const Uptane::Targets targets(json);
+    check(targets.targets().size() == 100000, "all targets are parsed");
+  }
+  const auto multi_time = std::chrono::steady_clock::now() - start;
+
+  check(single_hash == multi_hash, "both ways give the same hash");
+  std::cout << raw.size() / 1024 << " KiB of Targets metadata processed in " << elapsedMs(single_time)
+            << " ms when parsed once (peak RSS " << single_rss << " KiB) and in " << elapsedMs(multi_time)
+            << " ms when parsed per step (peak RSS " << peakRss() << " KiB)\n";
+}
+
+/* Memory used by 50k Targets and a copy of them. */
+void targetMemory() {
+  const Json::Value targets_json = generateImageTargets(50000);
+  const auto rss_before = peakRss();
+
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<Uptane::Target> targets;
+  targets.reserve(50000);
+  const Json::Value& targets_list = targets_json["signed"]["targets"];
+  for (auto it = targets_list.begin(); it != targets_list.end(); ++it) {
+    targets.emplace_back(it.key().asString(), *it);
+  }
+  const std::vector<Uptane::Target> copy = targets;
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  check(copy.size() == 50000, "all targets are copied");
+
+  std::cout << "50000 Targets created and copied in " << elapsedMs(elapsed) << " ms, peak RSS grew by "
+            << peakRss() - rss_before << " KiB\n";
+}
+
+/* Peak memory used to verify and build 100k Targets from raw metadata
+ * consumed as the targets are built. */
+void consumableMemory() {
+  const std::string raw = Utils::jsonToCanonicalStr(generateImageTargets(100000));
+  const auto rss_before = peakRss();
+
+  const auto start = std::chrono::steady_clock::now();
+  std::shared_ptr<Uptane::Targets> targets;
+  {
+    Json::Value json = Utils::parseJSON(raw);
+    const auto meta = Uptane::SignedMeta::Consumable(json);
+    meta.canonicalHash(Hash::Type::kSha256);
+    auto signer = std::make_shared<Uptane::Root>(Uptane::Root::Policy::kAcceptAll);
+    targets = std::make_shared<Uptane::Targets>(Uptane::RepositoryType::Image(), Uptane::Role::Targets(), meta, signer);
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  check(targets->targets().size() == 100000, "all targets are built");
+
+  std::cout << raw.size() / 1024 << " KiB of Targets metadata verified and built in " << elapsedMs(elapsed)
+            << " ms, peak RSS grew by " << peakRss() - rss_before << " KiB\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  logger_init();
+  logger_set_threshold(boost::log::trivial::warning);
+
+  const std::map<std::string, std::function<void()>> benchmarks{
+      {"lookup", lookup},
+      {"pipeline", pipeline},
+      {"target-memory", targetMemory},
+      {"consumable-memory", consumableMemory},
+  };
+  if (argc != 2 || benchmarks.count(argv[1]) == 0) {
+    std::cerr << "Usage: " << argv[0] << " <benchmark>\nBenchmarks:";
+    for (const auto& b : benchmarks) {
+      std::cerr << " " << b.first;
+    }
+    std::cerr << "\n";
+    return EXIT_FAILURE;
+  }
+
+  try {
+    benchmarks.at(argv[1])();
+  } catch (const std::exception& e) {
+    std::cerr << argv[1] << ": " << e.what() << "\n";
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+// vim: set tabstop=2 shiftwidth=2 expandtab:
@@ -3,6 +3,7 @@
 #include <map>
 #include <vector>
 
+#include <boost/algorithm/hex.hpp>
 #include <json/json.h>
 
 #include "logging/logging.h"
@@ -49,6 +50,99 @@ TEST(Root, RootJsonRsassaPssSha256) {
   EXPECT_NO_THROW(Uptane::Root(Uptane::RepositoryType::Director(), initial_root, root));
 }
 
+/* A Root signed by `count` ED25519 keys, all required. */
+Json::Value generateSignedRoot(const int count) {
+  Json::Value root;
+  root["signed"]["_type"] = "Root";
+  root["signed"]["consistent_snapshot"] = false;
+  root["signed"]["expires"] = "2038-01-19T03:14:06Z";
+  root["signed"]["version"] = 1;
+  root["signed"]["roles"]["root"]["threshold"] = count;
+  std::vector<std::pair<std::string, std::string>> keys;
+  for (int i = 0; i < count; ++i) {
+    std::string public_key;
+    std::string private_key;
+    EXPECT_TRUE(Crypto::generateKeyPair(KeyType::kED25519, &public_key, &private_key));
+    const PublicKey key(public_key, KeyType::kED25519);
+    root["signed"]["keys"][key.KeyId()] = key.ToUptane();
+    root["signed"]["roles"]["root"]["keyids"].append(key.KeyId());
+    keys.emplace_back(key.KeyId(), private_key);
+  }
+  const std::string canonical = Utils::jsonToCanonicalStr(root["signed"]);
+  for (const auto& key : keys) {
+    Json::Value signature;
+    signature["keyid"] = key.first;
+    signature["method"] = "ed25519";
+    signature["sig"] = Utils::toBase64(Crypto::Sign(KeyType::kED25519, nullptr, key.second, canonical));
+    root["signatures"].append(signature);
+  }
+  return root;
+}
+
+/*
+ * Root metadata that needs several signatures gives the same result whether
+ * its signatures are checked one after another or in parallel.
+ */
+TEST(Root, ParallelThreshold) {
+  const Json::Value root = generateSignedRoot(4);
+  Json::Value bad_root = root;
+  bad_root["signatures"][2]["sig"] = root["signatures"][1]["sig"];
+
+  for (const size_t max_parallel : {1, 4}) {
+    Uptane::Root accept_all(Uptane::Root::Policy::kAcceptAll);
+    accept_all.setMaxParallelVerifications(max_parallel);
+    EXPECT_NO_THROW(Uptane::Root(Uptane::RepositoryType::Director(), root, accept_all));
+    EXPECT_THROW(Uptane::Root(Uptane::RepositoryType::Director(), bad_root, accept_all), Uptane::UnmetThreshold);
+  }
+}
+
+class RecordingVerifier : public SignatureVerifier {
+ public:
+  std::vector<bool> verifyBatch(const std::vector<SignatureCheck>& checks, size_t max_threads) const override {
+    batch_sizes.push_back(checks.size());
+    batch_threads.push_back(max_threads);
+    return SignatureVerifier::verifyBatch(checks, max_threads);
+  }
+  mutable std::vector<size_t> batch_sizes;
+  mutable std::vector<size_t> batch_threads;
+};
+
+/* All the signatures of a metadata object are submitted to the verification
+ * backend as one batch. */
+TEST(Root, BatchVerification) {
+  const Json::Value root = generateSignedRoot(4);
+  Json::Value bad_root = root;
+  bad_root["signatures"][3]["sig"] = root["signatures"][0]["sig"];
+
+  auto verifier = std::make_shared<RecordingVerifier>();
+  Crypto::setSignatureVerifier(verifier);
+  Uptane::Root accept_all(Uptane::Root::Policy::kAcceptAll);
+  EXPECT_NO_THROW(Uptane::Root(Uptane::RepositoryType::Director(), root, accept_all));
+  EXPECT_THROW(Uptane::Root(Uptane::RepositoryType::Director(), bad_root, accept_all), Uptane::UnmetThreshold);
+  Crypto::setSignatureVerifier(nullptr);
+
+  // the Root checks its own signatures in both cases
+  EXPECT_EQ(verifier->batch_sizes, (std::vector<size_t>{4, 4}));
+}
+
+/* The thread limit is the one of the signer, and a Root verified against
+ * another one takes it over. */
+TEST(Root, MaxParallelVerifications) {
+  const Json::Value root = generateSignedRoot(2);
+
+  auto verifier = std::make_shared<RecordingVerifier>();
+  Crypto::setSignatureVerifier(verifier);
+  Uptane::Root accept_all(Uptane::Root::Policy::kAcceptAll);
+  accept_all.setMaxParallelVerifications(3);
+  Uptane::Root verified(Uptane::RepositoryType::Director(), root, accept_all);
+  Uptane::Root other(Uptane::Root::Policy::kAcceptAll);
+  Crypto::setSignatureVerifier(nullptr);
+
+  EXPECT_EQ(verifier->batch_threads, (std::vector<size_t>{3}));
+  EXPECT_EQ(verified.maxParallelVerifications(), 3U);
+  EXPECT_EQ(other.maxParallelVerifications(), 1U);
+}
+
 /* Validate TUF roles. */
 TEST(Role, ValidateRoles) {
   Uptane::Role root = Uptane::Role::Root();
@@ -272,6 +366,138 @@ TEST(Target, HashMismatch) {
   EXPECT_FALSE(target2.MatchTarget(target1));
 }
 
+std::string sha256Hex(const std::string& data) { return boost::algorithm::hex(Crypto::sha256digest(data)); }
+
+Json::Value generateImageTargets(const size_t count) {
+  Json::Value json;
+  json["signed"]["_type"] = "Targets";
+  json["signed"]["version"] = 1;
+  json["signed"]["expires"] = "2038-01-19T03:14:06Z";
+  const std::vector<Uptane::HardwareIdentifier> hardwareIds{Uptane::HardwareIdentifier("fake-test")};
+  for (size_t i = 0; i < count; ++i) {
+    const std::string hash = sha256Hex(std::to_string(i));
+    json["signed"]["targets"]["image-" + std::to_string(i)] =
+        generateImageTarget(hash, static_cast<int>(i % 1000), hardwareIds);
+  }
+  return json;
+}
+
+Uptane::Target generateQueriedTarget(const size_t i) {
+  Uptane::EcuMap ecu_map{{Uptane::EcuSerial("serial"), Uptane::HardwareIdentifier("fake-test")}};
+  return Uptane::Target("image-" + std::to_string(i),
+                        generateDirectorTarget(sha256Hex(std::to_string(i)), static_cast<int>(i % 1000),
+                                               ecu_map));
+}
+
+/* Targets are found through the index by target and by hash. */
+TEST(Targets, FindTarget) {
+  const Uptane::Targets targets(generateImageTargets(10));
+
+  const Uptane::Target queried = generateQueriedTarget(7);
+  const Uptane::Target* found = targets.findTarget(queried);
+  ASSERT_NE(found, nullptr);
+  EXPECT_EQ(found->filename(), "image-7");
+  EXPECT_TRUE(found->MatchTarget(queried));
+
+  found = targets.findTargetByHash(Hash(Hash::Type::kSha256, sha256Hex("3")));
+  ASSERT_NE(found, nullptr);
+  EXPECT_EQ(found->filename(), "image-3");
+
+  // same filename, different hash
+  Uptane::EcuMap ecu_map{{Uptane::EcuSerial("serial"), Uptane::HardwareIdentifier("fake-test")}};
+  EXPECT_EQ(targets.findTarget(Uptane::Target("image-7", generateDirectorTarget("hash_bad", 7, ecu_map))), nullptr);
+  EXPECT_EQ(targets.findTarget(generateQueriedTarget(10)), nullptr);
+  EXPECT_EQ(targets.findTargetByHash(Hash(Hash::Type::kSha256, sha256Hex("10"))), nullptr);
+}
+
+/* Copies keep their index, clear() empties it. */
+TEST(Targets, FindTargetCopyAndClear) {
+  Uptane::Targets targets(generateImageTargets(3));
+  const Uptane::Targets copy = targets;
+  targets.clear();
+  EXPECT_EQ(targets.findTarget(generateQueriedTarget(2)), nullptr);
+  EXPECT_EQ(targets.findTargetByHash(Hash(Hash::Type::kSha256, sha256Hex("2"))), nullptr);
+  const Uptane::Target* found = copy.findTarget(generateQueriedTarget(2));
+  ASSERT_NE(found, nullptr);
+  EXPECT_EQ(found, &copy.targets()[2]);
+}
+
+/* The canonical forms match the ones of the generic JSON serialization. */
+TEST(SignedMeta, Canonical) {
+  const Json::Value root = Utils::parseJSONFile("tests/tuf/sample1/root.json");
+  const Uptane::SignedMeta root_meta(root);
+  EXPECT_EQ(root_meta.canonical(), Utils::jsonToCanonicalStr(root));
+  EXPECT_EQ(root_meta.signedCanonical(), Utils::jsonToCanonicalStr(root["signed"]));
+
+  Json::Value targets = generateImageTargets(10);
+  targets["signatures"][0]["keyid"] = "id";
+  targets["signatures"][0]["method"] = "ed25519";
+  targets["signatures"][0]["sig"] = "sig";
+  EXPECT_EQ(Uptane::SignedMeta(targets).canonical(), Utils::jsonToCanonicalStr(targets));
+
+  // unexpected members are serialized as well
+  targets["unsigned"] = "extra";
+  EXPECT_EQ(Uptane::SignedMeta(targets).canonical(), Utils::jsonToCanonicalStr(targets));
+}
+
+/* Targets built from consumable metadata take the targets out of the parsed
+ * document and match the ones built from a copy of it. */
+TEST(Targets, Consumable) {
+  Json::Value targets_json = generateImageTargets(100);
+  const Uptane::Targets expected(targets_json);
+
+  const auto meta = Uptane::SignedMeta::Consumable(targets_json);
+  const std::string canonical = meta.canonical();
+  EXPECT_EQ(meta.canonicalHash(Hash::Type::kSha256).HashString(), sha256Hex(canonical));
+  auto signer = std::make_shared<Uptane::Root>(Uptane::Root::Policy::kAcceptAll);
+  const Uptane::Targets targets(Uptane::RepositoryType::Image(), Uptane::Role::Targets(), meta, signer);
+
+  EXPECT_TRUE(targets == expected);
+  EXPECT_TRUE(targets.original().empty());
+  EXPECT_FALSE(expected.original().empty());
+  EXPECT_TRUE(targets_json["signed"]["targets"].empty());
+  ASSERT_NE(targets.findTarget(generateQueriedTarget(42)), nullptr);
+}
+
+/* Hashes given as hex strings keep their representation, other strings are
+ * kept as they are. */
+TEST(Target, CompactHash) {
+  const Hash h1(Hash::Type::kSha256, "abcdef0123");
+  EXPECT_EQ(h1.HashString(), "ABCDEF0123");
+  EXPECT_EQ(h1, Hash("sha256", "ABCDEF0123"));
+  EXPECT_NE(h1, Hash("sha512", "ABCDEF0123"));
+
+  const Hash h2(Hash::Type::kSha256, "hash_bad");
+  EXPECT_EQ(h2.HashString(), "HASH_BAD");
+  EXPECT_NE(h1, h2);
+
+  const Hash h3(Hash::Type::kSha256, "abc");
+  EXPECT_EQ(h3.HashString(), "ABC");
+
+  EXPECT_EQ(Hash::generate(Hash::Type::kSha256, "data").HashString(), sha256Hex("data"));
+}
+
+/* Copies of a Target share hardware IDs and custom metadata. */
+TEST(Target, SharedData) {
+  const Json::Value targets_json = generateImageTargets(2);
+  const Uptane::Target t1("image-0", targets_json["signed"]["targets"]["image-0"]);
+  const Uptane::Target t2("image-1", targets_json["signed"]["targets"]["image-1"]);
+  ASSERT_EQ(t1.hardwareIds().size(), 1u);
+  EXPECT_EQ(&t1.hardwareIds()[0].ToString(), &t2.hardwareIds()[0].ToString());
+  EXPECT_EQ(t1.hardwareIds()[0], Uptane::HardwareIdentifier("fake-test"));
+
+  const Uptane::Target t3 = t1;  // NOLINT(performance-unnecessary-copy-initialization)
+  EXPECT_EQ(&t1.custom_data(), &t3.custom_data());
+  EXPECT_EQ(t3.custom_data()["hardwareIds"][0].asString(), "fake-test");
+
+  Uptane::Target t4 = t1;
+  Json::Value custom = t4.custom_data();
+  custom["version"] = "42";
+  t4.updateCustom(std::move(custom));
+  EXPECT_EQ(t4.custom_version(), "42");
+  EXPECT_EQ(t1.custom_version(), "");
+}
+
 #ifndef __NO_MAIN__
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <map>
+#include <mutex>
 #include <string>
 
 #include <boost/filesystem.hpp>
@@ -88,6 +90,70 @@ TEST(Delegation, Basic) {
   }
 }
 
+/* Delegations are found the same way when signatures are verified in parallel. */
+TEST(Delegation, ParallelVerification) {
+  for (auto generate_fun : {delegation_basic, delegation_nested}) {
+    TemporaryDirectory temp_dir;
+    auto delegation_path = temp_dir.Path() / "delegation_test";
+    generate_fun(delegation_path, false);
+    auto http = std::make_shared<HttpFakeDelegation>(temp_dir.Path());
+    Config conf = UptaneTestCommon::makeTestConfig(temp_dir, http->tls_server);
+    conf.uptane.verification_max_parallel = 4;
+
+    auto storage = INvStorage::newStorage(conf.storage);
+    UptaneTestCommon::TestAktualizr aktualizr(conf, storage, http);
+
+    aktualizr.Initialize();
+    result::UpdateCheck update_result = aktualizr.CheckUpdates().get();
+    EXPECT_EQ(update_result.status, result::UpdateStatus::kUpdatesAvailable);
+
+    result::Download download_result = aktualizr.Download(update_result.updates).get();
+    EXPECT_EQ(download_result.status, result::DownloadStatus::kSuccess);
+  }
+}
+
+class HttpFakeDelegationCounter : public HttpFakeDelegation {
+ public:
+  HttpFakeDelegationCounter(const boost::filesystem::path& test_dir_in) : HttpFakeDelegation(test_dir_in) {}
+
+  HttpResponse get(const std::string& url, int64_t maxsize) override {
+    if (url.find("/delegations/") != std::string::npos) {
+      std::lock_guard<std::mutex> lock(m);
+      ++delegation_fetches[url];
+    }
+    return HttpFakeDelegation::get(url, maxsize);
+  }
+
+  std::mutex m;
+  std::map<std::string, int> delegation_fetches;
+};
+
+/* Delegations are prefetched concurrently and fetched only once per update check. */
+TEST(Delegation, Prefetch) {
+  for (auto generate_fun : {delegation_basic, delegation_nested}) {
+    TemporaryDirectory temp_dir;
+    auto delegation_path = temp_dir.Path() / "delegation_test";
+    generate_fun(delegation_path, false);
+    auto http = std::make_shared<HttpFakeDelegationCounter>(temp_dir.Path());
+    Config conf = UptaneTestCommon::makeTestConfig(temp_dir, http->tls_server);
+    conf.uptane.delegations_fetch_max_parallel = 4;
+
+    auto storage = INvStorage::newStorage(conf.storage);
+    UptaneTestCommon::TestAktualizr aktualizr(conf, storage, http);
+
+    aktualizr.Initialize();
+    result::UpdateCheck update_result = aktualizr.CheckUpdates().get();
+    EXPECT_EQ(update_result.status, result::UpdateStatus::kUpdatesAvailable);
+    EXPECT_FALSE(http->delegation_fetches.empty());
+    for (const auto& fetches : http->delegation_fetches) {
+      EXPECT_EQ(fetches.second, 1) << fetches.first;
+    }
+
+    result::Download download_result = aktualizr.Download(update_result.updates).get();
+    EXPECT_EQ(download_result.status, result::DownloadStatus::kSuccess);
+  }
+}
+
 TEST(Delegation, RevokeAfterCheckUpdates) {
   for (auto generate_fun : {delegation_basic, delegation_nested}) {
     TemporaryDirectory temp_dir;
@@ -23,9 +23,18 @@ const std::string RepositoryType::DIRECTOR = "director";
 const std::string RepositoryType::IMAGE = "image";
 
 void RepositoryCommon::initRoot(RepositoryType repo_type, const std::string& root_raw) {
+  MetadataMetrics::Measurement measurement(metrics_, type, Role::Root(), MetadataMetrics::Step::kVerify);
   try {
-    root = Root(type, Utils::parseJSON(root_raw));        // initialization and format check
-    root = Root(type, Utils::parseJSON(root_raw), root);  // signature verification against itself
+    const Json::Value root_json = Utils::parseJSON(root_raw);
+    root = Root(type, root_json);  // initialization and format check
+    root.setMaxParallelVerifications(max_parallel_verifications_);
+    const std::string digest = verified_cache_ ? VerifiedMetaCache::digest(root_raw) : std::string();
+    if (!verified_cache_ || !verified_cache_->isVerified(type, Role::Root(), digest, digest)) {
+      root = Root(type, root_json, root);  // signature verification against itself
+    }
+    root_digest_ = digest;
+    markVerified(Role::Root(), digest, root.version());
+    measurement.success(root_raw.size());
   } catch (const std::exception& e) {
     LOG_ERROR << "Loading initial " << repo_type.toString() << " Root metadata failed: " << e.what();
     throw;
@@ -33,6 +42,7 @@ void RepositoryCommon::initRoot(RepositoryType repo_type, const std::string& roo
 }
 
 void RepositoryCommon::verifyRoot(const std::string& root_raw) {
+  MetadataMetrics::Measurement measurement(metrics_, type, Role::Root(), MetadataMetrics::Step::kVerify);
   try {
     int prev_version = rootVersion();
     // 5.4.4.3.2.3. Version N+1 of the Root metadata file MUST have been signed
@@ -49,13 +59,44 @@ void RepositoryCommon::verifyRoot(const std::string& root_raw) {
                 << prev_version + 1;
       throw Uptane::RootRotationError(type.toString());
     }
+    if (verified_cache_) {
+      root_digest_ = VerifiedMetaCache::digest(root_raw);
+      markVerified(Role::Root(), root_digest_, root.version());
+    }
+    measurement.success(root_raw.size());
   } catch (const std::exception& e) {
     LOG_ERROR << "Signature verification for Root metadata failed: " << e.what();
     throw;
   }
 }
 
-void RepositoryCommon::resetRoot() { root = Root(Root::Policy::kAcceptAll); }
+void RepositoryCommon::resetRoot() {
+  root = Root(Root::Policy::kAcceptAll);
+  root.setMaxParallelVerifications(max_parallel_verifications_);
+  root_digest_.clear();
+}
+
+void RepositoryCommon::setMaxParallelVerifications(const size_t max_parallel) {
+  max_parallel_verifications_ = max_parallel;
+  root.setMaxParallelVerifications(max_parallel);
+}
+
+std::shared_ptr<MetaWithKeys> RepositoryCommon::signerFor(const Role& role, const std::string& meta_raw,
+                                                          std::string* meta_digest) const {
+  if (verified_cache_) {
+    *meta_digest = VerifiedMetaCache::digest(meta_raw);
+    if (verified_cache_->isVerified(type, role, root_digest_, *meta_digest)) {
+      return std::make_shared<Root>(Root::Policy::kAcceptAll);
+    }
+  }
+  return std::make_shared<MetaWithKeys>(root);
+}
+
+void RepositoryCommon::markVerified(const Role& role, const std::string& meta_digest, int version) {
+  if (verified_cache_) {
+    verified_cache_->markVerified(type, role, root_digest_, meta_digest, version);
+  }
+}
 
 void RepositoryCommon::updateRoot(INvStorage& storage, const IMetadataFetcher& fetcher,
                                   const RepositoryType repo_type) {
@@ -67,7 +108,9 @@ void RepositoryCommon::updateRoot(INvStorage& storage, const IMetadataFetcher& f
     } else {
       fetcher.fetchRole(&root_raw, kMaxRootSize, repo_type, Role::Root(), Version(1));
       initRoot(repo_type, root_raw);
+      MetadataMetrics::Measurement measurement(metrics_, repo_type, Role::Root(), MetadataMetrics::Step::kStore);
       storage.storeRoot(root_raw, repo_type, Version(1));
+      measurement.success(root_raw.size());
     }
   }
 
@@ -85,8 +128,10 @@ void RepositoryCommon::updateRoot(INvStorage& storage, const IMetadataFetcher& f
 
     // 5.4.4.3.2.5. Set the latest Root metadata file to the new Root metadata
     // file.
+    MetadataMetrics::Measurement measurement(metrics_, repo_type, Role::Root(), MetadataMetrics::Step::kStore);
     storage.storeRoot(root_raw, repo_type, Version(version));
     storage.clearNonRootMeta(repo_type);
+    measurement.success(root_raw.size());
   }
 
   // 5.4.4.3.3. Check that the current (or latest securely attested) time is
@@ -1,7 +1,12 @@
 #ifndef UPTANE_REPOSITORY_H_
 #define UPTANE_REPOSITORY_H_
 
+#include <memory>
+#include <string>
+
 #include "fetcher.h"
+#include "metadatametrics.h"
+#include "verifiedmetacache.h"
 
 class INvStorage;
 
@@ -16,15 +21,35 @@ class RepositoryCommon {
   int rootVersion() { return root.version(); }
   bool rootExpired() { return root.isExpired(TimeStamp::Now()); }
   virtual void updateMeta(INvStorage &storage, const IMetadataFetcher &fetcher) = 0;
+  // Skip the signature verification of metadata that has already been verified (see VerifiedMetaCache).
+  void setVerifiedMetaCache(std::shared_ptr<VerifiedMetaCache> cache) { verified_cache_ = std::move(cache); }
+  // Record the latency and size of the verification and storage of every role.
+  void setMetrics(std::shared_ptr<MetadataMetrics> metrics) { metrics_ = std::move(metrics); }
+  const std::shared_ptr<MetadataMetrics> &metrics() const { return metrics_; }
+  // Number of threads used to check the signatures of a metadata object, and
+  // for the Image repo the sibling delegations of a Targets role.
+  void setMaxParallelVerifications(size_t max_parallel);
+  size_t maxParallelVerifications() const { return max_parallel_verifications_; }
 
  protected:
   void resetRoot();
   void updateRoot(INvStorage &storage, const IMetadataFetcher &fetcher, RepositoryType repo_type);
+  // The current Root, or a signer accepting everything if the metadata has
+  // already been verified against the current Root.
+  std::shared_ptr<MetaWithKeys> signerFor(const Role &role, const std::string &meta_raw,
+                                          std::string *meta_digest) const;
+  void markVerified(const Role &role, const std::string &meta_digest, int version);
 
   static const int64_t kMaxRotations = 1000;
 
   Root root;
   RepositoryType type;
+  std::shared_ptr<MetadataMetrics> metrics_;
+
+ private:
+  std::shared_ptr<VerifiedMetaCache> verified_cache_;
+  std::string root_digest_;
+  size_t max_parallel_verifications_{1};
 };
 }  // namespace Uptane
 
@@ -0,0 +1,91 @@
+#include "verifiedmetacache.h"
+
+#include <boost/algorithm/hex.hpp>
+
+#include "crypto/crypto.h"
+#include "logging/logging.h"
+#include "utilities/utils.h"
+
+namespace Uptane {
+
+VerifiedMetaCache::VerifiedMetaCache(boost::filesystem::path path) : path_(std::move(path)) { load(); }
+
+std::string VerifiedMetaCache::digest(const std::string& meta_raw) {
+  return boost::algorithm::hex(Crypto::sha256digest(meta_raw));
+}
+
+bool VerifiedMetaCache::isVerified(RepositoryType repo, const Role& role, const std::string& root_digest,
+                                   const std::string& meta_digest) const {
+  const auto it = entries_.find(key(repo, role));
+  if (it == entries_.end()) {
+    return false;
+  }
+  const bool verified = it->second.root_digest == root_digest && it->second.meta_digest == meta_digest;
+  if (verified) {
+    LOG_DEBUG << "Signatures of " << repo.toString() << " " << role.ToString() << " metadata version "
+              << it->second.version << " have already been verified";
+  }
+  return verified;
+}
+
+void VerifiedMetaCache::markVerified(RepositoryType repo, const Role& role, const std::string& root_digest,
+                                     const std::string& meta_digest, int version) {
+  Entry& entry = entries_[key(repo, role)];
+  if (entry.root_digest == root_digest && entry.meta_digest == meta_digest) {
+    return;
+  }
+  entry.root_digest = root_digest;
+  entry.meta_digest = meta_digest;
+  entry.version = version;
+  save();
+}
+
+void VerifiedMetaCache::clear() {
+  entries_.clear();
+  if (!path_.empty()) {
+    boost::system::error_code ec;
+    boost::filesystem::remove(path_, ec);
+  }
+}
+
+std::string VerifiedMetaCache::key(RepositoryType repo, const Role& role) {
+  return repo.toString() + "/" + role.ToString();
+}
+
+void VerifiedMetaCache::load() {
+  if (path_.empty() || !boost::filesystem::exists(path_)) {
+    return;
+  }
+  try {
+    const Json::Value json = Utils::parseJSONFile(path_);
+    for (auto it = json.begin(); it != json.end(); ++it) {
+      if (!(*it)["root"].isString() || !(*it)["sha256"].isString() || !(*it)["version"].isInt()) {
+        continue;
+      }
+      entries_[it.key().asString()] = Entry{(*it)["root"].asString(), (*it)["sha256"].asString(),
+                                            (*it)["version"].asInt()};
+    }
+  } catch (const std::exception& ex) {
+    LOG_WARNING << "Ignoring invalid verified metadata cache: " << ex.what();
+    entries_.clear();
+  }
+}
+
+void VerifiedMetaCache::save() const {
+  if (path_.empty()) {
+    return;
+  }
+  Json::Value json(Json::objectValue);
+  for (const auto& entry : entries_) {
+    json[entry.first]["root"] = entry.second.root_digest;
+    json[entry.first]["sha256"] = entry.second.meta_digest;
+    json[entry.first]["version"] = entry.second.version;
+  }
+  try {
+    Utils::writeFile(path_, json);
+  } catch (const std::exception& ex) {
+    LOG_WARNING << "Unable to store the verified metadata cache: " << ex.what();
+  }
+}
+
+}  // namespace Uptane
@@ -0,0 +1,56 @@
+#ifndef AKTUALIZR_UPTANE_VERIFIEDMETACACHE_H
+#define AKTUALIZR_UPTANE_VERIFIEDMETACACHE_H
+
+#include <map>
+#include <string>
+
+#include <boost/filesystem.hpp>
+
+#include "uptane/tuf.h"
+
+namespace Uptane {
+
+/**
+ * Remembers the digests and versions of metadata whose signatures have
+ * already been verified, so that byte-identical metadata (e.g. re-sent by the
+ * Primary after a retry or a reboot) does not have to be verified again.
+ *
+ * Every entry is bound to the digest of the Root metadata that was trusted
+ * when the signatures were checked, so a Root rotation invalidates it. Only
+ * signature verification is skipped: hashes, versions and expiration dates
+ * still have to be checked by the caller.
+ *
+ * If a path is given, the cache is persisted there as JSON and survives
+ * restarts.
+ */
+class VerifiedMetaCache {
+ public:
+  VerifiedMetaCache() = default;
+  explicit VerifiedMetaCache(boost::filesystem::path path);
+
+  static std::string digest(const std::string& meta_raw);
+
+  bool isVerified(RepositoryType repo, const Role& role, const std::string& root_digest,
+                  const std::string& meta_digest) const;
+  void markVerified(RepositoryType repo, const Role& role, const std::string& root_digest,
+                    const std::string& meta_digest, int version);
+  void clear();
+
+ private:
+  struct Entry {
+    std::string root_digest;
+    std::string meta_digest;
+    int version;
+  };
+
+  static std::string key(RepositoryType repo, const Role& role);
+  void load();
+  void save() const;
+
+  const boost::filesystem::path path_;
+  std::map<std::string, Entry> entries_;
+};
+
+}  // namespace Uptane
+
+#endif  // AKTUALIZR_UPTANE_VERIFIEDMETACACHE_H
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include "test_utils.h"
+#include "uptane/verifiedmetacache.h"
+
+/*
+ * Only metadata that was verified against the same Root is reported as
+ * verified.
+ */
+TEST(VerifiedMetaCache, BoundToRoot) {
+  Uptane::VerifiedMetaCache cache;
+  const auto root1 = Uptane::VerifiedMetaCache::digest("root v1");
+  const auto root2 = Uptane::VerifiedMetaCache::digest("root v2");
+  const auto targets = Uptane::VerifiedMetaCache::digest("targets v1");
+
+  EXPECT_FALSE(cache.isVerified(Uptane::RepositoryType::Director(), Uptane::Role::Targets(), root1, targets));
+  cache.markVerified(Uptane::RepositoryType::Director(), Uptane::Role::Targets(), root1, targets, 1);
+  EXPECT_TRUE(cache.isVerified(Uptane::RepositoryType::Director(), Uptane::Role::Targets(), root1, targets));
+  EXPECT_FALSE(cache.isVerified(Uptane::RepositoryType::Director(), Uptane::Role::Targets(), root2, targets));
+  EXPECT_FALSE(cache.isVerified(Uptane::RepositoryType::Image(), Uptane::Role::Targets(), root1, targets));
+  EXPECT_FALSE(cache.isVerified(Uptane::RepositoryType::Director(), Uptane::Role::Targets(), root1,
+                                Uptane::VerifiedMetaCache::digest("targets v2")));
+
+  cache.clear();
+  EXPECT_FALSE(cache.isVerified(Uptane::RepositoryType::Director(), Uptane::Role::Targets(), root1, targets));
+}
+
+/*
+ * A newly verified version of a role replaces the previous one.
+ */
+TEST(VerifiedMetaCache, NewVersion) {
+  Uptane::VerifiedMetaCache cache;
+  const auto root = Uptane::VerifiedMetaCache::digest("root");
+  const auto snapshot1 = Uptane::VerifiedMetaCache::digest("snapshot v1");
+  const auto snapshot2 = Uptane::VerifiedMetaCache::digest("snapshot v2");
+
+  cache.markVerified(Uptane::RepositoryType::Image(), Uptane::Role::Snapshot(), root, snapshot1, 1);
+  cache.markVerified(Uptane::RepositoryType::Image(), Uptane::Role::Snapshot(), root, snapshot2, 2);
+  EXPECT_FALSE(cache.isVerified(Uptane::RepositoryType::Image(), Uptane::Role::Snapshot(), root, snapshot1));
+  EXPECT_TRUE(cache.isVerified(Uptane::RepositoryType::Image(), Uptane::Role::Snapshot(), root, snapshot2));
+}
+
+/*
+ * The cache survives a restart if it is persisted, and an unreadable cache
+ * file is ignored.
+ */
+TEST(VerifiedMetaCache, Persistence) {
+  TemporaryDirectory temp_dir;
+  const auto path = temp_dir / "verified_metadata.json";
+  const auto root = Uptane::VerifiedMetaCache::digest("root");
+  const auto timestamp = Uptane::VerifiedMetaCache::digest("timestamp");
+  {
+    Uptane::VerifiedMetaCache cache(path);
+    cache.markVerified(Uptane::RepositoryType::Image(), Uptane::Role::Timestamp(), root, timestamp, 3);
+  }
+  {
+    Uptane::VerifiedMetaCache cache(path);
+    EXPECT_TRUE(cache.isVerified(Uptane::RepositoryType::Image(), Uptane::Role::Timestamp(), root, timestamp));
+  }
+
+  Utils::writeFile(path, std::string("garbage"));
+  Uptane::VerifiedMetaCache cache(path);
+  EXPECT_FALSE(cache.isVerified(Uptane::RepositoryType::Image(), Uptane::Role::Timestamp(), root, timestamp));
+}
+
+#ifndef __NO_MAIN__
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+#endif
@@ -0,0 +1,38 @@
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+void parallelFor(const size_t count, const size_t max_threads, const std::function<void(size_t)>& f) {
+  std::vector<std::exception_ptr> errors(count);
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    for (size_t i = next++; i < count; i = next++) {
+      try {
+        f(i);
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    }
+  };
+
+  const size_t threads_count = std::min(count, std::max<size_t>(max_threads, 1));
+  std::vector<std::thread> threads;
+  threads.reserve(threads_count > 0 ? threads_count - 1 : 0);
+  for (size_t i = 1; i < threads_count; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  for (const auto& e : errors) {
+    if (e) {
+      std::rethrow_exception(e);
+    }
+  }
+}
@@ -0,0 +1,18 @@
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+#include <cstddef>
+#include <functional>
+
+/**
+ * Call `f(0)` to `f(count - 1)` on up to `max_threads` threads, the calling
+ * thread included, and wait for all the calls to finish. With `max_threads`
+ * lower than 2 the calls are made one after another on the calling thread.
+ *
+ * If some calls throw, the remaining calls are still made and the exception of
+ * the lowest index is rethrown at the end, so that errors are reported the
+ * same way whatever the scheduling of the threads.
+ */
+void parallelFor(size_t count, size_t max_threads, const std::function<void(size_t)>& f);
+
+#endif  // PARALLEL_H_
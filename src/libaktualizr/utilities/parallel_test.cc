@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utilities/parallel.h"
+
+/* Every index is processed exactly once, on no more than max_threads threads. */
+TEST(ParallelFor, AllIndices) {
+  std::vector<int> calls(100, 0);
+  std::mutex m;
+  std::set<std::thread::id> threads;
+  parallelFor(calls.size(), 4, [&](size_t i) {
+    ++calls[i];
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    std::lock_guard<std::mutex> lock(m);
+    threads.insert(std::this_thread::get_id());
+  });
+  for (const auto c : calls) {
+    EXPECT_EQ(c, 1);
+  }
+  EXPECT_GE(threads.size(), 1u);
+  EXPECT_LE(threads.size(), 4u);
+}
+
+/* Without parallelism, calls are made in order on the calling thread. */
+TEST(ParallelFor, Serial) {
+  std::vector<size_t> order;
+  const auto caller = std::this_thread::get_id();
+  parallelFor(5, 1, [&](size_t i) {
+    EXPECT_EQ(std::this_thread::get_id(), caller);
+    order.push_back(i);
+  });
+  EXPECT_EQ(order, (std::vector<size_t>{0, 1, 2, 3, 4}));
+  parallelFor(0, 4, [](size_t) { FAIL(); });
+}
+
+/* The exception of the lowest index is rethrown after all calls are done. */
+TEST(ParallelFor, Exception) {
+  std::atomic<int> calls{0};
+  try {
+    parallelFor(10, 4, [&](size_t i) {
+      ++calls;
+      if (i == 7) {
+        throw std::runtime_error("7");
+      }
+      if (i == 3) {
+        // make the other error likely to be raised first
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        throw std::runtime_error("3");
+      }
+    });
+    FAIL();
+  } catch (const std::runtime_error& e) {
+    EXPECT_EQ(std::string(e.what()), "3");
+  }
+  EXPECT_EQ(calls, 10);
+}
+
+#ifndef __NO_MAIN__
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+#endif
@@ -352,7 +352,7 @@ std::string Utils::jsonToStr(const Json::Value &json) {
 std::string Utils::jsonToCanonicalStr(const Json::Value &json) {
   static Json::StreamWriterBuilder wbuilder = []() {
     Json::StreamWriterBuilder w;
-    wbuilder["indentation"] = "";
+    w["indentation"] = "";
     return w;
   }();
   return Json::writeString(wbuilder, json);
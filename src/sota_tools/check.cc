@@ -1,3 +1,5 @@
+#include <chrono>
+
 #include <curl/curl.h>
 
 #include "authenticate.h"
@@ -23,11 +25,87 @@ static size_t writeString(void *contents, size_t size, size_t nmemb, void *userp
   return size * nmemb;
 }
 
+namespace {
+// Missing objects listed in the report of RunMode::kCheckTree, the others are
+// only counted
+constexpr size_t kMaxReportedMissing = 20;
+}  // namespace
+
+bool CheckTree(TreehubServer &treehub, const OSTreeHash &root, const OstreeObjectType type, const RunMode mode,
+               const int max_curl_requests, const boost::filesystem::path &tree_dir,
+               const CongestionControl congestion_control, TreeCheckStats *stats, PoolStats *pool_stats) {
+  const auto start = std::chrono::steady_clock::now();
+  OSTreeHttpRepo dest_repo(&treehub, tree_dir);
+  OSTreeObject::ptr input_object = dest_repo.GetObject(root, type);
+
+  RequestPool request_pool(treehub, max_curl_requests, mode, congestion_control);
+
+  // Add input object to the queue.
+  request_pool.AddQuery(input_object);
+
+  // Main curl event loop.
+  // request_pool takes care of holding number of outstanding requests below.
+  // OSTreeObject::CurlDone() adds new requests to the pool and stops the pool
+  // on error.
+  do {
+    request_pool.Loop();
+  } while (!request_pool.is_idle() && !request_pool.is_stopped());
+  if (pool_stats != nullptr) {
+    *pool_stats = request_pool.Stats();
+  }
+
+  if (mode != RunMode::kCheckTree) {
+    if (input_object->is_on_server() == PresenceOnServer::kObjectPresent) {
+      LOG_INFO << "Dry run. No objects uploaded.";
+      return true;
+    }
+    LOG_ERROR << "One or more errors while pushing";
+    return false;
+  }
+
+  const TreeCheckStats &found = request_pool.check_stats();
+  const auto count = [&found](const OstreeObjectType object_type) {
+    auto it = found.present.find(object_type);
+    return it == found.present.end() ? 0 : it->second;
+  };
+  int present = 0;
+  for (const auto &type_count : found.present) {
+    present += type_count.second;
+  }
+  const auto elapsed =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  LOG_INFO << "Checked " << present + static_cast<int>(found.missing.size()) << " objects in " << elapsed
+           << " ms: " << count(OstreeObjectType::OSTREE_OBJECT_TYPE_COMMIT) << " commits, "
+           << count(OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_TREE) << " dirtrees, "
+           << count(OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_META) << " dirmeta and "
+           << count(OstreeObjectType::OSTREE_OBJECT_TYPE_FILE) << " file objects present, " << found.missing.size()
+           << " missing";
+  LOG_INFO << "Fetched " << request_pool.fetch_requests_made() << " metadata objects ("
+           << request_pool.fetched_object_size() << " bytes), sent " << request_pool.batch_requests_made()
+           << " batched queries and " << request_pool.head_requests_made() << " HEAD requests";
+
+  if (!found.missing.empty()) {
+    LOG_ERROR << found.missing.size() << " objects are missing on the server:";
+    for (size_t i = 0; i < found.missing.size() && i < kMaxReportedMissing; ++i) {
+      LOG_ERROR << "  " << found.missing[i];
+    }
+    if (found.missing.size() > kMaxReportedMissing) {
+      LOG_ERROR << "  ... and " << found.missing.size() - kMaxReportedMissing << " more";
+    }
+  }
+  if (stats != nullptr) {
+    *stats = found;
+  }
+  return !request_pool.is_stopped() && found.missing.empty();
+}
+
 int CheckRefValid(TreehubServer &treehub, const std::string &ref, RunMode mode, int max_curl_requests,
-                  const boost::filesystem::path &tree_dir) {
+                  const boost::filesystem::path &tree_dir, const CongestionControl congestion_control,
+                  PoolStats *stats) {
   // Check if the ref is present on treehub. The traditional use case is that it
   // should be a commit object, but we allow walking the tree given any OSTree
   // ref.
+  const bool walk_tree = mode == RunMode::kWalkTree || mode == RunMode::kCheckTree;
   CurlEasyWrapper curl;
   if (curl.get() == nullptr) {
     LOG_FATAL << "Error initializing curl";
@@ -48,7 +126,7 @@ int CheckRefValid(TreehubServer &treehub, const std::string &ref, RunMode mode,
   OstreeObjectType type = OstreeObjectType::OSTREE_OBJECT_TYPE_COMMIT;
   curl_easy_getinfo(curl.get(), CURLINFO_RESPONSE_CODE, &http_code);
   if (http_code == 404) {
-    if (mode != RunMode::kWalkTree) {
+    if (!walk_tree) {
       LOG_FATAL << "OSTree commit " << ref << " is missing in treehub";
       return EXIT_FAILURE;
     } else {
@@ -58,33 +136,17 @@ int CheckRefValid(TreehubServer &treehub, const std::string &ref, RunMode mode,
     LOG_FATAL << "Error " << http_code << " getting OSTree ref " << ref << " from treehub";
     return EXIT_FAILURE;
   }
-  if (mode != RunMode::kWalkTree) {
+  if (!walk_tree) {
     LOG_INFO << "OSTree commit " << ref << " is found on treehub";
   }
 
-  if (mode == RunMode::kWalkTree) {
+  if (walk_tree) {
     // Walk the entire tree and check for all objects.
-    OSTreeHttpRepo dest_repo(&treehub, tree_dir);
-    OSTreeHash hash = OSTreeHash::Parse(ref);
-    OSTreeObject::ptr input_object = dest_repo.GetObject(hash, type);
-
-    RequestPool request_pool(treehub, max_curl_requests, mode);
-
-    // Add input object to the queue.
-    request_pool.AddQuery(input_object);
-
-    // Main curl event loop.
-    // request_pool takes care of holding number of outstanding requests below.
-    // OSTreeObject::CurlDone() adds new requests to the pool and stops the pool
-    // on error.
-    do {
-      request_pool.Loop();
-    } while (!request_pool.is_idle() && !request_pool.is_stopped());
-
-    if (input_object->is_on_server() == PresenceOnServer::kObjectPresent) {
-      LOG_INFO << "Dry run. No objects uploaded.";
-    } else {
-      LOG_ERROR << "One or more errors while pushing";
+    const bool tree_ok = CheckTree(treehub, OSTreeHash::Parse(ref), type, mode, max_curl_requests, tree_dir,
+                                   congestion_control, nullptr, stats);
+    if (!tree_ok && mode == RunMode::kCheckTree) {
+      LOG_FATAL << "OSTree ref " << ref << " is incomplete on treehub";
+      return EXIT_FAILURE;
     }
   }
 
@@ -4,14 +4,32 @@
 #include <string>
 
 #include "garage_common.h"
+#include "ostree_hash.h"
 #include "ostree_ref.h"
 #include "ostree_repo.h"
+#include "pool_stats.h"
+#include "rate_controller.h"
+#include "request_pool.h"
 #include "server_credentials.h"
 
 /**
- * Check if the ref is present on the server and in targets.json
+ * Check if the ref is present on the server and in targets.json. When the tree
+ * is walked, `stats` is set to the work done by the request pool.
  */
 int CheckRefValid(TreehubServer& treehub, const std::string& ref, RunMode mode, int max_curl_requests,
-                  const boost::filesystem::path& tree_dir = "");
+                  const boost::filesystem::path& tree_dir = "",
+                  CongestionControl congestion_control = CongestionControl::kAimd, PoolStats* stats = nullptr);
+
+/**
+ * Walk the tree of `root` on the server in RunMode::kWalkTree or
+ * RunMode::kCheckTree, keeping the fetched metadata objects in `tree_dir`.
+ * In RunMode::kCheckTree, log a report of the objects found and fill `stats`
+ * if it is given. `pool_stats` is set to the work done by the request pool.
+ * Returns false if an object is missing or the walk failed.
+ */
+bool CheckTree(TreehubServer& treehub, const OSTreeHash& root, OstreeObjectType type, RunMode mode,
+               int max_curl_requests, const boost::filesystem::path& tree_dir = "",
+               CongestionControl congestion_control = CongestionControl::kAimd, TreeCheckStats* stats = nullptr,
+               PoolStats* pool_stats = nullptr);
 
 #endif
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <boost/process.hpp>
+
+#include "authenticate.h"
+#include "check.h"
+#include "garage_common.h"
+#include "test_utils.h"
+
+namespace {
+
+std::string port = "2443";
+TemporaryDirectory temp_dir;
+
+const OSTreeHash kCommit = OSTreeHash::Parse("16ef2f2629dc9263fdf3c0f032563a2d757623bbc11cf99df25c3c3f258dccbe");
+const std::string kDirtree = "3c/064a2f3853b9158b82184311eca9d9d55fcd4788243546fbd98358763ef6fc.dirtree";
+const std::string kFile = "a1/f4f81612ce959883f58e83789f6c7d97b0b55b801b2a09955235f40b0f2dfb.filez";
+
+/* The objects served by the fake Treehub. */
+boost::filesystem::path ServerObjects() { return temp_dir.Path() / "objects"; }
+
+void ResetServerObjects() {
+  boost::filesystem::remove_all(ServerObjects());
+  Utils::copyDir("tests/sota_tools/repo/objects", ServerObjects());
+}
+
+bool Check(const boost::filesystem::path &tree_dir, TreeCheckStats *stats) {
+  auto server_creds = ServerCredentials(temp_dir.Path() / "auth.json");
+  TreehubServer treehub;
+  EXPECT_EQ(authenticate("tests/fake_http_server/server.crt", server_creds, treehub), EXIT_SUCCESS);
+  return CheckTree(treehub, kCommit, OstreeObjectType::OSTREE_OBJECT_TYPE_COMMIT, RunMode::kCheckTree, 2, tree_dir,
+                   CongestionControl::kAimd, stats);
+}
+
+}  // namespace
+
+/* Every object of a complete tree is found and counted. */
+TEST(CheckTree, Complete) {
+  ResetServerObjects();
+  TemporaryDirectory tree_dir;
+  TreeCheckStats stats;
+  EXPECT_TRUE(Check(tree_dir.Path(), &stats));
+  EXPECT_TRUE(stats.missing.empty());
+  EXPECT_EQ(stats.present[OstreeObjectType::OSTREE_OBJECT_TYPE_COMMIT], 1);
+  EXPECT_EQ(stats.present[OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_TREE], 1);
+  EXPECT_EQ(stats.present[OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_META], 1);
+  EXPECT_EQ(stats.present[OstreeObjectType::OSTREE_OBJECT_TYPE_FILE], 1);
+  // The metadata is kept in the tree directory.
+  EXPECT_TRUE(boost::filesystem::is_regular_file(tree_dir.Path() / "objects" / kDirtree));
+}
+
+/* Missing objects are reported, whether they are fetched or queried. */
+TEST(CheckTree, Missing) {
+  ResetServerObjects();
+  boost::filesystem::remove(ServerObjects() / kFile);
+  TreeCheckStats stats;
+  {
+    TemporaryDirectory tree_dir;
+    EXPECT_FALSE(Check(tree_dir.Path(), &stats));
+    ASSERT_EQ(stats.missing.size(), 1u);
+    EXPECT_EQ(stats.missing[0], kFile);
+  }
+
+  boost::filesystem::remove(ServerObjects() / kDirtree);
+  {
+    TemporaryDirectory tree_dir;
+    EXPECT_FALSE(Check(tree_dir.Path(), &stats));
+    ASSERT_EQ(stats.missing.size(), 1u);
+    EXPECT_EQ(stats.missing[0], kDirtree);
+    EXPECT_EQ(stats.present[OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_META], 1);
+  }
+}
+
+/* A corrupt dirtree in the tree directory is fetched again. */
+TEST(CheckTree, CorruptCache) {
+  ResetServerObjects();
+  TemporaryDirectory tree_dir;
+  Utils::writeFile(tree_dir.Path() / "objects" / kDirtree, std::string("garbage"));
+  TreeCheckStats stats;
+  EXPECT_TRUE(Check(tree_dir.Path(), &stats));
+  EXPECT_EQ(stats.present[OstreeObjectType::OSTREE_OBJECT_TYPE_FILE], 1);
+  EXPECT_EQ(Utils::readFile(tree_dir.Path() / "objects" / kDirtree),
+            Utils::readFile("tests/sota_tools/repo/objects/" + kDirtree));
+}
+
+#ifndef __NO_MAIN__
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  port = TestUtils::getFreePort();
+  std::string server = "tests/sota_tools/treehub_server.py";
+  Json::Value auth;
+  auth["ostree"]["server"] = std::string("https://localhost:") + port;
+  Utils::writeFile(temp_dir.Path() / "auth.json", auth);
+
+  boost::process::child server_process(server, std::string("-p"), port, std::string("-d"), temp_dir.PathString(),
+                                       std::string("--tls"));
+  TestUtils::waitForServer("https://localhost:" + port + "/");
+  return RUN_ALL_TESTS();
+}
+#endif
+
+// vim: set tabstop=2 shiftwidth=2 expandtab:
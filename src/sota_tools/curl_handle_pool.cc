@@ -0,0 +1,37 @@
+#include "curl_handle_pool.h"
+
+#include <stdexcept>
+
+CurlHandlePool::~CurlHandlePool() { Clear(); }
+
+CURL* CurlHandlePool::Acquire() {
+  if (!idle_.empty()) {
+    CURL* handle = idle_.back();
+    idle_.pop_back();
+    // Forget the options of the previous request.
+    curl_easy_reset(handle);
+    handles_reused_++;
+    return handle;
+  }
+  CURL* handle = curl_easy_init();
+  if (handle == nullptr) {
+    throw std::runtime_error("Could not initialize curl handle");
+  }
+  handles_created_++;
+  return handle;
+}
+
+void CurlHandlePool::Release(CURL* handle) {
+  if (handle != nullptr) {
+    idle_.push_back(handle);
+  }
+}
+
+void CurlHandlePool::Clear() {
+  for (CURL* handle : idle_) {
+    curl_easy_cleanup(handle);
+  }
+  idle_.clear();
+}
+
+// vim: set tabstop=2 shiftwidth=2 expandtab:
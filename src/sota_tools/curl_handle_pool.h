@@ -0,0 +1,41 @@
+#ifndef SOTA_CLIENT_TOOLS_CURL_HANDLE_POOL_H_
+#define SOTA_CLIENT_TOOLS_CURL_HANDLE_POOL_H_
+
+#include <vector>
+
+#include <curl/curl.h>
+
+/**
+ * Keeps finished curl easy handles around for the next request, so that a
+ * RequestPool does not create and destroy an easy handle for every HEAD, PUT
+ * or fetch. Connections and DNS lookups are cached by the multi handle the
+ * easy handles are added to.
+ */
+class CurlHandlePool {
+ public:
+  CurlHandlePool() = default;
+  CurlHandlePool(const CurlHandlePool&) = delete;
+  CurlHandlePool& operator=(const CurlHandlePool&) = delete;
+  ~CurlHandlePool();
+
+  /* Get a handle with all options at their defaults. Throws if curl cannot
+   * create one. */
+  CURL* Acquire();
+
+  /* Give back a handle that is no longer attached to a multi handle. */
+  void Release(CURL* handle);
+
+  /* Clean up the idle handles. */
+  void Clear();
+
+  int handles_created() const { return handles_created_; }
+  int handles_reused() const { return handles_reused_; }
+
+ private:
+  std::vector<CURL*> idle_;
+  int handles_created_{0};
+  int handles_reused_{0};
+};
+
+// vim: set tabstop=2 shiftwidth=2 expandtab:
+#endif  // SOTA_CLIENT_TOOLS_CURL_HANDLE_POOL_H_
@@ -5,6 +5,7 @@
 
 #include "authenticate.h"
 #include "logging/logging.h"
+#include "object_graph.h"
 #include "ostree_object.h"
 #include "rate_controller.h"
 #include "request_pool.h"
@@ -15,6 +16,7 @@ bool CheckPoolState(const OSTreeObject::ptr &root_object, const RequestPool &req
   switch (request_pool.run_mode()) {
     case RunMode::kWalkTree:
     case RunMode::kPushTree:
+    case RunMode::kCheckTree:
       return !request_pool.is_stopped() && !request_pool.is_idle();
     case RunMode::kDefault:
     case RunMode::kDryRun:
@@ -24,9 +26,19 @@ bool CheckPoolState(const OSTreeObject::ptr &root_object, const RequestPool &req
 }
 
 bool UploadToTreehub(const OSTreeRepo::ptr &src_repo, TreehubServer &push_server, const OSTreeHash &ostree_commit,
-                     const RunMode mode, const int max_curl_requests) {
+                     const RunMode mode, const int max_curl_requests,
+                     const std::shared_ptr<PushStateCache> &push_cache, const CongestionControl congestion_control,
+                     const int parse_jobs, const bool bulk_upload, PoolStats *stats) {
   assert(max_curl_requests > 0);
 
+  // Walking the tree is meant to check every object, so the cache is only
+  // relied upon in the default mode. Only the commit is always queried:
+  // another object removed from the server since it was confirmed is not
+  // pushed again until its entry expires.
+  if (push_cache != nullptr && mode == RunMode::kDefault) {
+    src_repo->SetPushStateCache(push_cache);
+  }
+
   OSTreeObject::ptr root_object;
   try {
     root_object = src_repo->GetObject(ostree_commit, OstreeObjectType::OSTREE_OBJECT_TYPE_COMMIT);
@@ -35,7 +47,15 @@ bool UploadToTreehub(const OSTreeRepo::ptr &src_repo, TreehubServer &push_server
     return false;
   }
 
-  RequestPool request_pool(push_server, max_curl_requests, mode);
+  std::shared_ptr<ObjectGraph> object_graph;
+  if (parse_jobs > 0 && !src_repo->FetchesOnDemand()) {
+    object_graph = std::make_shared<ObjectGraph>(src_repo->root() / "objects", parse_jobs);
+    object_graph->Start(ostree_commit);
+    src_repo->SetObjectGraph(object_graph);
+  }
+
+  RequestPool request_pool(push_server, max_curl_requests, mode, congestion_control);
+  request_pool.bulk_uploads(bulk_upload);
 
   // Add commit object to the queue.
   request_pool.AddQuery(root_object);
@@ -47,12 +67,34 @@ bool UploadToTreehub(const OSTreeRepo::ptr &src_repo, TreehubServer &push_server
   do {
     request_pool.Loop();
   } while (CheckPoolState(root_object, request_pool));
+  if (stats != nullptr) {
+    *stats = request_pool.Stats();
+  }
+
+  if (object_graph != nullptr) {
+    src_repo->SetObjectGraph(nullptr);
+    object_graph->Stop();
+    LOG_DEBUG << "Parsed " << object_graph->parsed_objects() << " directory trees ahead of the requests";
+  }
+
+  if (push_cache != nullptr && (mode == RunMode::kDefault || mode == RunMode::kPushTree)) {
+    push_cache->Confirmed(src_repo->ObjectsOnServer());
+    push_cache->Save();
+  }
 
   if (root_object->is_on_server() == PresenceOnServer::kObjectPresent) {
     if (mode == RunMode::kDefault || mode == RunMode::kPushTree) {
-      LOG_INFO << "Upload to Treehub complete after " << request_pool.head_requests_made() << " HEAD requests and "
-               << request_pool.put_requests_made() << " PUT requests.";
+      LOG_INFO << "Upload to Treehub complete after " << request_pool.head_requests_made() << " HEAD requests, "
+               << request_pool.batch_requests_made() << " batched queries and " << request_pool.put_requests_made()
+               << " PUT requests.";
+      if (request_pool.bulk_requests_made() > 0) {
+        LOG_INFO << request_pool.bulk_objects_sent() << " objects were uploaded in "
+                 << request_pool.bulk_requests_made() << " bulk uploads.";
+      }
       LOG_INFO << "Total size of uploaded objects: " << request_pool.total_object_size() << " bytes.";
+      if (request_pool.fetch_requests_made() > 0) {
+        LOG_INFO << "Fetched " << request_pool.fetch_requests_made() << " objects from the source repository.";
+      }
     } else {
       LOG_INFO << "Dry run. No objects uploaded.";
     }
@@ -1,11 +1,15 @@
 #ifndef SOTA_CLIENT_TOOLS_DEPLOY_H_
 #define SOTA_CLIENT_TOOLS_DEPLOY_H_
 
+#include <memory>
 #include <string>
 
 #include "garage_common.h"
 #include "ostree_ref.h"
 #include "ostree_repo.h"
+#include "pool_stats.h"
+#include "push_state_cache.h"
+#include "rate_controller.h"
 #include "server_credentials.h"
 
 /*
@@ -25,9 +29,25 @@ bool CheckPoolState(const OSTreeObject::ptr& root_object, const RequestPool& req
  * \param ostree_commit
  * \param mode
  * \param max_curl_requests
+ * \param push_cache Optional record of the objects already on push_server.
+ *                   In the default mode, cached objects are not checked
+ *                   again, even if they have been removed from the server
+ *                   since. In the default and push-tree modes, the objects
+ *                   confirmed by the server are added to it and it is saved.
+ * \param congestion_control Algorithm adjusting the number of parallel
+ *                           requests up to max_curl_requests.
+ * \param parse_jobs Number of threads parsing the directory trees of src_repo
+ *                   ahead of the requests. With 0, or if src_repo fetches its
+ *                   objects on demand, they are parsed by the request loop.
+ * \param bulk_upload Upload small objects in archives of several objects, if
+ *                    the server supports it.
+ * \param stats Optional, set to the work done by the request pool.
  */
 bool UploadToTreehub(const OSTreeRepo::ptr& src_repo, TreehubServer& push_server, const OSTreeHash& ostree_commit,
-                     RunMode mode, int max_curl_requests);
+                     RunMode mode, int max_curl_requests,
+                     const std::shared_ptr<PushStateCache>& push_cache = nullptr,
+                     CongestionControl congestion_control = CongestionControl::kAimd, int parse_jobs = 0,
+                     bool bulk_upload = false, PoolStats* stats = nullptr);
 
 /**
  * Use the garage-sign tool and the Image repo targets.json keys in credentials.zip
@@ -9,6 +9,7 @@
 #include "ostree_dir_repo.h"
 #include "ostree_http_repo.h"
 #include "ostree_ref.h"
+#include "push_state_cache.h"
 #include "test_utils.h"
 
 std::string port = "2443";
@@ -43,6 +44,93 @@ TEST(deploy, UploadToTreehub) {
   EXPECT_EQ(result, 0) << "Diff between the source repo refs and the destination repos refs is nonzero.";
 }
 
+/* Walk the whole tree again, with the directory trees parsed on worker
+ * threads. Every object is already on the server. */
+TEST(deploy, UploadToTreehubObjectGraph) {
+  OSTreeRepo::ptr src_repo = std::make_shared<OSTreeDirRepo>("tests/sota_tools/repo");
+  auto server_creds = ServerCredentials(temp_dir.Path() / "auth.json");
+  TreehubServer push_server;
+  EXPECT_EQ(authenticate("tests/fake_http_server/server.crt", server_creds, push_server), EXIT_SUCCESS);
+  EXPECT_TRUE(UploadToTreehub(src_repo, push_server, src_repo->GetRef("master").GetHash(), RunMode::kPushTree, 2,
+                              nullptr, CongestionControl::kAimd, 2));
+  EXPECT_EQ(src_repo->object_graph(), nullptr);
+
+  int result = system(
+      (std::string("diff -r ") + (temp_dir.Path() / "objects/").string() + " tests/sota_tools/repo/objects/").c_str());
+  EXPECT_EQ(result, 0) << "Diff between the source repo objects and the destination repo objects is nonzero.";
+}
+
+/* Small objects are uploaded in archives when bulk uploads are enabled. */
+TEST(deploy, UploadToTreehubBulk) {
+  boost::filesystem::remove_all(temp_dir.Path() / "objects");
+  OSTreeRepo::ptr src_repo = std::make_shared<OSTreeDirRepo>("tests/sota_tools/repo");
+  auto server_creds = ServerCredentials(temp_dir.Path() / "auth.json");
+  TreehubServer push_server;
+  EXPECT_EQ(authenticate("tests/fake_http_server/server.crt", server_creds, push_server), EXIT_SUCCESS);
+  PoolStats stats;
+  EXPECT_TRUE(UploadToTreehub(src_repo, push_server, src_repo->GetRef("master").GetHash(), RunMode::kDefault, 2,
+                              nullptr, CongestionControl::kAimd, 0, true, &stats));
+  EXPECT_EQ(stats.objects_uploaded, 4);
+  EXPECT_GE(stats.bulk_requests, 1);
+  EXPECT_EQ(stats.failed_requests, 0);
+
+  int result = system(
+      (std::string("diff -r ") + (temp_dir.Path() / "objects/").string() + " tests/sota_tools/repo/objects/").c_str());
+  EXPECT_EQ(result, 0) << "Diff between the source repo objects and the destination repo objects is nonzero.";
+}
+
+/* A server without bulk uploads refuses the archive; every object is then
+ * uploaded on its own. */
+TEST(deploy, UploadToTreehubBulkUnsupported) {
+  TemporaryDirectory server_dir;
+  const std::string server_port = TestUtils::getFreePort();
+  Json::Value auth;
+  auth["ostree"]["server"] = std::string("https://localhost:") + server_port;
+  Utils::writeFile(server_dir.Path() / "auth.json", auth);
+  boost::process::child server_process("tests/sota_tools/treehub_server.py", std::string("-p"), server_port,
+                                       std::string("-d"), server_dir.PathString(), std::string("--tls"),
+                                       std::string("--no-bulk-upload"));
+  TestUtils::waitForServer("https://localhost:" + server_port + "/");
+
+  OSTreeRepo::ptr src_repo = std::make_shared<OSTreeDirRepo>("tests/sota_tools/repo");
+  auto server_creds = ServerCredentials(server_dir.Path() / "auth.json");
+  TreehubServer push_server;
+  EXPECT_EQ(authenticate("tests/fake_http_server/server.crt", server_creds, push_server), EXIT_SUCCESS);
+  PoolStats stats;
+  EXPECT_TRUE(UploadToTreehub(src_repo, push_server, src_repo->GetRef("master").GetHash(), RunMode::kDefault, 2,
+                              nullptr, CongestionControl::kAimd, 0, true, &stats));
+  EXPECT_GE(stats.bulk_requests, 1);
+  EXPECT_EQ(stats.objects_uploaded, 4);
+
+  const std::string server_objects = (server_dir.Path() / "objects/").string();
+  int result = system((std::string("diff -r ") + server_objects + " tests/sota_tools/repo/objects/").c_str());
+  EXPECT_EQ(result, 0) << "Diff between the source repo objects and the destination repo objects is nonzero.";
+}
+
+/* The commit is queried even if the push cache knows it, so a commit removed
+ * from the server is pushed again. */
+TEST(deploy, UploadToTreehubPushCacheCommit) {
+  TemporaryDirectory repo_dir;
+  const boost::filesystem::path repo_path = repo_dir.Path() / "repo";
+  Utils::copyDir("tests/sota_tools/repo", repo_path);
+  auto server_creds = ServerCredentials(temp_dir.Path() / "auth.json");
+  TreehubServer push_server;
+  EXPECT_EQ(authenticate("tests/fake_http_server/server.crt", server_creds, push_server), EXIT_SUCCESS);
+  auto push_cache = std::make_shared<PushStateCache>(repo_path, push_server.root_url(), std::chrono::hours(1));
+  const boost::filesystem::path server_commit =
+      temp_dir.Path() / "objects/16/ef2f2629dc9263fdf3c0f032563a2d757623bbc11cf99df25c3c3f258dccbe.commit";
+
+  OSTreeRepo::ptr src_repo = std::make_shared<OSTreeDirRepo>(repo_path);
+  const OSTreeHash commit = src_repo->GetRef("master").GetHash();
+  EXPECT_TRUE(UploadToTreehub(src_repo, push_server, commit, RunMode::kDefault, 2, push_cache));
+  EXPECT_GT(push_cache->size(), 0u);
+
+  boost::filesystem::remove(server_commit);
+  src_repo = std::make_shared<OSTreeDirRepo>(repo_path);
+  EXPECT_TRUE(UploadToTreehub(src_repo, push_server, commit, RunMode::kDefault, 2, push_cache));
+  EXPECT_TRUE(boost::filesystem::is_regular_file(server_commit));
+}
+
 #ifndef __NO_MAIN__
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
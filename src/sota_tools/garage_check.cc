@@ -25,6 +25,8 @@ int main(int argc, char **argv) {
   boost::filesystem::path credentials_path;
   std::string cacerts;
   int max_curl_requests;
+  std::string congestion_control_name;
+  boost::filesystem::path stats_path;
   RunMode mode = RunMode::kDefault;
   boost::filesystem::path tree_dir;
   po::options_description desc("garage-check command line options");
@@ -38,9 +40,12 @@ int main(int argc, char **argv) {
     ("ref,r", po::value<std::string>(&ref)->required(), "refhash to check")
     ("credentials,j", po::value<boost::filesystem::path>(&credentials_path)->required(), "credentials (json or zip containing json)")
     ("cacert", po::value<std::string>(&cacerts), "override path to CA root certificates, in the same format as curl --cacert")
-    ("jobs", po::value<int>(&max_curl_requests)->default_value(30), "maximum number of parallel requests (only relevant with --walk-tree)")
+    ("jobs", po::value<int>(&max_curl_requests)->default_value(30), "maximum number of parallel requests (only relevant with --walk-tree or --fast)")
+    ("congestion-control", po::value<std::string>(&congestion_control_name)->default_value("aimd"), "algorithm adjusting the number of parallel requests: aimd or latency (only relevant with --walk-tree or --fast)")
     ("walk-tree,w", "walk entire tree and check presence of all objects")
-    ("tree-dir,t", po::value<boost::filesystem::path>(&tree_dir), "directory to which to write the tree (only used with --walk-tree)");
+    ("fast", "walk entire tree, fetching directory trees without querying them first, and report all missing objects")
+    ("stats-json", po::value<boost::filesystem::path>(&stats_path), "write a JSON summary of the requests, throughput and errors of the walk to this file (only used with --walk-tree or --fast)")
+    ("tree-dir,t", po::value<boost::filesystem::path>(&tree_dir), "directory to which to write the tree, objects already in it are not fetched again (only used with --walk-tree or --fast)");
   // clang-format on
 
   po::variables_map vm;
@@ -80,7 +85,9 @@ int main(int argc, char **argv) {
 
     Utils::setUserAgent(std::string("garage-check/") + garage_tools_version());
 
-    if (vm.count("walk-tree") != 0U) {
+    if (vm.count("fast") != 0U) {
+      mode = RunMode::kCheckTree;
+    } else if (vm.count("walk-tree") != 0U) {
       mode = RunMode::kWalkTree;
     }
 
@@ -88,6 +95,11 @@ int main(int argc, char **argv) {
       LOG_FATAL << "--jobs must be greater than 0";
       return EXIT_FAILURE;
     }
+    CongestionControl congestion_control;
+    if (!ParseCongestionControl(congestion_control_name, &congestion_control)) {
+      LOG_FATAL << "--congestion-control must be aimd or latency";
+      return EXIT_FAILURE;
+    }
 
     TreehubServer treehub;
     if (authenticate(cacerts, ServerCredentials(credentials_path), treehub) != EXIT_SUCCESS) {
@@ -95,7 +107,12 @@ int main(int argc, char **argv) {
       return EXIT_FAILURE;
     }
 
-    if (CheckRefValid(treehub, ref, mode, max_curl_requests, tree_dir) != EXIT_SUCCESS) {
+    PoolStats stats;
+    const int result = CheckRefValid(treehub, ref, mode, max_curl_requests, tree_dir, congestion_control, &stats);
+    if (!stats_path.empty() && mode != RunMode::kDefault) {
+      stats.WriteJson(stats_path, result == EXIT_SUCCESS);
+    }
+    if (result != EXIT_SUCCESS) {
       LOG_FATAL << "Check if the ref is present on the server or in targets.json failed";
       return EXIT_FAILURE;
     }
@@ -14,6 +14,10 @@ enum class RunMode {
   /** Walk the entire tree and upload any missing objects. Do not assume that if
    * an object exists, its parents must also exist. */
   kPushTree,
+  /** Walk the entire tree on the server to check that every object is present.
+   * Metadata objects are fetched without asking for their presence first, and
+   * missing objects are recorded instead of ending the walk. */
+  kCheckTree,
 };
 
 /** Types of OSTree objects, borrowed from libostree/ostree-core.h.
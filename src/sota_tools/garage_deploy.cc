@@ -26,6 +26,8 @@ int main(int argc, char **argv) {
   std::string hardwareids;
   std::string cacerts;
   int max_curl_requests;
+  std::string congestion_control_name;
+  boost::filesystem::path stats_path;
   RunMode mode = RunMode::kDefault;
   po::options_description desc("garage-deploy command line options");
   // clang-format off
@@ -42,6 +44,8 @@ int main(int argc, char **argv) {
     ("hardwareids,h", po::value<std::string>(&hardwareids)->required(), "list of hardware ids")
     ("cacert", po::value<std::string>(&cacerts), "override path to CA root certificates, in the same format as curl --cacert")
     ("jobs", po::value<int>(&max_curl_requests)->default_value(30), "maximum number of parallel requests")
+    ("congestion-control", po::value<std::string>(&congestion_control_name)->default_value("aimd"), "algorithm adjusting the number of parallel requests: aimd or latency")
+    ("stats-json", po::value<boost::filesystem::path>(&stats_path), "write a JSON summary of the requests, throughput and errors of the upload to this file")
     ("dry-run,n", "check arguments and authenticate but don't upload");
   // clang-format on
 
@@ -94,6 +98,11 @@ int main(int argc, char **argv) {
     LOG_FATAL << "--jobs must be greater than 0";
     return EXIT_FAILURE;
   }
+  CongestionControl congestion_control;
+  if (!ParseCongestionControl(congestion_control_name, &congestion_control)) {
+    LOG_FATAL << "--congestion-control must be aimd or latency";
+    return EXIT_FAILURE;
+  }
 
   ServerCredentials fetch_credentials(fetch_cred);
   TreehubServer fetch_server;
@@ -112,10 +121,16 @@ int main(int argc, char **argv) {
   OSTreeRepo::ptr src_repo = std::make_shared<OSTreeHttpRepo>(&fetch_server);
   try {
     OSTreeHash commit(OSTreeHash::Parse(ostree_commit));
-    // Since the fetches happen on a single thread in OSTreeHttpRepo, there
-    // isn't much reason to upload in parallel, but why hold the system back if
-    // the fetching is faster than the uploading?
-    if (!UploadToTreehub(src_repo, push_server, commit, mode, max_curl_requests)) {
+    // Only the commit is fetched up front. The other objects are fetched by
+    // the request pool alongside the uploads, and only if the push server does
+    // not have them already or they are needed to walk the tree.
+    PoolStats stats;
+    const bool uploaded = UploadToTreehub(src_repo, push_server, commit, mode, max_curl_requests, nullptr,
+                                          congestion_control, 0, false, &stats);
+    if (!stats_path.empty()) {
+      stats.WriteJson(stats_path, uploaded);
+    }
+    if (!uploaded) {
       LOG_FATAL << "Upload to treehub failed";
       return EXIT_FAILURE;
     }
@@ -1,4 +1,8 @@
+#include <algorithm>
+#include <chrono>
+#include <memory>
 #include <string>
+#include <thread>
 
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
@@ -14,6 +18,12 @@
 
 namespace po = boost::program_options;
 
+namespace {
+// Reading directory trees is cheap next to the requests, a few threads keep
+// well ahead of them.
+int DefaultParseJobs() { return std::min(4, std::max(1, static_cast<int>(std::thread::hardware_concurrency()))); }
+}  // namespace
+
 int main(int argc, char **argv) {
   logger_init();
 
@@ -23,6 +33,10 @@ int main(int argc, char **argv) {
   std::string cacerts;
   boost::filesystem::path manifest_path;
   int max_curl_requests;
+  int push_cache_ttl_hours;
+  int parse_jobs;
+  std::string congestion_control_name;
+  boost::filesystem::path stats_path;
   RunMode mode = RunMode::kDefault;
   po::options_description desc("garage-push command line options");
   // clang-format off
@@ -38,6 +52,12 @@ int main(int argc, char **argv) {
     ("cacert", po::value<std::string>(&cacerts), "override path to CA root certificates, in the same format as curl --cacert")
     ("repo-manifest", po::value<boost::filesystem::path>(&manifest_path), "manifest describing repository branches used in the image, to be sent as attached metadata")
     ("jobs", po::value<int>(&max_curl_requests)->default_value(30), "maximum number of parallel requests")
+    ("congestion-control", po::value<std::string>(&congestion_control_name)->default_value("aimd"), "algorithm adjusting the number of parallel requests: aimd or latency")
+    ("parse-jobs", po::value<int>(&parse_jobs)->default_value(DefaultParseJobs()), "number of threads reading the repository's directory trees ahead of the requests, 0 to read them one by one")
+    ("push-cache", "record the objects confirmed by the server and do not check them again on later pushes; objects removed from the server within --push-cache-ttl are not pushed again")
+    ("push-cache-ttl", po::value<int>(&push_cache_ttl_hours)->default_value(168), "hours for which objects confirmed by the server are not checked again with --push-cache")
+    ("bulk-upload", "upload small objects in archives of many objects, if the server supports it")
+    ("stats-json", po::value<boost::filesystem::path>(&stats_path), "write a JSON summary of the requests, throughput and errors of the upload to this file")
     ("dry-run,n", "check arguments and authenticate but don't upload")
     ("walk-tree,w", "walk entire tree and upload all missing objects");
   // clang-format on
@@ -106,6 +126,19 @@ int main(int argc, char **argv) {
     LOG_FATAL << "--jobs must be greater than 0";
     return EXIT_FAILURE;
   }
+  CongestionControl congestion_control;
+  if (!ParseCongestionControl(congestion_control_name, &congestion_control)) {
+    LOG_FATAL << "--congestion-control must be aimd or latency";
+    return EXIT_FAILURE;
+  }
+  if (parse_jobs < 0) {
+    LOG_FATAL << "--parse-jobs must not be negative";
+    return EXIT_FAILURE;
+  }
+  if (push_cache_ttl_hours < 0) {
+    LOG_FATAL << "--push-cache-ttl must not be negative";
+    return EXIT_FAILURE;
+  }
 
   OSTreeRepo::ptr src_repo = std::make_shared<OSTreeDirRepo>(repo_path);
   if (!src_repo->LooksValid()) {
@@ -135,7 +168,19 @@ int main(int argc, char **argv) {
       LOG_FATAL << "Authentication with push server failed";
       return EXIT_FAILURE;
     }
-    if (!UploadToTreehub(src_repo, push_server, *commit, mode, max_curl_requests)) {
+    std::shared_ptr<PushStateCache> push_cache;
+    if (vm.count("push-cache") != 0 && (mode == RunMode::kDefault || mode == RunMode::kPushTree)) {
+      push_cache = std::make_shared<PushStateCache>(repo_path, push_server.root_url(),
+                                                    std::chrono::hours(push_cache_ttl_hours));
+      push_cache->Load();
+    }
+    PoolStats stats;
+    const bool uploaded = UploadToTreehub(src_repo, push_server, *commit, mode, max_curl_requests, push_cache,
+                                          congestion_control, parse_jobs, vm.count("bulk-upload") != 0U, &stats);
+    if (!stats_path.empty()) {
+      stats.WriteJson(stats_path, uploaded);
+    }
+    if (!uploaded) {
       LOG_FATAL << "Upload to treehub failed";
       return EXIT_FAILURE;
     }
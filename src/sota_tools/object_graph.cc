@@ -0,0 +1,243 @@
+#include "object_graph.h"
+
+#include <cassert>
+#include <stdexcept>
+
+#include <glib.h>
+
+#include "logging/logging.h"
+
+ObjectGraph::ObjectGraph(boost::filesystem::path objects_dir, const int jobs)
+    : objects_dir_(std::move(objects_dir)), jobs_(jobs) {
+  assert(jobs_ > 0);
+}
+
+ObjectGraph::~ObjectGraph() { Stop(); }
+
+void ObjectGraph::Start(const OSTreeHash &commit) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Enqueue(commit, OstreeObjectType::OSTREE_OBJECT_TYPE_COMMIT, true);
+  }
+  for (int i = 0; i < jobs_; ++i) {
+    workers_.emplace_back(&ObjectGraph::Run, this);
+  }
+}
+
+void ObjectGraph::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  work_cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+}
+
+bool ObjectGraph::Children(const OSTreeHash &hash, const OstreeObjectType type, std::vector<Child> *children) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = nodes_.find(hash);
+    if (it != nodes_.end() && it->second.state == State::kParsed) {
+      *children = it->second.children;
+      return true;
+    }
+    if (it != nodes_.end() && it->second.state == State::kFailed) {
+      throw std::runtime_error(it->second.error);
+    }
+    if (!stopped_) {
+      if (it == nodes_.end() || it->second.state == State::kQueued) {
+        Enqueue(hash, type, true);
+        work_cv_.notify_one();
+      }
+      return false;
+    }
+  }
+  // Without workers, nobody else is going to parse it.
+  children->clear();
+  ParseObject(ObjectPath(hash, type), type, children);
+  return true;
+}
+
+bool ObjectGraph::Parsed(const OSTreeHash &hash) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = nodes_.find(hash);
+  return stopped_ || (it != nodes_.end() && (it->second.state == State::kParsed || it->second.state == State::kFailed));
+}
+
+void ObjectGraph::WaitForProgress(const std::chrono::milliseconds timeout) const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const size_t parsed = parsed_objects_;
+  progress_cv_.wait_for(lock, timeout, [this, parsed]() { return stopped_ || parsed_objects_ != parsed; });
+}
+
+size_t ObjectGraph::parsed_objects() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return parsed_objects_;
+}
+
+void ObjectGraph::Enqueue(const OSTreeHash &hash, const OstreeObjectType type, const bool first) {
+  nodes_.emplace(hash, Node());
+  if (first) {
+    queue_.emplace_front(hash, type);
+  } else {
+    queue_.emplace_back(hash, type);
+  }
+}
+
+boost::filesystem::path ObjectGraph::ObjectPath(const OSTreeHash &hash, const OstreeObjectType type) const {
+  const std::string name = hash.string().insert(2, 1, '/');
+  return objects_dir_ / (name + (type == OstreeObjectType::OSTREE_OBJECT_TYPE_COMMIT ? ".commit" : ".dirtree"));
+}
+
+void ObjectGraph::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    work_cv_.wait(lock, [this]() { return stopped_ || !queue_.empty(); });
+    if (stopped_) {
+      return;
+    }
+    const std::pair<OSTreeHash, OstreeObjectType> item = queue_.front();
+    queue_.pop_front();
+    // An object asked for by Children() can be in the queue twice.
+    Node &queued = nodes_.at(item.first);
+    if (queued.state != State::kQueued) {
+      continue;
+    }
+    queued.state = State::kParsing;
+
+    std::vector<Child> children;
+    std::string error;
+    lock.unlock();
+    try {
+      ParseObject(ObjectPath(item.first, item.second), item.second, &children);
+    } catch (const std::exception &e) {
+      error = e.what();
+    }
+    lock.lock();
+
+    // The reference may have been invalidated by a rehash in the meantime.
+    Node &node = nodes_.at(item.first);
+    if (error.empty()) {
+      for (const Child &child : children) {
+        if (child.type == OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_TREE && nodes_.count(child.hash) == 0) {
+          Enqueue(child.hash, child.type, false);
+        }
+      }
+      node.children = std::move(children);
+      node.state = State::kParsed;
+    } else {
+      LOG_DEBUG << "Could not parse " << ObjectPath(item.first, item.second) << ": " << error;
+      node.state = State::kFailed;
+      node.error = std::move(error);
+    }
+    ++parsed_objects_;
+    work_cv_.notify_all();
+    progress_cv_.notify_all();
+  }
+}
+
+void ObjectGraph::ParseObject(const boost::filesystem::path &path, const OstreeObjectType type,
+                              std::vector<Child> *children) {
+  const GVariantType *content_type;
+  bool is_commit;
+
+  // variant types are borrowed from libostree/ostree-core.h,
+  // but we don't want to create dependency on it
+  if (type == OstreeObjectType::OSTREE_OBJECT_TYPE_COMMIT) {
+    content_type = G_VARIANT_TYPE("(a{sv}aya(say)sstayay)");
+    is_commit = true;
+  } else if (type == OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_TREE) {
+    content_type = G_VARIANT_TYPE("(a(say)a(sayay))");
+    is_commit = false;
+  } else {
+    return;
+  }
+
+  GError *gerror = nullptr;
+  GMappedFile *mfile = g_mapped_file_new(path.c_str(), FALSE, &gerror);
+
+  if (mfile == nullptr) {
+    g_clear_error(&gerror);
+    throw std::runtime_error("Failed to map metadata file " + path.native());
+  }
+
+  GVariant *contents =
+      g_variant_new_from_data(content_type, g_mapped_file_get_contents(mfile), g_mapped_file_get_length(mfile), TRUE,
+                              reinterpret_cast<GDestroyNotify>(g_mapped_file_unref), mfile);
+  g_variant_ref_sink(contents);
+
+  if (is_commit) {
+    // * - ay - Root tree contents
+    GVariant *content_csum_variant = nullptr;
+    g_variant_get_child(contents, 6, "@ay", &content_csum_variant);
+
+    gsize n_elts;
+    const auto *csum = static_cast<const uint8_t *>(g_variant_get_fixed_array(content_csum_variant, &n_elts, 1));
+    assert(n_elts == 32);
+    children->push_back(Child{OSTreeHash(csum), OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_TREE});
+
+    // * - ay - Root tree metadata
+    GVariant *meta_csum_variant = nullptr;
+    g_variant_get_child(contents, 7, "@ay", &meta_csum_variant);
+    csum = static_cast<const uint8_t *>(g_variant_get_fixed_array(meta_csum_variant, &n_elts, 1));
+    assert(n_elts == 32);
+    children->push_back(Child{OSTreeHash(csum), OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_META});
+
+    g_variant_unref(meta_csum_variant);
+    g_variant_unref(content_csum_variant);
+  } else {
+    GVariant *files_variant = nullptr;
+    GVariant *dirs_variant = nullptr;
+
+    files_variant = g_variant_get_child_value(contents, 0);
+    dirs_variant = g_variant_get_child_value(contents, 1);
+
+    gsize nfiles = g_variant_n_children(files_variant);
+    gsize ndirs = g_variant_n_children(dirs_variant);
+    children->reserve(children->size() + nfiles + 2 * ndirs);
+
+    // * - a(say) - array of (filename, checksum) for files
+    for (gsize i = 0; i < nfiles; i++) {
+      GVariant *csum_variant = nullptr;
+      const char *fname = nullptr;
+
+      g_variant_get_child(files_variant, i, "(&s@ay)", &fname, &csum_variant);
+      gsize n_elts;
+      const auto *csum = static_cast<const uint8_t *>(g_variant_get_fixed_array(csum_variant, &n_elts, 1));
+      assert(n_elts == 32);
+      children->push_back(Child{OSTreeHash(csum), OstreeObjectType::OSTREE_OBJECT_TYPE_FILE});
+
+      g_variant_unref(csum_variant);
+    }
+
+    // * - a(sayay) - array of (dirname, tree_checksum, meta_checksum) for directories
+    for (gsize i = 0; i < ndirs; i++) {
+      GVariant *content_csum_variant = nullptr;
+      GVariant *meta_csum_variant = nullptr;
+      const char *fname = nullptr;
+      g_variant_get_child(dirs_variant, i, "(&s@ay@ay)", &fname, &content_csum_variant, &meta_csum_variant);
+      gsize n_elts;
+      // First the .dirtree:
+      const auto *csum = static_cast<const uint8_t *>(g_variant_get_fixed_array(content_csum_variant, &n_elts, 1));
+      assert(n_elts == 32);
+      children->push_back(Child{OSTreeHash(csum), OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_TREE});
+
+      // Then the .dirmeta:
+      csum = static_cast<const uint8_t *>(g_variant_get_fixed_array(meta_csum_variant, &n_elts, 1));
+      assert(n_elts == 32);
+      children->push_back(Child{OSTreeHash(csum), OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_META});
+
+      g_variant_unref(meta_csum_variant);
+      g_variant_unref(content_csum_variant);
+    }
+
+    g_variant_unref(dirs_variant);
+    g_variant_unref(files_variant);
+  }
+  g_variant_unref(contents);
+}
+
+// vim: set tabstop=2 shiftwidth=2 expandtab:
@@ -0,0 +1,96 @@
+#ifndef SOTA_CLIENT_TOOLS_OBJECT_GRAPH_H_
+#define SOTA_CLIENT_TOOLS_OBJECT_GRAPH_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "garage_common.h"
+#include "ostree_hash.h"
+
+/**
+ * The references between the metadata objects (commits and dirtrees) of a
+ * local OSTree repository, parsed ahead of the request loop.
+ *
+ * Starting from a commit, worker threads map and parse every dirtree reachable
+ * from it, breadth first, and record the children of each object in a table
+ * keyed by the object's digest. The request loop looks the children up with
+ * Children(), which never waits: objects that are not parsed yet are moved to
+ * the front of the workers' queue instead.
+ */
+class ObjectGraph {
+ public:
+  struct Child {
+    OSTreeHash hash;
+    OstreeObjectType type;
+  };
+
+  /* `objects_dir` is the objects directory of the repository. */
+  ObjectGraph(boost::filesystem::path objects_dir, int jobs);
+  ~ObjectGraph();
+  ObjectGraph(const ObjectGraph&) = delete;
+  ObjectGraph& operator=(const ObjectGraph&) = delete;
+
+  /* Start parsing the tree of `commit` in the background. */
+  void Start(const OSTreeHash& commit);
+
+  /* Stop the workers. Objects that are not parsed yet stay unparsed. */
+  void Stop();
+
+  /* If the object has been parsed, set `children` to its children and return
+   * true. Otherwise ask for it to be parsed next and return false.
+   * @throws std::runtime_error if the object could not be parsed */
+  bool Children(const OSTreeHash& hash, OstreeObjectType type, std::vector<Child>* children);
+
+  /* Whether the object has been parsed (or has failed to parse). */
+  bool Parsed(const OSTreeHash& hash) const;
+
+  /* Wait until another object has been parsed, at most `timeout`. */
+  void WaitForProgress(std::chrono::milliseconds timeout) const;
+
+  /* The number of objects parsed so far. */
+  size_t parsed_objects() const;
+
+  /**
+   * Read the children of the commit or dirtree at `path`.
+   * @throws std::runtime_error if the object can not be read
+   */
+  static void ParseObject(const boost::filesystem::path& path, OstreeObjectType type, std::vector<Child>* children);
+
+ private:
+  enum class State { kQueued, kParsing, kParsed, kFailed };
+
+  struct Node {
+    State state{State::kQueued};
+    std::vector<Child> children;
+    std::string error;
+  };
+
+  void Run();
+  /* Queue `hash` for parsing unless it is known already. Needs mutex_. */
+  void Enqueue(const OSTreeHash& hash, OstreeObjectType type, bool first);
+  boost::filesystem::path ObjectPath(const OSTreeHash& hash, OstreeObjectType type) const;
+
+  const boost::filesystem::path objects_dir_;
+  const int jobs_;
+  std::vector<std::thread> workers_;
+
+  mutable std::mutex mutex_;
+  mutable std::condition_variable work_cv_;      // something was queued, or the workers should stop
+  mutable std::condition_variable progress_cv_;  // an object has been parsed
+  std::unordered_map<OSTreeHash, Node, OSTreeHash::Hasher> nodes_;
+  std::deque<std::pair<OSTreeHash, OstreeObjectType>> queue_;
+  size_t parsed_objects_{0};
+  bool stopped_{false};
+};
+
+// vim: set tabstop=2 shiftwidth=2 expandtab:
+#endif  // SOTA_CLIENT_TOOLS_OBJECT_GRAPH_H_
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+#include "object_graph.h"
+#include "utilities/utils.h"
+
+namespace {
+
+const OSTreeHash kCommit = OSTreeHash::Parse("16ef2f2629dc9263fdf3c0f032563a2d757623bbc11cf99df25c3c3f258dccbe");
+const OSTreeHash kDirtree = OSTreeHash::Parse("3c064a2f3853b9158b82184311eca9d9d55fcd4788243546fbd98358763ef6fc");
+const OSTreeHash kDirmeta = OSTreeHash::Parse("2a28dac42b76c2015ee3c41cc4183bb8b5c790fd21fa5cfa0802c6e11fd0edbe");
+const OSTreeHash kFile = OSTreeHash::Parse("a1f4f81612ce959883f58e83789f6c7d97b0b55b801b2a09955235f40b0f2dfb");
+
+/* Ask for the children of an object until the workers have parsed it. */
+std::vector<ObjectGraph::Child> WaitForChildren(ObjectGraph &graph, const OSTreeHash &hash, OstreeObjectType type) {
+  std::vector<ObjectGraph::Child> children;
+  for (int i = 0; i < 100 && !graph.Children(hash, type, &children); ++i) {
+    graph.WaitForProgress(std::chrono::milliseconds(100));
+  }
+  return children;
+}
+
+}  // namespace
+
+/* Read the children of a commit and of a dirtree directly. */
+TEST(ObjectGraph, ParseObject) {
+  std::vector<ObjectGraph::Child> children;
+  ObjectGraph::ParseObject(
+      "tests/sota_tools/repo/objects/16/ef2f2629dc9263fdf3c0f032563a2d757623bbc11cf99df25c3c3f258dccbe.commit",
+      OstreeObjectType::OSTREE_OBJECT_TYPE_COMMIT, &children);
+  ASSERT_EQ(children.size(), 2u);
+  EXPECT_EQ(children[0].hash, kDirtree);
+  EXPECT_EQ(children[0].type, OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_TREE);
+  EXPECT_EQ(children[1].hash, kDirmeta);
+  EXPECT_EQ(children[1].type, OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_META);
+
+  children.clear();
+  ObjectGraph::ParseObject(
+      "tests/sota_tools/repo/objects/3c/064a2f3853b9158b82184311eca9d9d55fcd4788243546fbd98358763ef6fc.dirtree",
+      OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_TREE, &children);
+  ASSERT_EQ(children.size(), 1u);
+  EXPECT_EQ(children[0].hash, kFile);
+  EXPECT_EQ(children[0].type, OstreeObjectType::OSTREE_OBJECT_TYPE_FILE);
+}
+
+/* The workers parse the whole tree of a commit. */
+TEST(ObjectGraph, Walk) {
+  ObjectGraph graph("tests/sota_tools/repo/objects", 2);
+  graph.Start(kCommit);
+
+  std::vector<ObjectGraph::Child> children =
+      WaitForChildren(graph, kCommit, OstreeObjectType::OSTREE_OBJECT_TYPE_COMMIT);
+  ASSERT_EQ(children.size(), 2u);
+  EXPECT_EQ(children[0].hash, kDirtree);
+
+  children = WaitForChildren(graph, kDirtree, OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_TREE);
+  ASSERT_EQ(children.size(), 1u);
+  EXPECT_EQ(children[0].hash, kFile);
+  EXPECT_TRUE(graph.Parsed(kDirtree));
+  EXPECT_EQ(graph.parsed_objects(), 2u);
+
+  // Once stopped, objects are parsed when asked for.
+  graph.Stop();
+  children.clear();
+  EXPECT_TRUE(graph.Children(kDirtree, OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_TREE, &children));
+  EXPECT_EQ(children.size(), 1u);
+}
+
+/* A dirtree that can not be read is reported when its children are needed. */
+TEST(ObjectGraph, MissingDirtree) {
+  TemporaryDirectory temp_dir;
+  Utils::copyDir("tests/sota_tools/repo", temp_dir.Path() / "repo");
+  boost::filesystem::remove(temp_dir.Path() /
+                            "repo/objects/3c/064a2f3853b9158b82184311eca9d9d55fcd4788243546fbd98358763ef6fc.dirtree");
+
+  ObjectGraph graph(temp_dir.Path() / "repo/objects", 1);
+  graph.Start(kCommit);
+  EXPECT_EQ(WaitForChildren(graph, kCommit, OstreeObjectType::OSTREE_OBJECT_TYPE_COMMIT).size(), 2u);
+  EXPECT_THROW(WaitForChildren(graph, kDirtree, OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_TREE), std::runtime_error);
+}
+
+#ifndef __NO_MAIN__
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+#endif
+
+// vim: set tabstop=2 shiftwidth=2 expandtab:
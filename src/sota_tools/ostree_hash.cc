@@ -52,6 +52,16 @@ bool OSTreeHash::operator<(const OSTreeHash& other) const {
   return memcmp(hash_.data(), other.hash_.data(), hash_.size()) < 0;
 }
 
+bool OSTreeHash::operator==(const OSTreeHash& other) const {
+  return memcmp(hash_.data(), other.hash_.data(), hash_.size()) == 0;
+}
+
+size_t OSTreeHash::Hasher::operator()(const OSTreeHash& hash) const {
+  size_t result;
+  memcpy(&result, hash.hash_.data(), sizeof(result));
+  return result;
+}
+
 std::ostream& operator<<(std::ostream& os, const OSTreeHash& obj) {
   os << obj.string();
   return os;
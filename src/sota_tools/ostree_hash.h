@@ -2,6 +2,7 @@
 #define SOTA_CLIENT_TOOLS_OSTREE_HASH_H_
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <iostream>
 #include <string>
@@ -21,8 +22,15 @@ class OSTreeHash {
   std::string string() const;
 
   bool operator<(const OSTreeHash& other) const;
+  bool operator==(const OSTreeHash& other) const;
   friend std::ostream& operator<<(std::ostream& os, const OSTreeHash& obj);
 
+  /* Hash function for unordered containers. The digest is already uniformly
+   * distributed, so its leading bytes are used as they are. */
+  struct Hasher {
+    size_t operator()(const OSTreeHash& hash) const;
+  };
+
  private:
   std::array<uint8_t, 32> hash_{};
 };
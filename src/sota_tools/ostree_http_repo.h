@@ -25,6 +25,10 @@ class OSTreeHttpRepo : public OSTreeRepo {
   bool LooksValid() const override;
   OSTreeRef GetRef(const std::string& refname) const override;
   boost::filesystem::path root() const override { return root_; }
+  bool FetchesOnDemand() const override { return true; }
+  void InjectFetchIntoCurl(const std::string& path, CURL* curl_handle) const override {
+    server_->InjectIntoCurl(path, curl_handle);
+  }
 
  private:
   bool FetchObject(const boost::filesystem::path& path) const override;
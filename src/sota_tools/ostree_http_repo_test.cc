@@ -108,6 +108,56 @@ TEST(http_repo, bad_connection) {
   EXPECT_EQ(result, 0) << "Diff between source and destination repos is nonzero.";
 }
 
+/* Only fetch the objects the destination needs.
+ *
+ * Deploy a commit twice. The first deploy has to fetch every object, the
+ * second one finds the commit on the destination and only fetches the commit
+ * itself. */
+TEST(http_repo, fetch_on_demand) {
+  TemporaryDirectory src_dir, dst_dir;
+  std::string sp = TestUtils::getFreePort();
+
+  boost::process::child server_process("tests/sota_tools/treehub_server.py", std::string("-p"), sp, std::string("-d"),
+                                       src_dir.PathString(), std::string("--create"));
+  TestUtils::waitForServer("http://localhost:" + sp + "/");
+
+  TreehubServer server;
+  server.root_url("http://localhost:" + sp);
+
+  std::string dp = TestUtils::getFreePort();
+  Json::Value auth;
+  auth["ostree"]["server"] = std::string("https://localhost:") + dp;
+  Utils::writeFile(dst_dir.Path() / "auth.json", auth);
+  boost::process::child deploy_server_process("tests/sota_tools/treehub_server.py", std::string("-p"), dp,
+                                              std::string("-d"), dst_dir.PathString(), std::string("--tls"));
+  TestUtils::waitForServer("https://localhost:" + dp + "/");
+
+  boost::filesystem::path filepath = (dst_dir.Path() / "auth.json").string();
+  boost::filesystem::path cert_path = "tests/fake_http_server/server.crt";
+
+  auto hash = OSTreeHash::Parse("b9ac1e45f9227df8ee191b6e51e09417bd36c6ebbeff999431e3073ac50f0563");
+  TreehubServer push_server;
+  EXPECT_EQ(authenticate(cert_path.string(), ServerCredentials(filepath), push_server), EXIT_SUCCESS);
+
+  auto count_objects = [](const boost::filesystem::path &root) {
+    size_t count = 0;
+    for (boost::filesystem::recursive_directory_iterator it(root / "objects"), end; it != end; ++it) {
+      if (boost::filesystem::is_regular_file(it->path())) {
+        ++count;
+      }
+    }
+    return count;
+  };
+
+  OSTreeRepo::ptr first_repo = std::make_shared<OSTreeHttpRepo>(&server);
+  EXPECT_TRUE(UploadToTreehub(first_repo, push_server, hash, RunMode::kDefault, 4));
+  EXPECT_EQ(count_objects(first_repo->root()), count_objects(dst_dir.Path()));
+
+  OSTreeRepo::ptr second_repo = std::make_shared<OSTreeHttpRepo>(&server);
+  EXPECT_TRUE(UploadToTreehub(second_repo, push_server, hash, RunMode::kDefault, 4));
+  EXPECT_EQ(count_objects(second_repo->root()), 1u);
+}
+
 TEST(http_repo, root) {
   TreehubServer server;
   server.root_url("http://localhost:" + port);
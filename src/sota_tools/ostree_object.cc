@@ -1,28 +1,35 @@
 #include "ostree_object.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <cassert>
+#include <cerrno>
 #include <cstring>
 #include <iostream>
-
-#include <glib.h>
+#include <vector>
 
 #include "logging/logging.h"
+#include "object_graph.h"
 #include "ostree_repo.h"
 #include "request_pool.h"
 #include "utilities/utils.h"
 
 using std::string;
 
-OSTreeObject::OSTreeObject(const OSTreeRepo &repo, const std::string &object_name)
+constexpr long OSTreeObject::kUploadBufferSize;  // NOLINT(google-runtime-int)
+
+OSTreeObject::OSTreeObject(const OSTreeRepo &repo, const std::string &object_name, const bool fetched)
     : file_path_(repo.root() / "/objects/" / object_name),
       object_name_(object_name),
       repo_(repo),
       refcount_(0),
       is_on_server_(PresenceOnServer::kObjectStateUnknown),
       curl_handle_(nullptr),
-      fd_(nullptr) {
-  if (!boost::filesystem::is_regular_file(file_path_)) {
+      fd_(nullptr),
+      fetched_(fetched) {
+  if (fetched_ && !boost::filesystem::is_regular_file(file_path_)) {
     throw std::runtime_error(file_path_.native() + " is not a valid OSTree object.");
   }
 }
@@ -32,6 +39,42 @@ OSTreeObject::~OSTreeObject() {
     curl_easy_cleanup(curl_handle_);
     curl_handle_ = nullptr;
   }
+  ReleaseUploadSource();
+}
+
+bool OSTreeObject::MapForUpload(const size_t size) {
+  assert(upload_map_ == nullptr);
+  if (size == 0) {
+    return false;  // mmap() does not take empty mappings
+  }
+  const int fd = open(file_path_.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  void *map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    LOG_DEBUG << "Could not map " << object_name_ << " for upload: " << std::strerror(errno);
+    return false;
+  }
+  if (size > static_cast<size_t>(kUploadBufferSize)) {
+    madvise(map, size, MADV_SEQUENTIAL);
+  }
+  upload_map_ = map;
+  upload_map_size_ = size;
+  return true;
+}
+
+void OSTreeObject::ReleaseUploadSource() {
+  if (upload_map_ != nullptr) {
+    munmap(upload_map_, upload_map_size_);
+    upload_map_ = nullptr;
+    upload_map_size_ = 0;
+  }
+  if (fd_ != nullptr && current_operation_ == CurrentOp::kOstreeObjectUploading) {
+    fclose(fd_);
+    fd_ = nullptr;
+  }
 }
 
 void OSTreeObject::AddParent(OSTreeObject *parent, std::list<OSTreeObject::ptr>::iterator parent_it) {
@@ -71,108 +114,34 @@ void OSTreeObject::AppendChild(const OSTreeObject::ptr &child) {
 }
 
 // Can throw OSTreeObjectMissing if the repo is corrupt
-void OSTreeObject::PopulateChildren() {
-  const boost::filesystem::path ext = file_path_.extension();
-  const GVariantType *content_type;
-  bool is_commit;
-
-  // variant types are borrowed from libostree/ostree-core.h,
-  // but we don't want to create dependency on it
-  if (ext.compare(".commit") == 0) {
-    content_type = G_VARIANT_TYPE("(a{sv}aya(say)sstayay)");
-    is_commit = true;
-  } else if (ext.compare(".dirtree") == 0) {
-    content_type = G_VARIANT_TYPE("(a(say)a(sayay))");
-    is_commit = false;
-  } else {
-    return;
+bool OSTreeObject::PopulateChildren() {
+  if (!HasChildren()) {
+    return true;
   }
-
-  GError *gerror = nullptr;
-  GMappedFile *mfile = g_mapped_file_new(file_path_.c_str(), FALSE, &gerror);
-
-  if (mfile == nullptr) {
-    throw std::runtime_error("Failed to map metadata file " + file_path_.native());
+  std::vector<ObjectGraph::Child> children;
+  ObjectGraph *graph = repo_.object_graph();
+  if (graph == nullptr) {
+    ObjectGraph::ParseObject(file_path_, Type(), &children);
+  } else if (!graph->Children(Hash(), Type(), &children)) {
+    return false;
   }
-
-  GVariant *contents =
-      g_variant_new_from_data(content_type, g_mapped_file_get_contents(mfile), g_mapped_file_get_length(mfile), TRUE,
-                              reinterpret_cast<GDestroyNotify>(g_mapped_file_unref), mfile);
-  g_variant_ref_sink(contents);
-
-  if (is_commit) {
-    // * - ay - Root tree contents
-    GVariant *content_csum_variant = nullptr;
-    g_variant_get_child(contents, 6, "@ay", &content_csum_variant);
-
-    gsize n_elts;
-    const auto *csum = static_cast<const uint8_t *>(g_variant_get_fixed_array(content_csum_variant, &n_elts, 1));
-    assert(n_elts == 32);
-    AppendChild(repo_.GetObject(csum, OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_TREE));
-
-    // * - ay - Root tree metadata
-    GVariant *meta_csum_variant = nullptr;
-    g_variant_get_child(contents, 7, "@ay", &meta_csum_variant);
-    csum = static_cast<const uint8_t *>(g_variant_get_fixed_array(meta_csum_variant, &n_elts, 1));
-    assert(n_elts == 32);
-    AppendChild(repo_.GetObject(csum, OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_META));
-
-    g_variant_unref(meta_csum_variant);
-    g_variant_unref(content_csum_variant);
-  } else {
-    GVariant *files_variant = nullptr;
-    GVariant *dirs_variant = nullptr;
-
-    files_variant = g_variant_get_child_value(contents, 0);
-    dirs_variant = g_variant_get_child_value(contents, 1);
-
-    gsize nfiles = g_variant_n_children(files_variant);
-    gsize ndirs = g_variant_n_children(dirs_variant);
-
-    // * - a(say) - array of (filename, checksum) for files
-    for (gsize i = 0; i < nfiles; i++) {
-      GVariant *csum_variant = nullptr;
-      const char *fname = nullptr;
-
-      g_variant_get_child(files_variant, i, "(&s@ay)", &fname, &csum_variant);
-      gsize n_elts;
-      const auto *csum = static_cast<const uint8_t *>(g_variant_get_fixed_array(csum_variant, &n_elts, 1));
-      assert(n_elts == 32);
-      AppendChild(repo_.GetObject(csum, OstreeObjectType::OSTREE_OBJECT_TYPE_FILE));
-
-      g_variant_unref(csum_variant);
-    }
-
-    // * - a(sayay) - array of (dirname, tree_checksum, meta_checksum) for directories
-    for (gsize i = 0; i < ndirs; i++) {
-      GVariant *content_csum_variant = nullptr;
-      GVariant *meta_csum_variant = nullptr;
-      const char *fname = nullptr;
-      g_variant_get_child(dirs_variant, i, "(&s@ay@ay)", &fname, &content_csum_variant, &meta_csum_variant);
-      gsize n_elts;
-      // First the .dirtree:
-      const auto *csum = static_cast<const uint8_t *>(g_variant_get_fixed_array(content_csum_variant, &n_elts, 1));
-      assert(n_elts == 32);
-      AppendChild(repo_.GetObject(csum, OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_TREE));
-
-      // Then the .dirmeta:
-      csum = static_cast<const uint8_t *>(g_variant_get_fixed_array(meta_csum_variant, &n_elts, 1));
-      assert(n_elts == 32);
-      AppendChild(repo_.GetObject(csum, OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_META));
-
-      g_variant_unref(meta_csum_variant);
-      g_variant_unref(content_csum_variant);
-    }
-
-    g_variant_unref(dirs_variant);
-    g_variant_unref(files_variant);
+  for (const ObjectGraph::Child &child : children) {
+    AppendChild(repo_.GetChildObject(child.hash, child.type));
   }
-  g_variant_unref(contents);
+  return true;
 }
 
 void OSTreeObject::QueryChildren(RequestPool &pool) {
   for (const OSTreeObject::ptr &child : children_) {
-    if (child->is_on_server() == PresenceOnServer::kObjectStateUnknown) {
+    if (child->is_on_server() != PresenceOnServer::kObjectStateUnknown) {
+      continue;
+    }
+    if (pool.run_mode() == RunMode::kCheckTree && child->HasChildren() && !child->fetched()) {
+      // The contents are needed to walk further, and fetching them shows
+      // whether the object is on the server: don't query it first.
+      child->LaunchNotify();
+      pool.AddFetch(child);
+    } else {
       pool.AddQuery(child);
     }
   }
@@ -180,13 +149,54 @@ void OSTreeObject::QueryChildren(RequestPool &pool) {
 
 string OSTreeObject::Url() const { return "objects/" + object_name_; }
 
-void OSTreeObject::MakeTestRequest(const TreehubServer &push_target, CURLM *curl_multi_handle) {
+bool OSTreeObject::HasChildren() const {
+  const boost::filesystem::path ext = file_path_.extension();
+  return ext.compare(".commit") == 0 || ext.compare(".dirtree") == 0;
+}
+
+OSTreeHash OSTreeObject::Hash() const {
+  if (!hash_) {
+    hash_ = OSTreeHash::Parse(object_name_.substr(0, 2) + object_name_.substr(3, 64));
+  }
+  return *hash_;
+}
+
+OstreeObjectType OSTreeObject::Type() const {
+  const boost::filesystem::path ext = file_path_.extension();
+  if (ext.compare(".commit") == 0) {
+    return OstreeObjectType::OSTREE_OBJECT_TYPE_COMMIT;
+  } else if (ext.compare(".dirtree") == 0) {
+    return OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_TREE;
+  } else if (ext.compare(".dirmeta") == 0) {
+    return OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_META;
+  } else if (ext.compare(".filez") == 0) {
+    return OstreeObjectType::OSTREE_OBJECT_TYPE_FILE;
+  }
+  return OstreeObjectType::OSTREE_OBJECT_TYPE_UNKNOWN;
+}
+
+void OSTreeObject::RequestNotStarted(const CURLMcode err) {
+  LOG_ERROR << "curl_multi_add_handle error:" << curl_multi_strerror(err);
+  ReleaseUploadSource();
+  if (fd_ != nullptr) {
+    fclose(fd_);  // a fetch is written to a partial file, it starts over
+    fd_ = nullptr;
+  }
+  curl_easy_cleanup(curl_handle_);
+  curl_handle_ = nullptr;
+}
+
+void OSTreeObject::InitCurlHandle(CURL *curl_handle) {
   assert(!curl_handle_);
-  curl_handle_ = curl_easy_init();
+  curl_handle_ = curl_handle != nullptr ? curl_handle : curl_easy_init();
   if (curl_handle_ == nullptr) {
     throw std::runtime_error("Could not initialize curl handle");
   }
   curlEasySetoptWrapper(curl_handle_, CURLOPT_VERBOSE, get_curlopt_verbose());
+}
+
+bool OSTreeObject::MakeTestRequest(const TreehubServer &push_target, CURLM *curl_multi_handle, CURL *curl_handle) {
+  InitCurlHandle(curl_handle);
   current_operation_ = CurrentOp::kOstreeObjectPresenceCheck;
 
   push_target.InjectIntoCurl(Url(), curl_handle_);
@@ -200,27 +210,50 @@ void OSTreeObject::MakeTestRequest(const TreehubServer &push_target, CURLM *curl
 
   const CURLMcode err = curl_multi_add_handle(curl_multi_handle, curl_handle_);
   if (err != 0) {
-    LOG_ERROR << "err:" << curl_multi_strerror(err);
+    RequestNotStarted(err);
+    return false;
+  }
+  refcount_++;  // Because curl now has a reference to us
+  request_start_time_ = std::chrono::steady_clock::now();
+  return true;
+}
+
+bool OSTreeObject::Fetch(CURLM *curl_multi_handle, CURL *curl_handle) {
+  InitCurlHandle(curl_handle);
+  current_operation_ = CurrentOp::kOstreeObjectFetching;
+
+  repo_.InjectFetchIntoCurl(Url(), curl_handle_);
+  curlEasySetoptWrapper(curl_handle_, CURLOPT_USERAGENT, Utils::getUserAgent());
+
+  boost::filesystem::create_directories(file_path_.parent_path());
+  fd_ = fopen(PartialPath().c_str(), "wb");
+  if (fd_ == nullptr) {
+    throw std::runtime_error("could not open file to fetch into");
+  }
+  // The default write function writes to the FILE* passed as WRITEDATA.
+  curlEasySetoptWrapper(curl_handle_, CURLOPT_WRITEDATA, fd_);
+  curlEasySetoptWrapper(curl_handle_, CURLOPT_PRIVATE, this);  // Used by ostree_object_from_curl
+
+  const CURLMcode err = curl_multi_add_handle(curl_multi_handle, curl_handle_);
+  if (err != 0) {
+    RequestNotStarted(err);
+    return false;
   }
   refcount_++;  // Because curl now has a reference to us
   request_start_time_ = std::chrono::steady_clock::now();
+  return true;
 }
 
-void OSTreeObject::Upload(TreehubServer &push_target, CURLM *curl_multi_handle, const RunMode mode) {
+bool OSTreeObject::Upload(TreehubServer &push_target, CURLM *curl_multi_handle, const RunMode mode,
+                          CURL *curl_handle) {
   if (mode == RunMode::kDefault || mode == RunMode::kPushTree) {
     LOG_INFO << "Uploading " << object_name_;
   } else {
     LOG_INFO << "Would upload " << object_name_;
     is_on_server_ = PresenceOnServer::kObjectPresent;
-    return;
+    return true;
   }
-  assert(!curl_handle_);
-
-  curl_handle_ = curl_easy_init();
-  if (curl_handle_ == nullptr) {
-    throw std::runtime_error("Could not initialize curl handle");
-  }
-  curlEasySetoptWrapper(curl_handle_, CURLOPT_VERBOSE, get_curlopt_verbose());
+  InitCurlHandle(curl_handle);
   current_operation_ = CurrentOp::kOstreeObjectUploading;
   push_target.SetContentType("Content-Type: application/octet-stream");
   push_target.InjectIntoCurl(Url(), curl_handle_);
@@ -230,31 +263,55 @@ void OSTreeObject::Upload(TreehubServer &push_target, CURLM *curl_multi_handle,
   http_response_.str("");  // Empty the response buffer
 
   struct stat file_info {};
-  fd_ = fopen(file_path_.c_str(), "rb");
-  if (fd_ == nullptr) {
-    throw std::runtime_error("could not open file to be uploaded");
+  if (stat(file_path_.c_str(), &file_info) < 0) {
+    throw std::runtime_error("Could not get file information");
+  }
+  const auto size = static_cast<curl_off_t>(file_info.st_size);
+  if (MapForUpload(static_cast<size_t>(file_info.st_size))) {
+    // curl sends the body straight from the mapping, without going through
+    // stdio buffers and a read callback.
+    curlEasySetoptWrapper(curl_handle_, CURLOPT_POSTFIELDSIZE_LARGE, size);
+    curlEasySetoptWrapper(curl_handle_, CURLOPT_POSTFIELDS, upload_map_);
   } else {
-    if (stat(file_path_.c_str(), &file_info) < 0) {
-      throw std::runtime_error("Could not get file information");
+    fd_ = fopen(file_path_.c_str(), "rb");
+    if (fd_ == nullptr) {
+      throw std::runtime_error("could not open file to be uploaded");
     }
+    curlEasySetoptWrapper(curl_handle_, CURLOPT_READDATA, fd_);
+    curlEasySetoptWrapper(curl_handle_, CURLOPT_POSTFIELDSIZE_LARGE, size);
+    curlEasySetoptWrapper(curl_handle_, CURLOPT_POST, 1);
   }
-  curlEasySetoptWrapper(curl_handle_, CURLOPT_READDATA, fd_);
-  curlEasySetoptWrapper(curl_handle_, CURLOPT_POSTFIELDSIZE, file_info.st_size);
-  curlEasySetoptWrapper(curl_handle_, CURLOPT_POST, 1);
+#if LIBCURL_VERSION_NUM >= 0x073e00
+  if (size > kUploadBufferSize) {
+    curlEasySetoptWrapper(curl_handle_, CURLOPT_UPLOAD_BUFFERSIZE, kUploadBufferSize);
+  }
+#endif
 
   curlEasySetoptWrapper(curl_handle_, CURLOPT_PRIVATE, this);  // Used by ostree_object_from_curl
   const CURLMcode err = curl_multi_add_handle(curl_multi_handle, curl_handle_);
   if (err != 0) {
-    LOG_ERROR << "curl_multi_add_handle error:" << curl_multi_strerror(err);
-    return;
+    RequestNotStarted(err);
+    return false;
   }
   refcount_++;  // Because curl now has a reference to us
   request_start_time_ = std::chrono::steady_clock::now();
+  return true;
 }
 
 void OSTreeObject::CheckChildren(RequestPool &pool, const long rescode) {  // NOLINT(google-runtime-int)
+  // The contents are needed to upload the object or to find its children.
+  // FetchDone() comes back here once they are available.
+  if (!fetched_ && (rescode != 200 || HasChildren())) {
+    pool.AddFetch(this);
+    return;
+  }
   try {
-    PopulateChildren();
+    // Parsing is left to the object graph's workers if there is one, the
+    // pool comes back with ParseDone() once they are done with this object.
+    if (!PopulateChildren()) {
+      pool.AddParseWait(this);
+      return;
+    }
     LOG_TRACE << "Children of " << object_name_ << ": " << children_.size();
     if (children_ready()) {
       if (rescode != 200) {
@@ -287,6 +344,91 @@ void OSTreeObject::UploadError(RequestPool &pool, const int64_t rescode) {
   pool.AddUpload(this);
 }
 
+void OSTreeObject::FetchDone(RequestPool &pool, const int64_t rescode) {
+  // See QueryChildren(): the fetch may stand in for a presence check.
+  const bool presence_check =
+      pool.run_mode() == RunMode::kCheckTree && is_on_server_ == PresenceOnServer::kObjectInProgress;
+  boost::system::error_code ec;
+  if (rescode == 200) {
+    boost::filesystem::rename(PartialPath(), file_path_, ec);
+    if (!ec) {
+      LOG_DEBUG << "Fetched OSTree object " << object_name_;
+      fetched_ = true;
+      last_operation_result_ = ServerResponse::kOk;
+      if (presence_check) {
+        is_on_server_ = PresenceOnServer::kObjectPresent;
+        pool.ObjectChecked(*this, true);
+      }
+      CheckChildren(pool, is_on_server_ == PresenceOnServer::kObjectPresent ? 200 : 404);
+      return;
+    }
+    LOG_ERROR << "Could not store fetched object " << object_name_ << ": " << ec.message();
+  }
+  boost::filesystem::remove(PartialPath(), ec);
+
+  if (presence_check && rescode == 404) {
+    is_on_server_ = PresenceOnServer::kObjectMissing;
+    last_operation_result_ = ServerResponse::kOk;
+    pool.ObjectChecked(*this, false);
+    return;
+  }
+
+  // Same number of attempts as OSTreeRepo::GetObject() makes.
+  last_operation_result_ = ServerResponse::kTemporaryFailure;
+  if (++fetch_attempts_ >= 3) {
+    LOG_ERROR << "Source OSTree repo does not contain object " << object_name_ << " (HTTP " << rescode << ")";
+    pool.Abort();
+    return;
+  }
+  LOG_WARNING << "OSTree fetch of " << object_name_ << " reported an error code: " << rescode << ". Retrying (attempt "
+              << fetch_attempts_ << " of 3)";
+  pool.AddFetch(this, true);
+}
+
+void OSTreeObject::Uploaded(RequestPool &pool) {
+  is_on_server_ = PresenceOnServer::kObjectPresent;
+  last_operation_result_ = ServerResponse::kOk;
+  pool.ObjectUploaded(GetSize());
+  NotifyParents(pool);
+}
+
+bool OSTreeObject::ChildrenParsed() const {
+  const ObjectGraph *graph = repo_.object_graph();
+  return graph == nullptr || graph->Parsed(Hash());
+}
+
+void OSTreeObject::WaitForParsing(const std::chrono::milliseconds timeout) const {
+  const ObjectGraph *graph = repo_.object_graph();
+  if (graph != nullptr) {
+    graph->WaitForProgress(timeout);
+  }
+}
+
+void OSTreeObject::ParseDone(RequestPool &pool) {
+  CheckChildren(pool, is_on_server_ == PresenceOnServer::kObjectPresent ? 200 : 404);
+}
+
+void OSTreeObject::PresenceKnown(RequestPool &pool, const bool present) {
+  last_operation_result_ = ServerResponse::kOk;
+  pool.ObjectChecked(*this, present);
+  if (present) {
+    LOG_INFO << "Already present: " << object_name_;
+    is_on_server_ = PresenceOnServer::kObjectPresent;
+    if (pool.run_mode() == RunMode::kWalkTree || pool.run_mode() == RunMode::kPushTree ||
+        pool.run_mode() == RunMode::kCheckTree) {
+      CheckChildren(pool, 200);
+    } else {
+      NotifyParents(pool);
+    }
+  } else {
+    is_on_server_ = PresenceOnServer::kObjectMissing;
+    // There is nothing to upload or fetch it from when checking a tree.
+    if (pool.run_mode() != RunMode::kCheckTree) {
+      CheckChildren(pool, 404);
+    }
+  }
+}
+
 void OSTreeObject::CurlDone(CURLM *curl_multi_handle, RequestPool &pool) {
   refcount_--;            // Because curl now doesn't have a reference to us
   assert(refcount_ > 0);  // At least our parent should have a reference to us
@@ -301,19 +443,8 @@ void OSTreeObject::CurlDone(CURLM *curl_multi_handle, RequestPool &pool) {
     // NOLINTNEXTLINE(bugprone-branch-clone)
     if (url == nullptr || strstr(url, object_name_.c_str()) == nullptr) {
       PresenceError(pool, rescode);
-    } else if (rescode == 200) {
-      LOG_INFO << "Already present: " << object_name_;
-      is_on_server_ = PresenceOnServer::kObjectPresent;
-      last_operation_result_ = ServerResponse::kOk;
-      if (pool.run_mode() == RunMode::kWalkTree || pool.run_mode() == RunMode::kPushTree) {
-        CheckChildren(pool, rescode);
-      } else {
-        NotifyParents(pool);
-      }
-    } else if (rescode == 404) {
-      is_on_server_ = PresenceOnServer::kObjectMissing;
-      last_operation_result_ = ServerResponse::kOk;
-      CheckChildren(pool, rescode);
+    } else if (rescode == 200 || rescode == 404) {
+      PresenceKnown(pool, rescode == 200);
     } else {
       PresenceError(pool, rescode);
     }
@@ -326,24 +457,30 @@ void OSTreeObject::CurlDone(CURLM *curl_multi_handle, RequestPool &pool) {
       UploadError(pool, rescode);
     } else if (rescode == 204) {
       LOG_TRACE << "OSTree upload successful";
-      is_on_server_ = PresenceOnServer::kObjectPresent;
-      last_operation_result_ = ServerResponse::kOk;
-      NotifyParents(pool);
+      Uploaded(pool);
     } else if (rescode == 409) {
       LOG_DEBUG << "OSTree upload reported a 409 Conflict, possibly due to concurrent uploads";
-      is_on_server_ = PresenceOnServer::kObjectPresent;
-      last_operation_result_ = ServerResponse::kOk;
-      NotifyParents(pool);
+      Uploaded(pool);
     } else {
       UploadError(pool, rescode);
     }
+    ReleaseUploadSource();
+  } else if (current_operation_ == CurrentOp::kOstreeObjectFetching) {
     fclose(fd_);
+    fd_ = nullptr;
+    // Sanity-check the handle's URL to make sure it contains the expected
+    // object hash.
+    if (url == nullptr || strstr(url, object_name_.c_str()) == nullptr) {
+      FetchDone(pool, 0);
+    } else {
+      FetchDone(pool, rescode);
+    }
   } else {
     LOG_ERROR << "Unknown operation: " << static_cast<int>(current_operation_);
     assert(0);
   }
   curl_multi_remove_handle(curl_multi_handle, curl_handle_);
-  curl_easy_cleanup(curl_handle_);
+  pool.ReleaseHandle(curl_handle_);
   curl_handle_ = nullptr;
 }
 
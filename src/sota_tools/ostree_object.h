@@ -8,9 +8,11 @@
 #include <curl/curl.h>
 #include <boost/filesystem.hpp>
 #include <boost/intrusive_ptr.hpp>
+#include <boost/optional.hpp>
 #include "gtest/gtest_prod.h"
 
 #include "garage_common.h"
+#include "ostree_hash.h"
 #include "treehub_server.h"
 
 class OSTreeRepo;
@@ -18,7 +20,7 @@ class RequestPool;
 
 enum class PresenceOnServer { kObjectStateUnknown, kObjectPresent, kObjectMissing, kObjectInProgress };
 
-enum class CurrentOp { kOstreeObjectUploading, kOstreeObjectPresenceCheck };
+enum class CurrentOp { kOstreeObjectUploading, kOstreeObjectPresenceCheck, kOstreeObjectFetching };
 
 /**
  * Broad categories for server response codes.
@@ -30,7 +32,10 @@ enum class ServerResponse { kNoResponse, kOk, kTemporaryFailure };
 class OSTreeObject {
  public:
   using ptr = boost::intrusive_ptr<OSTreeObject>;
-  OSTreeObject(const OSTreeRepo& repo, const std::string& object_name);
+  /* If `fetched` is false, the object is not in the (remote) source repository's
+   * local storage yet and is fetched with Fetch() once its contents are
+   * needed. */
+  OSTreeObject(const OSTreeRepo& repo, const std::string& object_name, bool fetched = true);
   OSTreeObject(const OSTreeObject&) = delete;
   OSTreeObject operator=(const OSTreeObject&) = delete;
 
@@ -41,21 +46,54 @@ class OSTreeObject {
   void NotifyParents(RequestPool& pool);
 
   /* Send a HEAD request to the destination server to check if this object is
-   * present there. */
-  void MakeTestRequest(const TreehubServer& push_target, CURLM* curl_multi_handle);
+   * present there. Like Fetch() and Upload(), this uses `curl_handle` if it is
+   * given and a new easy handle otherwise, and returns false if curl did not
+   * take the request. The handle is then freed and the object can be queued
+   * again. */
+  bool MakeTestRequest(const TreehubServer& push_target, CURLM* curl_multi_handle, CURL* curl_handle = nullptr);
+
+  /* Download this object from the source repository into its local storage. */
+  bool Fetch(CURLM* curl_multi_handle, CURL* curl_handle = nullptr);
 
   /* Upload this object to the destination server. */
-  void Upload(TreehubServer& push_target, CURLM* curl_multi_handle, RunMode mode);
+  bool Upload(TreehubServer& push_target, CURLM* curl_multi_handle, RunMode mode, CURL* curl_handle = nullptr);
 
-  /* Process a completed curl transaction (presence check or upload). */
+  /* Process a completed curl transaction (presence check, upload or fetch).
+   * The easy handle is given back to the pool. */
   void CurlDone(CURLM* curl_multi_handle, RequestPool& pool);
 
+  /* Process the answer to a presence check, either from a HEAD request or
+   * from a batched query. */
+  void PresenceKnown(RequestPool& pool, bool present);
+
+  /* The object has been stored on the server, either by Upload() or as part
+   * of a bulk upload. Notify the parents. */
+  void Uploaded(RequestPool& pool);
+
+  /* Whether the children of this object can be read without waiting for the
+   * repository's object graph. */
+  bool ChildrenParsed() const;
+
+  /* Wait at most `timeout` for the repository's object graph to parse more
+   * objects. */
+  void WaitForParsing(std::chrono::milliseconds timeout) const;
+
+  /* Carry on with this object once ChildrenParsed() is true. */
+  void ParseDone(RequestPool& pool);
+
   uintmax_t GetSize() { return boost::filesystem::file_size(file_path_); }
 
+  const std::string& name() const { return object_name_; }
+  /* The type of this object, from the extension of its name. */
+  OstreeObjectType Type() const;
+  const boost::filesystem::path& file_path() const { return file_path_; }
   PresenceOnServer is_on_server() const { return is_on_server_; }
   CurrentOp operation() const { return current_operation_; }
   bool children_ready() { return children_.empty(); }
+  bool fetched() const { return fetched_; }
   void LaunchNotify() { is_on_server_ = PresenceOnServer::kObjectInProgress; }
+  /* Take the object as present on the server without asking it. */
+  void AssumePresent() { is_on_server_ = PresenceOnServer::kObjectPresent; }
   std::chrono::steady_clock::time_point RequestStartTime() const { return request_start_time_; }
   ServerResponse LastOperationResult() const { return last_operation_result_; }
 
@@ -73,8 +111,9 @@ class OSTreeObject {
    * of children and add this object as the parent of the new child. */
   void AppendChild(const OSTreeObject::ptr& child);
 
-  /* Parse this object for children. */
-  void PopulateChildren();
+  /* Parse this object for children, or take them from the repository's object
+   * graph. Returns false if the graph has not parsed this object yet. */
+  bool PopulateChildren();
 
   /* Add queries to the queue for any children whose presence on the server is
    * unknown. */
@@ -92,8 +131,37 @@ class OSTreeObject {
   /* Handle an error from an upload. */
   void UploadError(RequestPool& pool, int64_t rescode);
 
+  /* Take `curl_handle` (a reset handle from a CurlHandlePool), or a new
+   * handle if it is null, for the next request. */
+  void InitCurlHandle(CURL* curl_handle);
+
+  /* Undo InitCurlHandle() and the request setup after curl refused it. */
+  void RequestNotStarted(CURLMcode err);
+
+  /* Handle the result of a fetch. */
+  void FetchDone(RequestPool& pool, int64_t rescode);
+
+  /* Whether this object type references other objects. */
+  bool HasChildren() const;
+
+  /* The digest of this object, from its name. It is parsed once. */
+  OSTreeHash Hash() const;
+
+  /* Map the object into memory as the body of an upload. Returns false if it
+   * can not be mapped, the upload then reads it with stdio. */
+  bool MapForUpload(size_t size);
+
+  /* Unmap or close the object once its upload has completed. */
+  void ReleaseUploadSource();
+
+  /* Where a fetch is written until it is complete. */
+  boost::filesystem::path PartialPath() const { return file_path_.string() + ".part"; }
+
   static size_t curl_handle_write(void* buffer, size_t size, size_t nmemb, void* userp);
 
+  // Objects larger than this are sent with this much data per write
+  static constexpr long kUploadBufferSize = 512 * 1024;  // NOLINT(google-runtime-int)
+
   FRIEND_TEST(OstreeObject, Request);
   FRIEND_TEST(OstreeObject, UploadDryRun);
   FRIEND_TEST(OstreeObject, UploadFail);
@@ -113,12 +181,17 @@ class OSTreeObject {
   std::stringstream http_response_;
   CURL* curl_handle_;
   FILE* fd_;
+  void* upload_map_{nullptr};
+  size_t upload_map_size_{0};
+  bool fetched_;
+  int fetch_attempts_{0};
   std::list<parentref> parents_;
   std::list<OSTreeObject::ptr> children_;
 
   std::chrono::steady_clock::time_point request_start_time_;
   ServerResponse last_operation_result_{ServerResponse::kNoResponse};
   OstreeObjectType type_{OstreeObjectType::OSTREE_OBJECT_TYPE_UNKNOWN};
+  mutable boost::optional<OSTreeHash> hash_;
 };
 
 OSTreeObject::ptr ostree_object_from_curl(CURL* curlhandle);
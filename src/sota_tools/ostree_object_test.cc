@@ -123,7 +123,7 @@ TEST(OstreeObject, UploadFail) {
 
   object->is_on_server_ = PresenceOnServer::kObjectStateUnknown;
   object->current_operation_ = CurrentOp::kOstreeObjectPresenceCheck;
-  object->Upload(push_server, nullptr, RunMode::kDefault);
+  EXPECT_FALSE(object->Upload(push_server, nullptr, RunMode::kDefault));
   EXPECT_EQ(object->is_on_server_, PresenceOnServer::kObjectStateUnknown);
   EXPECT_EQ(object->current_operation_, CurrentOp::kOstreeObjectUploading);
 }
@@ -188,6 +188,58 @@ TEST(OstreeObject, UploadSuccess) {
   curl_global_cleanup();
 }
 
+/* Walk a tree whose objects are all on the server. The commit object is
+ * queried alone with a HEAD request, the children of the commit and of the
+ * root directory are each queried with a single batched request. */
+TEST(OstreeObject, BatchedQueries) {
+  TreehubServer push_server;
+  push_server.root_url("http://localhost:" + port);
+
+  OSTreeRepo::ptr src_repo = std::make_shared<OSTreeDirRepo>(repo_path);
+  OSTreeHash hash = src_repo->GetRef("master").GetHash();
+  OSTreeObject::ptr object = src_repo->GetObject(hash, OstreeObjectType::OSTREE_OBJECT_TYPE_COMMIT);
+
+  RequestPool request_pool(push_server, 4, RunMode::kWalkTree);
+  request_pool.AddQuery(object);
+  do {
+    request_pool.Loop();
+  } while (!request_pool.is_idle() && !request_pool.is_stopped());
+
+  EXPECT_FALSE(request_pool.is_stopped());
+  EXPECT_EQ(object->is_on_server(), PresenceOnServer::kObjectPresent);
+  EXPECT_TRUE(request_pool.batch_queries());
+  EXPECT_EQ(request_pool.head_requests_made(), 1);
+  EXPECT_EQ(request_pool.batch_requests_made(), 2);
+}
+
+/* Fall back to HEAD requests if the server does not support batched queries. */
+TEST(OstreeObject, BatchedQueriesUnsupported) {
+  const std::string dp = TestUtils::getFreePort();
+  boost::process::child server_process("tests/sota_tools/treehub_server.py", std::string("-p"), dp,
+                                       std::string("-d"), repo_path, std::string("--no-batch-query"));
+  TestUtils::waitForServer("http://localhost:" + dp + "/");
+
+  TreehubServer push_server;
+  push_server.root_url("http://localhost:" + dp);
+
+  OSTreeRepo::ptr src_repo = std::make_shared<OSTreeDirRepo>(repo_path);
+  OSTreeHash hash = src_repo->GetRef("master").GetHash();
+  OSTreeObject::ptr object = src_repo->GetObject(hash, OstreeObjectType::OSTREE_OBJECT_TYPE_COMMIT);
+
+  RequestPool request_pool(push_server, 4, RunMode::kWalkTree);
+  request_pool.AddQuery(object);
+  do {
+    request_pool.Loop();
+  } while (!request_pool.is_idle() && !request_pool.is_stopped());
+
+  EXPECT_FALSE(request_pool.is_stopped());
+  EXPECT_EQ(object->is_on_server(), PresenceOnServer::kObjectPresent);
+  EXPECT_FALSE(request_pool.batch_queries());
+  EXPECT_EQ(request_pool.batch_requests_made(), 1);
+  // the commit, its dirtree and dirmeta and the ten files of the tree
+  EXPECT_EQ(request_pool.head_requests_made(), 13);
+}
+
 #ifndef __NO_MAIN__
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
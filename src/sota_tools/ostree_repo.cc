@@ -1,22 +1,46 @@
 #include "ostree_repo.h"
 
+#include <array>
+#include <stdexcept>
+
+#include "crypto/crypto.h"
 #include "logging/logging.h"
+#include "push_state_cache.h"
+#include "utilities/utils.h"
 
 // NOLINTNEXTLINE(modernize-avoid-c-arrays, cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays)
 OSTreeObject::ptr OSTreeRepo::GetObject(const uint8_t sha256[32], const OstreeObjectType type) const {
   return GetObject(OSTreeHash(sha256), type);
 }
 
+namespace {
+// In the order they are tried when the type of an object is unknown.
+const std::array<OstreeObjectType, 4> known_types{
+    {OstreeObjectType::OSTREE_OBJECT_TYPE_FILE, OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_TREE,
+     OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_META, OstreeObjectType::OSTREE_OBJECT_TYPE_COMMIT}};
+
+const char *Extension(const OstreeObjectType type) {
+  switch (type) {
+    case OstreeObjectType::OSTREE_OBJECT_TYPE_FILE:
+      return ".filez";
+    case OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_TREE:
+      return ".dirtree";
+    case OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_META:
+      return ".dirmeta";
+    case OstreeObjectType::OSTREE_OBJECT_TYPE_COMMIT:
+      return ".commit";
+    default:
+      throw std::out_of_range("Unsupported OSTree object type");
+  }
+}
+}  // namespace
+
 OSTreeObject::ptr OSTreeRepo::GetObject(const OSTreeHash hash, const OstreeObjectType type) const {
   otable::const_iterator obj_it = ObjectTable.find(hash);
   if (obj_it != ObjectTable.cend()) {
     return obj_it->second;
   }
 
-  const std::map<OstreeObjectType, std::string> exts{{OstreeObjectType::OSTREE_OBJECT_TYPE_FILE, ".filez"},
-                                                     {OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_TREE, ".dirtree"},
-                                                     {OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_META, ".dirmeta"},
-                                                     {OstreeObjectType::OSTREE_OBJECT_TYPE_COMMIT, ".commit"}};
   const std::string objpath = hash.string().insert(2, 1, '/');
   OSTreeObject::ptr object;
 
@@ -25,12 +49,12 @@ OSTreeObject::ptr OSTreeRepo::GetObject(const OSTreeHash hash, const OstreeObjec
       LOG_WARNING << "OSTree hash " << hash << " not found. Retrying (attempt " << i << " of 3)";
     }
     if (type != OstreeObjectType::OSTREE_OBJECT_TYPE_UNKNOWN) {
-      if (CheckForObject(hash, objpath + exts.at(type), object)) {
+      if (CheckForObject(hash, objpath + Extension(type), object)) {
         return object;
       }
     } else {
-      for (auto it = exts.cbegin(); it != exts.cend(); ++it) {
-        if (CheckForObject(hash, objpath + it->second, object)) {
+      for (const OstreeObjectType known_type : known_types) {
+        if (CheckForObject(hash, objpath + Extension(known_type), object)) {
           return object;
         }
       }
@@ -39,12 +63,64 @@ OSTreeObject::ptr OSTreeRepo::GetObject(const OSTreeHash hash, const OstreeObjec
   throw OSTreeObjectMissing(hash);
 }
 
+OSTreeObject::ptr OSTreeRepo::GetChildObject(const OSTreeHash &hash, const OstreeObjectType type) const {
+  if (!FetchesOnDemand()) {
+    return GetObject(hash, type);
+  }
+  otable::const_iterator obj_it = ObjectTable.find(hash);
+  if (obj_it != ObjectTable.cend()) {
+    return obj_it->second;
+  }
+  // The type of a child is always known from its parent.
+  const std::string path = hash.string().insert(2, 1, '/') + Extension(type);
+  const boost::filesystem::path local_path = root() / "objects" / path;
+  bool stored = boost::filesystem::is_regular_file(local_path);
+  // A metadata object left by an earlier run is only used if it is intact: its
+  // name is the digest of its contents.
+  if (stored && type != OstreeObjectType::OSTREE_OBJECT_TYPE_FILE) {
+    const std::string digest = Crypto::sha256digest(Utils::readFile(local_path));
+    stored = OSTreeHash(reinterpret_cast<const uint8_t *>(digest.data())) == hash;
+    if (!stored) {
+      LOG_WARNING << "Stored OSTree object " << path << " is corrupt, fetching it again";
+    }
+  }
+  return AddObject(hash, path, stored);
+}
+
+void OSTreeRepo::InjectFetchIntoCurl(const std::string &path, CURL *curl_handle) const {
+  (void)path;
+  (void)curl_handle;
+  throw std::runtime_error("OSTree repository does not fetch objects on demand");
+}
+
 bool OSTreeRepo::CheckForObject(const OSTreeHash &hash, const std::string &path, OSTreeObject::ptr &object) const {
   if (FetchObject(std::string("objects/") + path)) {
-    object = OSTreeObject::ptr(new OSTreeObject(*this, path));
-    ObjectTable[hash] = object;
+    object = AddObject(hash, path, true);
     LOG_DEBUG << "Fetched OSTree object " << path;
     return true;
   }
   return false;
 }
+
+OSTreeObject::ptr OSTreeRepo::AddObject(const OSTreeHash &hash, const std::string &path, const bool fetched) const {
+  OSTreeObject::ptr object(new OSTreeObject(*this, path, fetched));
+  // Commits are always queried: the ref is pointed at the pushed commit
+  // afterwards, it must not rely on an entry the server may have pruned.
+  if (push_state_cache_ != nullptr && object->Type() != OstreeObjectType::OSTREE_OBJECT_TYPE_COMMIT &&
+      push_state_cache_->Assume(path)) {
+    LOG_DEBUG << "Known to be on the server: " << path;
+    object->AssumePresent();
+  }
+  ObjectTable[hash] = object;
+  return object;
+}
+
+std::vector<std::string> OSTreeRepo::ObjectsOnServer() const {
+  std::vector<std::string> names;
+  for (const auto &entry : ObjectTable) {
+    if (entry.second->is_on_server() == PresenceOnServer::kObjectPresent) {
+      names.push_back(entry.second->name());
+    }
+  }
+  return names;
+}
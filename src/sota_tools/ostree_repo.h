@@ -1,8 +1,10 @@
 #ifndef SOTA_CLIENT_TOOLS_OSTREE_REPO_H_
 #define SOTA_CLIENT_TOOLS_OSTREE_REPO_H_
 
-#include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <boost/filesystem.hpp>
 
@@ -10,7 +12,9 @@
 #include "ostree_hash.h"
 #include "ostree_object.h"
 
+class ObjectGraph;
 class OSTreeRef;
+class PushStateCache;
 
 /**
  * A source repository to read OSTree objects from. This can be either a directory
@@ -30,13 +34,41 @@ class OSTreeRepo {
   // NOLINTNEXTLINE(modernize-avoid-c-arrays)
   OSTreeObject::ptr GetObject(const uint8_t sha256[32], OstreeObjectType type) const;
 
+  /* Get an object referenced by another object of this repository. Unlike
+   * GetObject(), this does not wait for the object to be fetched if the
+   * repository fetches objects on demand (see FetchesOnDemand()). */
+  OSTreeObject::ptr GetChildObject(const OSTreeHash& hash, OstreeObjectType type) const;
+
+  /* True if the objects of this repository are downloaded by the request pool
+   * as they are needed, rather than one by one in GetObject(). */
+  virtual bool FetchesOnDemand() const { return false; }
+
+  /* Set up a curl handle to download the object at `path` (relative to the
+   * objects directory) from this repository. */
+  virtual void InjectFetchIntoCurl(const std::string& path, CURL* curl_handle) const;
+
+  /* Objects read from now on that the cache knows to be on the push server
+   * start out as present. */
+  void SetPushStateCache(std::shared_ptr<PushStateCache> cache) { push_state_cache_ = std::move(cache); }
+
+  /* Names of the objects read so far that are known to be on the push server. */
+  std::vector<std::string> ObjectsOnServer() const;
+
+  /* Take the children of commits and dirtrees from `graph` rather than
+   * parsing them when they are needed. Pass nullptr to parse them again. */
+  void SetObjectGraph(std::shared_ptr<ObjectGraph> graph) { object_graph_ = std::move(graph); }
+  ObjectGraph* object_graph() const { return object_graph_.get(); }
+
  protected:
   virtual bool FetchObject(const boost::filesystem::path& path) const = 0;
 
   bool CheckForObject(const OSTreeHash& hash, const std::string& path, OSTreeObject::ptr& object) const;
+  OSTreeObject::ptr AddObject(const OSTreeHash& hash, const std::string& path, bool fetched) const;
 
-  typedef std::map<OSTreeHash, OSTreeObject::ptr> otable;
+  typedef std::unordered_map<OSTreeHash, OSTreeObject::ptr, OSTreeHash::Hasher> otable;
   mutable otable ObjectTable;  // Makes sure that the same commit object is not added twice
+  std::shared_ptr<PushStateCache> push_state_cache_;
+  std::shared_ptr<ObjectGraph> object_graph_;
 };
 
 /**
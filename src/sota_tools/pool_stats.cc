@@ -0,0 +1,82 @@
+#include "pool_stats.h"
+
+#include <iomanip>
+#include <sstream>
+
+#include "utilities/utils.h"
+
+double PoolStats::ObjectsPerSecond() const {
+  if (elapsed_seconds <= 0.0) {
+    return 0.0;
+  }
+  return (objects_checked + objects_uploaded + objects_fetched) / elapsed_seconds;
+}
+
+double PoolStats::UploadBytesPerSecond() const {
+  if (elapsed_seconds <= 0.0) {
+    return 0.0;
+  }
+  return static_cast<double>(bytes_uploaded) / elapsed_seconds;
+}
+
+double PoolStats::EtaSeconds() const {
+  const double rate = ObjectsPerSecond();
+  if (rate <= 0.0) {
+    return -1.0;
+  }
+  const size_t remaining = queued_queries + queued_uploads + queued_fetches + waiting_for_parse +
+                           static_cast<size_t>(in_flight_objects);
+  return static_cast<double>(remaining) / rate;
+}
+
+std::string PoolStats::ToString() const {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(1) << elapsed_seconds << " s: " << objects_checked << " objects checked, "
+      << objects_uploaded << " uploaded (" << bytes_uploaded << " bytes), " << objects_fetched << " fetched; "
+      << ObjectsPerSecond() << " objects/s, " << UploadBytesPerSecond() / 1024.0 << " KB/s uploaded; "
+      << running_requests << " requests running (limit " << max_concurrency << "); queued: " << queued_queries
+      << " queries, " << queued_uploads << " uploads, " << queued_fetches << " fetches";
+  if (waiting_for_parse > 0) {
+    out << ", " << waiting_for_parse << " waiting for parsing";
+  }
+  out << "; " << failed_requests << " failed requests";
+  const double eta = EtaSeconds();
+  if (eta >= 0.0) {
+    out << "; ETA " << eta << " s";
+  }
+  return out.str();
+}
+
+Json::Value PoolStats::ToJson() const {
+  Json::Value json;
+  json["elapsed_seconds"] = elapsed_seconds;
+  json["objects"]["checked"] = objects_checked;
+  json["objects"]["uploaded"] = objects_uploaded;
+  json["objects"]["fetched"] = objects_fetched;
+  json["bytes"]["uploaded"] = static_cast<Json::UInt64>(bytes_uploaded);
+  json["bytes"]["fetched"] = static_cast<Json::UInt64>(bytes_fetched);
+  json["requests"]["head"] = head_requests;
+  json["requests"]["upload"] = upload_requests;
+  json["requests"]["batched_query"] = batch_requests;
+  json["requests"]["bulk_upload"] = bulk_requests;
+  json["requests"]["fetch"] = fetch_requests;
+  json["requests"]["failed"] = failed_requests;
+  json["objects_per_second"] = ObjectsPerSecond();
+  json["upload_bytes_per_second"] = UploadBytesPerSecond();
+  json["concurrency"]["running"] = running_requests;
+  json["concurrency"]["limit"] = max_concurrency;
+  json["queues"]["query"] = static_cast<Json::UInt64>(queued_queries);
+  json["queues"]["upload"] = static_cast<Json::UInt64>(queued_uploads);
+  json["queues"]["fetch"] = static_cast<Json::UInt64>(queued_fetches);
+  json["queues"]["parse_wait"] = static_cast<Json::UInt64>(waiting_for_parse);
+  json["aborted"] = aborted;
+  return json;
+}
+
+void PoolStats::WriteJson(const boost::filesystem::path &path, const bool success) const {
+  Json::Value json = ToJson();
+  json["success"] = success;
+  Utils::writeFile(path, json);
+}
+
+// vim: set tabstop=2 shiftwidth=2 expandtab:
@@ -0,0 +1,60 @@
+#ifndef SOTA_CLIENT_TOOLS_POOL_STATS_H_
+#define SOTA_CLIENT_TOOLS_POOL_STATS_H_
+
+#include <cstdint>
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include "json/json.h"
+
+/**
+ * A snapshot of the work done and queued by a RequestPool. The pool logs one
+ * periodically while it runs; the garage tools can write the last one as a
+ * JSON summary (--stats-json).
+ */
+struct PoolStats {
+  double elapsed_seconds{0.0};
+
+  int objects_checked{0};   // presence answers from the server
+  int objects_uploaded{0};  // confirmed by the server, singly or in bulk
+  int objects_fetched{0};   // from the source repository
+  uintmax_t bytes_uploaded{0};
+  uintmax_t bytes_fetched{0};
+
+  int head_requests{0};
+  int upload_requests{0};
+  int batch_requests{0};
+  int bulk_requests{0};
+  int fetch_requests{0};
+  int failed_requests{0};  // error responses and failed transfers, retried unless the pool gives up
+
+  int running_requests{0};
+  int max_concurrency{0};  // the current limit set by the rate controller
+
+  size_t queued_queries{0};
+  size_t queued_uploads{0};
+  size_t queued_fetches{0};
+  size_t waiting_for_parse{0};
+  int in_flight_objects{0};
+
+  bool aborted{false};
+
+  double ObjectsPerSecond() const;
+  double UploadBytesPerSecond() const;
+
+  /* Seconds left for the queued and running work at the rate so far, or a
+   * negative value if nothing has completed yet. While a tree is walked, more
+   * work is found as it goes: this is a lower bound. */
+  double EtaSeconds() const;
+
+  /* One line for the log. */
+  std::string ToString() const;
+
+  Json::Value ToJson() const;
+
+  /* Write ToJson() to `path`, with the outcome of the whole run. */
+  void WriteJson(const boost::filesystem::path& path, bool success) const;
+};
+
+// vim: set tabstop=2 shiftwidth=2 expandtab:
+#endif  // SOTA_CLIENT_TOOLS_POOL_STATS_H_
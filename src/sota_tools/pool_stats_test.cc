@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include "pool_stats.h"
+
+/* Nothing has completed yet: no rate and no ETA. */
+TEST(PoolStats, NoProgress) {
+  PoolStats stats;
+  stats.queued_queries = 1;
+  EXPECT_EQ(stats.ObjectsPerSecond(), 0.0);
+  EXPECT_LT(stats.EtaSeconds(), 0.0);
+  EXPECT_EQ(stats.ToString().find("ETA"), std::string::npos);
+}
+
+/* The ETA covers the queued and in-flight work at the rate so far. */
+TEST(PoolStats, Eta) {
+  PoolStats stats;
+  stats.elapsed_seconds = 10.0;
+  stats.objects_checked = 60;
+  stats.objects_uploaded = 40;
+  stats.bytes_uploaded = 40 * 1024;
+  stats.queued_queries = 30;
+  stats.queued_uploads = 10;
+  stats.in_flight_objects = 10;
+  EXPECT_DOUBLE_EQ(stats.ObjectsPerSecond(), 10.0);
+  EXPECT_DOUBLE_EQ(stats.UploadBytesPerSecond(), 4096.0);
+  EXPECT_DOUBLE_EQ(stats.EtaSeconds(), 5.0);
+  EXPECT_NE(stats.ToString().find("ETA 5.0 s"), std::string::npos);
+}
+
+/* The JSON summary has the counters and the rates. */
+TEST(PoolStats, Json) {
+  PoolStats stats;
+  stats.elapsed_seconds = 2.0;
+  stats.objects_uploaded = 4;
+  stats.bytes_uploaded = 5000000000;
+  stats.bulk_requests = 1;
+  stats.failed_requests = 3;
+  stats.max_concurrency = 30;
+  stats.queued_fetches = 2;
+  const Json::Value json = stats.ToJson();
+  EXPECT_EQ(json["objects"]["uploaded"].asInt(), 4);
+  EXPECT_EQ(json["bytes"]["uploaded"].asUInt64(), 5000000000u);
+  EXPECT_EQ(json["requests"]["bulk_upload"].asInt(), 1);
+  EXPECT_EQ(json["requests"]["failed"].asInt(), 3);
+  EXPECT_EQ(json["concurrency"]["limit"].asInt(), 30);
+  EXPECT_EQ(json["queues"]["fetch"].asUInt64(), 2u);
+  EXPECT_DOUBLE_EQ(json["objects_per_second"].asDouble(), 2.0);
+  EXPECT_FALSE(json["aborted"].asBool());
+}
+
+#ifndef __NO_MAIN__
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+#endif
+
+// vim: set tabstop=2 shiftwidth=2 expandtab:
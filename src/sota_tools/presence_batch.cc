@@ -0,0 +1,105 @@
+#include "presence_batch.h"
+
+#include <cassert>
+
+#include "logging/logging.h"
+#include "request_pool.h"
+#include "utilities/utils.h"
+
+PresenceBatch::PresenceBatch(std::vector<OSTreeObject::ptr> objects) : objects_(std::move(objects)) {}
+
+PresenceBatch::~PresenceBatch() {
+  if (curl_handle_ != nullptr) {
+    curl_easy_cleanup(curl_handle_);
+    curl_handle_ = nullptr;
+  }
+}
+
+std::string PresenceBatch::RequestBody(const std::vector<OSTreeObject::ptr>& objects) {
+  Json::Value body;
+  body["objects"] = Json::Value(Json::arrayValue);
+  for (const auto& object : objects) {
+    body["objects"].append(object->name());
+  }
+  return Utils::jsonToCanonicalStr(body);
+}
+
+bool PresenceBatch::ParseResponse(const std::string& response, std::set<std::string>* missing) {
+  const Json::Value json = Utils::parseJSON(response);
+  if (!json.isObject() || !json["missing"].isArray()) {
+    return false;
+  }
+  for (const auto& name : json["missing"]) {
+    if (!name.isString()) {
+      return false;
+    }
+    missing->insert(name.asString());
+  }
+  return true;
+}
+
+bool PresenceBatch::MakeRequest(const TreehubServer& push_target, CURLM* curl_multi_handle, CURL* curl_handle) {
+  assert(!curl_handle_);
+  curl_handle_ = curl_handle != nullptr ? curl_handle : curl_easy_init();
+  if (curl_handle_ == nullptr) {
+    throw std::runtime_error("Could not initialize curl handle");
+  }
+  curlEasySetoptWrapper(curl_handle_, CURLOPT_VERBOSE, get_curlopt_verbose());
+
+  request_body_ = RequestBody(objects_);
+  push_target.InjectJsonIntoCurl("objects/missing", curl_handle_);
+  curlEasySetoptWrapper(curl_handle_, CURLOPT_USERAGENT, Utils::getUserAgent());
+  curlEasySetoptWrapper(curl_handle_, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(request_body_.size()));
+  curlEasySetoptWrapper(curl_handle_, CURLOPT_POSTFIELDS, request_body_.c_str());
+  curlEasySetoptWrapper(curl_handle_, CURLOPT_WRITEFUNCTION, &PresenceBatch::curl_handle_write);
+  curlEasySetoptWrapper(curl_handle_, CURLOPT_WRITEDATA, this);
+  http_response_.str("");
+
+  const CURLMcode err = curl_multi_add_handle(curl_multi_handle, curl_handle_);
+  if (err != 0) {
+    LOG_ERROR << "curl_multi_add_handle error:" << curl_multi_strerror(err);
+    return false;
+  }
+  request_start_time_ = std::chrono::steady_clock::now();
+  return true;
+}
+
+PresenceBatch::Outcome PresenceBatch::CurlDone(CURLM* curl_multi_handle, RequestPool& pool) {
+  long rescode = 0;  // NOLINT(google-runtime-int)
+  curl_easy_getinfo(curl_handle_, CURLINFO_RESPONSE_CODE, &rescode);
+  curl_multi_remove_handle(curl_multi_handle, curl_handle_);
+  pool.ReleaseHandle(curl_handle_);
+  curl_handle_ = nullptr;
+
+  std::set<std::string> missing;
+  if (rescode == 200 && ParseResponse(http_response_.str(), &missing)) {
+    LOG_DEBUG << "Batched query for " << objects_.size() << " objects: " << missing.size() << " missing";
+    for (const auto& object : objects_) {
+      object->PresenceKnown(pool, missing.count(object->name()) == 0);
+    }
+    return Outcome::kDone;
+  }
+
+  Outcome outcome;
+  if (rescode == 200 || (rescode >= 400 && rescode < 500)) {
+    LOG_INFO << "Server does not support batched object queries (HTTP " << rescode << "), checking objects one by one";
+    outcome = Outcome::kUnsupported;
+  } else {
+    LOG_WARNING << "OSTree batched query reported an error code: " << rescode << " retrying...";
+    LOG_DEBUG << http_response_.str();
+    outcome = Outcome::kTemporaryFailure;
+  }
+
+  for (const auto& object : objects_) {
+    pool.AddQuery(object);
+  }
+  return outcome;
+}
+
+size_t PresenceBatch::curl_handle_write(void* buffer, size_t size, size_t nmemb, void* userp) {
+  auto* that = static_cast<PresenceBatch*>(userp);
+  that->http_response_.write(static_cast<const char*>(buffer), static_cast<std::streamsize>(size * nmemb));
+  return size * nmemb;
+}
+
+// vim: set tabstop=2 shiftwidth=2 expandtab:
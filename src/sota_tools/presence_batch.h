@@ -0,0 +1,66 @@
+#ifndef SOTA_CLIENT_TOOLS_PRESENCE_BATCH_H_
+#define SOTA_CLIENT_TOOLS_PRESENCE_BATCH_H_
+
+#include <chrono>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <curl/curl.h>
+
+#include "ostree_object.h"
+#include "treehub_server.h"
+
+class RequestPool;
+
+/**
+ * Asks the server which objects of a set it is missing with a single request,
+ * instead of one HEAD request per object.
+ *
+ * The request is a POST to `objects/missing` with the body
+ * `{"objects": ["<object name>", ...]}`, the server answers with
+ * `{"missing": ["<object name>", ...]}`. Object names are relative to the
+ * objects directory, e.g. `ab/cdef....dirtree`. A server that does not
+ * implement the query answers with a client error; the objects are then
+ * queried one by one again.
+ */
+class PresenceBatch {
+ public:
+  enum class Outcome { kDone, kUnsupported, kTemporaryFailure };
+
+  explicit PresenceBatch(std::vector<OSTreeObject::ptr> objects);
+  PresenceBatch(const PresenceBatch&) = delete;
+  PresenceBatch& operator=(const PresenceBatch&) = delete;
+  ~PresenceBatch();
+
+  /* Add the query to the multi handle, using `curl_handle` if it is given and
+   * a new easy handle otherwise. Returns false if curl did not take the
+   * request; the handle is then released with the batch. */
+  bool MakeRequest(const TreehubServer& push_target, CURLM* curl_multi_handle, CURL* curl_handle = nullptr);
+
+  /* Process the completed query: report the presence of every object or, if
+   * the query failed, queue the objects again. */
+  Outcome CurlDone(CURLM* curl_multi_handle, RequestPool& pool);
+
+  CURL* curl_handle() const { return curl_handle_; }
+  const std::vector<OSTreeObject::ptr>& objects() const { return objects_; }
+  size_t size() const { return objects_.size(); }
+  std::chrono::steady_clock::time_point RequestStartTime() const { return request_start_time_; }
+
+  static std::string RequestBody(const std::vector<OSTreeObject::ptr>& objects);
+  /* Returns false if the response is not a valid answer to the query. */
+  static bool ParseResponse(const std::string& response, std::set<std::string>* missing);
+
+ private:
+  static size_t curl_handle_write(void* buffer, size_t size, size_t nmemb, void* userp);
+
+  std::vector<OSTreeObject::ptr> objects_;
+  std::string request_body_;
+  std::stringstream http_response_;
+  CURL* curl_handle_{nullptr};
+  std::chrono::steady_clock::time_point request_start_time_;
+};
+
+// vim: set tabstop=2 shiftwidth=2 expandtab:
+#endif  // SOTA_CLIENT_TOOLS_PRESENCE_BATCH_H_
@@ -0,0 +1,118 @@
+#include "push_state_cache.h"
+
+#include <fstream>
+#include <sstream>
+
+#include <boost/algorithm/hex.hpp>
+#include <boost/algorithm/string.hpp>
+
+#include "crypto/crypto.h"
+#include "logging/logging.h"
+
+namespace {
+const std::string kHeader = "garage-push-cache 1";
+}
+
+PushStateCache::PushStateCache(const boost::filesystem::path &repo_path, std::string server_url,
+                               const std::chrono::seconds ttl)
+    : path_(CachePath(repo_path, server_url)), server_url_(std::move(server_url)), ttl_(ttl) {}
+
+boost::filesystem::path PushStateCache::CachePath(const boost::filesystem::path &repo_path,
+                                                  const std::string &server_url) {
+  boost::system::error_code ec;
+  boost::filesystem::path repo = boost::filesystem::canonical(repo_path, ec);
+  if (ec) {
+    repo = boost::filesystem::absolute(repo_path);
+  }
+  const std::string server_id =
+      boost::algorithm::to_lower_copy(boost::algorithm::hex(Crypto::sha256digest(server_url))).substr(0, 16);
+  return repo.parent_path() / (repo.filename().string() + ".push-cache") / server_id;
+}
+
+int64_t PushStateCache::Now() {
+  return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+bool PushStateCache::Fresh(const int64_t confirmed_at) const {
+  const int64_t now = Now();
+  return confirmed_at <= now && now - confirmed_at < ttl_.count();
+}
+
+void PushStateCache::Load() {
+  confirmed_.clear();
+  assumed_.clear();
+  std::ifstream file(path_.c_str());
+  if (!file.good()) {
+    LOG_DEBUG << "No push state cache at " << path_;
+    return;
+  }
+
+  std::string line;
+  if (!std::getline(file, line) || line != kHeader + " " + server_url_) {
+    LOG_WARNING << "Ignoring push state cache " << path_ << " written for another server or version";
+    return;
+  }
+  size_t stale = 0;
+  while (std::getline(file, line)) {
+    std::istringstream entry(line);
+    int64_t confirmed_at;
+    std::string name;
+    if (!(entry >> confirmed_at >> name)) {
+      LOG_WARNING << "Ignoring invalid push state cache " << path_;
+      confirmed_.clear();
+      return;
+    }
+    if (Fresh(confirmed_at)) {
+      confirmed_[name] = confirmed_at;
+    } else {
+      ++stale;
+    }
+  }
+  LOG_INFO << "Push state cache knows " << confirmed_.size() << " objects on the server (" << stale
+           << " expired entries dropped)";
+}
+
+void PushStateCache::Save() const {
+  try {
+    boost::filesystem::create_directories(path_.parent_path());
+    const boost::filesystem::path tmp_path = path_.string() + ".tmp";
+    {
+      std::ofstream file(tmp_path.c_str(), std::ios::trunc);
+      file << kHeader << " " << server_url_ << "\n";
+      for (const auto &entry : confirmed_) {
+        if (Fresh(entry.second)) {
+          file << entry.second << " " << entry.first << "\n";
+        }
+      }
+      file.close();
+      if (file.fail()) {
+        throw std::runtime_error("could not write " + tmp_path.string());
+      }
+    }
+    boost::filesystem::rename(tmp_path, path_);
+    LOG_DEBUG << "Saved push state cache to " << path_;
+  } catch (const std::exception &e) {
+    LOG_WARNING << "Unable to save the push state cache: " << e.what();
+  }
+}
+
+bool PushStateCache::Assume(const std::string &object_name) {
+  auto it = confirmed_.find(object_name);
+  if (it == confirmed_.end() || !Fresh(it->second)) {
+    return false;
+  }
+  assumed_.insert(object_name);
+  return true;
+}
+
+void PushStateCache::Confirmed(const std::vector<std::string> &object_names) {
+  const int64_t now = Now();
+  for (const auto &name : object_names) {
+    if (assumed_.count(name) == 0) {
+      confirmed_[name] = now;
+    }
+  }
+}
+
+// vim: set tabstop=2 shiftwidth=2 expandtab:
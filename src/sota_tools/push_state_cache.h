@@ -0,0 +1,64 @@
+#ifndef SOTA_CLIENT_TOOLS_PUSH_STATE_CACHE_H_
+#define SOTA_CLIENT_TOOLS_PUSH_STATE_CACHE_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+/**
+ * Remembers which objects a given Treehub server has already confirmed, so
+ * that consecutive pushes of similar commits do not ask the server about the
+ * same objects again.
+ *
+ * The state is stored next to the source repository, in
+ * `<repo>.push-cache/<server id>`, one file per server URL. Every entry
+ * records when the server last confirmed the object, entries older than the
+ * time to live are ignored. Objects taken from the cache are not confirmed
+ * again, so their age is not refreshed by a push that relied on them.
+ *
+ * The server is not asked whether the cached objects are still there, apart
+ * from the commit being pushed (see OSTreeRepo::AddObject). If it loses or
+ * prunes another object within the time to live, a push that relies on the
+ * cache leaves the tree incomplete on the server without noticing. This is
+ * why garage-push only uses the cache with --push-cache.
+ */
+class PushStateCache {
+ public:
+  PushStateCache(const boost::filesystem::path &repo_path, std::string server_url, std::chrono::seconds ttl);
+
+  /* Read the cache from disk. A missing or unreadable cache is empty. */
+  void Load();
+
+  /* Write the cache to disk. Errors are logged and otherwise ignored. */
+  void Save() const;
+
+  /* Returns true if the server confirmed the object within the time to live.
+   * The object is then remembered as assumed rather than confirmed. */
+  bool Assume(const std::string &object_name);
+
+  /* Record that the server has confirmed these objects now. */
+  void Confirmed(const std::vector<std::string> &object_names);
+
+  size_t size() const { return confirmed_.size(); }
+  const boost::filesystem::path &path() const { return path_; }
+
+  static boost::filesystem::path CachePath(const boost::filesystem::path &repo_path, const std::string &server_url);
+
+ private:
+  static int64_t Now();
+  bool Fresh(int64_t confirmed_at) const;
+
+  const boost::filesystem::path path_;
+  const std::string server_url_;
+  const std::chrono::seconds ttl_;
+  std::unordered_map<std::string, int64_t> confirmed_;  // object name -> unix time of confirmation
+  std::unordered_set<std::string> assumed_;
+};
+
+// vim: set tabstop=2 shiftwidth=2 expandtab:
+#endif  // SOTA_CLIENT_TOOLS_PUSH_STATE_CACHE_H_
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <fstream>
+#include <string>
+
+#include "ostree_dir_repo.h"
+#include "push_state_cache.h"
+#include "utilities/utils.h"
+
+namespace {
+
+int64_t Now() {
+  return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+void WriteCache(const boost::filesystem::path &path, const std::string &server, int64_t confirmed_at,
+                const std::string &object) {
+  boost::filesystem::create_directories(path.parent_path());
+  std::ofstream file(path.c_str());
+  file << "garage-push-cache 1 " << server << "\n" << confirmed_at << " " << object << "\n";
+}
+
+}  // namespace
+
+/* Objects confirmed by a server are remembered for that server only. */
+TEST(PushStateCache, SaveLoad) {
+  TemporaryDirectory temp_dir;
+  const boost::filesystem::path repo = temp_dir.Path() / "repo";
+  const std::string object = "3c/064a2f3853b9158b82184311eca9d9d55fcd4788243546fbd98358763ef6fc.dirtree";
+
+  PushStateCache cache(repo, "https://treehub.example.com/api/v3/", std::chrono::hours(1));
+  cache.Load();
+  EXPECT_FALSE(cache.Assume(object));
+  cache.Confirmed({object});
+  cache.Save();
+  EXPECT_EQ(cache.path().parent_path(), temp_dir.Path() / "repo.push-cache");
+  EXPECT_TRUE(boost::filesystem::exists(cache.path()));
+
+  PushStateCache reloaded(repo, "https://treehub.example.com/api/v3/", std::chrono::hours(1));
+  reloaded.Load();
+  EXPECT_EQ(reloaded.size(), 1u);
+  EXPECT_TRUE(reloaded.Assume(object));
+
+  PushStateCache other_server(repo, "https://other.example.com/api/v3/", std::chrono::hours(1));
+  EXPECT_NE(other_server.path(), cache.path());
+  other_server.Load();
+  EXPECT_FALSE(other_server.Assume(object));
+}
+
+/* Entries older than the time to live are ignored and dropped. */
+TEST(PushStateCache, Expiry) {
+  TemporaryDirectory temp_dir;
+  const std::string server = "https://treehub.example.com/";
+  const boost::filesystem::path path = PushStateCache::CachePath(temp_dir.Path() / "repo", server);
+  WriteCache(path, server, Now() - 7200, "aa/bb.filez");
+
+  PushStateCache cache(temp_dir.Path() / "repo", server, std::chrono::hours(1));
+  cache.Load();
+  EXPECT_EQ(cache.size(), 0u);
+  EXPECT_FALSE(cache.Assume("aa/bb.filez"));
+
+  PushStateCache longer_ttl(temp_dir.Path() / "repo", server, std::chrono::hours(3));
+  longer_ttl.Load();
+  EXPECT_TRUE(longer_ttl.Assume("aa/bb.filez"));
+}
+
+/* Objects taken from the cache keep their original confirmation time. */
+TEST(PushStateCache, AssumedNotRefreshed) {
+  TemporaryDirectory temp_dir;
+  const std::string server = "https://treehub.example.com/";
+  const boost::filesystem::path path = PushStateCache::CachePath(temp_dir.Path() / "repo", server);
+  const int64_t confirmed_at = Now() - 100;
+  WriteCache(path, server, confirmed_at, "aa/bb.filez");
+
+  PushStateCache cache(temp_dir.Path() / "repo", server, std::chrono::hours(1));
+  cache.Load();
+  ASSERT_TRUE(cache.Assume("aa/bb.filez"));
+  cache.Confirmed({"aa/bb.filez", "cc/dd.dirtree"});
+  cache.Save();
+
+  std::ifstream file(path.c_str());
+  std::string header;
+  std::getline(file, header);
+  EXPECT_EQ(header, "garage-push-cache 1 " + server);
+  int64_t timestamp;
+  std::string name;
+  size_t entries = 0;
+  while (file >> timestamp >> name) {
+    ++entries;
+    if (name == "aa/bb.filez") {
+      EXPECT_EQ(timestamp, confirmed_at);
+    } else {
+      EXPECT_EQ(name, "cc/dd.dirtree");
+      EXPECT_GT(timestamp, confirmed_at);
+    }
+  }
+  EXPECT_EQ(entries, 2u);
+}
+
+/* A cache written for another server is ignored. */
+TEST(PushStateCache, WrongServer) {
+  TemporaryDirectory temp_dir;
+  const std::string server = "https://treehub.example.com/";
+  WriteCache(PushStateCache::CachePath(temp_dir.Path() / "repo", server), "https://other.example.com/", Now(),
+             "aa/bb.filez");
+
+  PushStateCache cache(temp_dir.Path() / "repo", server, std::chrono::hours(1));
+  cache.Load();
+  EXPECT_FALSE(cache.Assume("aa/bb.filez"));
+}
+
+/* Objects read from a repository with a cache start out as present if the
+ * cache knows them. */
+TEST(PushStateCache, Repo) {
+  TemporaryDirectory temp_dir;
+  const std::string dirtree = "3c/064a2f3853b9158b82184311eca9d9d55fcd4788243546fbd98358763ef6fc.dirtree";
+  auto cache = std::make_shared<PushStateCache>(temp_dir.Path() / "repo", "https://treehub.example.com/",
+                                                std::chrono::hours(1));
+  cache->Confirmed({dirtree});
+
+  OSTreeRepo::ptr src_repo = std::make_shared<OSTreeDirRepo>("tests/sota_tools/repo");
+  src_repo->SetPushStateCache(cache);
+  OSTreeObject::ptr commit = src_repo->GetObject(src_repo->GetRef("master").GetHash(),
+                                                 OstreeObjectType::OSTREE_OBJECT_TYPE_COMMIT);
+  EXPECT_EQ(commit->is_on_server(), PresenceOnServer::kObjectStateUnknown);
+  OSTreeObject::ptr tree =
+      src_repo->GetObject(OSTreeHash::Parse("3c064a2f3853b9158b82184311eca9d9d55fcd4788243546fbd98358763ef6fc"),
+                          OstreeObjectType::OSTREE_OBJECT_TYPE_DIR_TREE);
+  EXPECT_EQ(tree->is_on_server(), PresenceOnServer::kObjectPresent);
+  EXPECT_EQ(src_repo->ObjectsOnServer(), std::vector<std::string>{dirtree});
+}
+
+#ifndef __NO_MAIN__
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+#endif
+
+// vim: set tabstop=2 shiftwidth=2 expandtab:
@@ -9,23 +9,64 @@ const RateController::clock::duration RateController::kMaxSleepTime = std::chron
 
 const RateController::clock::duration RateController::kInitialSleepTime = std::chrono::seconds(1);
 
-RateController::RateController(const int concurrency_cap) : concurrency_cap_(concurrency_cap) { CheckInvariants(); }
+constexpr double RateController::kSlowStartThreshold;
+constexpr double RateController::kLatencyGrowThreshold;
+constexpr double RateController::kLatencyShrinkThreshold;
+constexpr int RateController::kLatencyErrorRatio;
+
+bool ParseCongestionControl(const std::string &name, CongestionControl *result) {
+  if (name == "aimd") {
+    *result = CongestionControl::kAimd;
+  } else if (name == "latency") {
+    *result = CongestionControl::kLatency;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+RateController::RateController(const int concurrency_cap, const CongestionControl algorithm)
+    : concurrency_cap_(concurrency_cap), algorithm_(algorithm) {
+  CheckInvariants();
+}
 
 void RateController::RequestCompleted(const clock::time_point start_time, const clock::time_point end_time,
                                       const bool succeeded) {
-  if (last_concurrency_update_ < start_time) {
+  bool new_information = last_concurrency_update_ < start_time;
+  if (algorithm_ == CongestionControl::kLatency && new_information) {
+    if (succeeded) {
+      const clock::duration rtt = end_time - start_time;
+      min_rtt_ = std::min(min_rtt_, rtt);
+      round_rtt_total_ += rtt;
+      round_samples_++;
+      // Requests sent right after a change complete before those that queued
+      // behind them, so wait until a full round trip has been sampled.
+      new_information = start_time - last_concurrency_update_ >= min_rtt_;
+    } else {
+      round_failures_++;
+      // Occasional errors while the server does not queue requests are not a
+      // sign of congestion.
+      new_information = round_failures_ > 1 + round_samples_ / kLatencyErrorRatio ||
+                        QueuedRequests() >= kLatencyGrowThreshold;
+    }
+  }
+  if (new_information) {
     const int prev_concurrency = max_concurrency_;
     last_concurrency_update_ = end_time;
     if (succeeded) {
-      max_concurrency_ = std::min(max_concurrency_ + 1, concurrency_cap_);
+      max_concurrency_ = std::min(NextConcurrency(), concurrency_cap_);
       sleep_time_ = clock::duration(0);
     } else {
+      slow_start_ = false;
       if (max_concurrency_ >= 2) {
         max_concurrency_ = max_concurrency_ / 2;
       } else {
         sleep_time_ = std::max(sleep_time_ * 2, kInitialSleepTime);
       }
     }
+    round_rtt_total_ = clock::duration(0);
+    round_samples_ = 0;
+    round_failures_ = 0;
     if (prev_concurrency != max_concurrency_) {
       LOG_DEBUG << "Concurrency limit is now: " << max_concurrency_;
     }
@@ -33,6 +74,40 @@ void RateController::RequestCompleted(const clock::time_point start_time, const
   CheckInvariants();
 }
 
+double RateController::QueuedRequests() const {
+  if (round_samples_ == 0) {
+    return 0.0;
+  }
+  // The requests in flight beyond what the fastest round trip seen would
+  // need, i.e. the requests that wait at the server.
+  const double mean_rtt = std::chrono::duration<double>(round_rtt_total_).count() / round_samples_;
+  return max_concurrency_ * (1.0 - std::chrono::duration<double>(min_rtt_).count() / mean_rtt);
+}
+
+int RateController::NextConcurrency() {
+  if (algorithm_ == CongestionControl::kAimd || round_samples_ == 0) {
+    return max_concurrency_ + 1;
+  }
+  const double queued = QueuedRequests();
+  if (slow_start_) {
+    if (queued < kSlowStartThreshold) {
+      return max_concurrency_ * 2;
+    }
+    LOG_DEBUG << "Leaving slow start at concurrency " << max_concurrency_;
+    slow_start_ = false;
+  }
+  if (queued < kLatencyGrowThreshold) {
+    return max_concurrency_ + 1;
+  }
+  if (queued > kLatencyShrinkThreshold) {
+    // Remove half of the excess queue at once, the overshoot at the end of
+    // slow start can be large.
+    const int excess = static_cast<int>((queued - kLatencyGrowThreshold) / 2);
+    return std::max(max_concurrency_ - std::max(excess, 1), 1);
+  }
+  return max_concurrency_;
+}
+
 int RateController::MaxConcurrency() const {
   CheckInvariants();
   return max_concurrency_;
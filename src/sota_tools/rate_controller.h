@@ -2,6 +2,20 @@
 #define SOTA_CLIENT_TOOLS_RATE_CONTROLLER_H_
 
 #include <chrono>
+#include <string>
+
+/** Algorithm a RateController uses to adjust the number of parallel requests. */
+enum class CongestionControl {
+  /** Additive increase of one request per round trip, halve on errors. */
+  kAimd,
+  /** Grow exponentially until requests start to take longer than the fastest
+   * one seen, then keep the number of requests waiting at the server between
+   * two bounds (TCP Vegas style). Errors are handled as with kAimd. */
+  kLatency,
+};
+
+/** Parse "aimd" or "latency". Returns false for anything else. */
+bool ParseCongestionControl(const std::string& name, CongestionControl* result);
 
 /**
  * Control the rate of outgoing requests.
@@ -10,13 +24,13 @@
  *    MaxConcurrency - The current estimate of the number of parallel requests that can be opened
  *    Sleep() - The number of seconds to sleep before sending the next request. 0.0 if MaxConcurrency is > 1
  *    Failed() - A boolean indicating that the server is broken, and to report an error up to the user.
- * The congestion control is loosely based on the original TCP AIMD scheme. Better performance might be available by
- * Stealing ideas from the later TCP conjection control algorithms
+ * The default congestion control is loosely based on the original TCP AIMD scheme. CongestionControl::kLatency also
+ * uses the round-trip times of successful requests, and reaches a high concurrency in fewer round trips.
  */
 class RateController {
  public:
   using clock = std::chrono::steady_clock;
-  explicit RateController(int concurrency_cap = 30);
+  explicit RateController(int concurrency_cap = 30, CongestionControl algorithm = CongestionControl::kAimd);
   RateController(const RateController&) = delete;
   RateController operator=(const RateController&) = delete;
 
@@ -41,7 +55,28 @@ class RateController {
    */
   static const clock::duration kInitialSleepTime;
 
+  /**
+   * Bounds on the number of requests the latency-based controller estimates to
+   * be waiting at the server: slow start ends at kSlowStartThreshold, then the
+   * concurrency grows below kLatencyGrowThreshold and shrinks above
+   * kLatencyShrinkThreshold.
+   */
+  static constexpr double kSlowStartThreshold = 1.0;
+  static constexpr double kLatencyGrowThreshold = 2.0;
+  static constexpr double kLatencyShrinkThreshold = 4.0;
+  /**
+   * Unless the server queues requests, the latency-based controller ignores one
+   * error per round trip, and one more per this many successful requests.
+   */
+  static constexpr int kLatencyErrorRatio = 10;
+
+  /** The next concurrency limit after a successful round trip. */
+  int NextConcurrency();
+  /** Estimate of the requests waiting at the server in the current round. */
+  double QueuedRequests() const;
+
   const int concurrency_cap_;
+  const CongestionControl algorithm_;
   /**
    * After making a change to the system, we wait a full round-trip time to
    * see any effects of the change. This is the last time that an change was
@@ -52,6 +87,16 @@ class RateController {
   int max_concurrency_{1};
   clock::duration sleep_time_{0};
 
+  // Round-trip times seen by the latency-based controller: the shortest
+  // overall, and the sum of those of the requests sent since the last change
+  // of the concurrency limit, with the number of successes and errors among
+  // them.
+  bool slow_start_{true};
+  clock::duration min_rtt_{clock::duration::max()};
+  clock::duration round_rtt_total_{0};
+  int round_samples_{0};
+  int round_failures_{0};
+
   void CheckInvariants() const;
 };
 
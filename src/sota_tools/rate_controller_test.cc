@@ -1,5 +1,13 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <queue>
+#include <set>
+#include <vector>
+
+#include "logging/logging.h"
 #include "rate_controller.h"
 
 /* Initial rate controller status is good. */
@@ -48,6 +56,175 @@ TEST(control, good_results_improve_concurrency) {
   EXPECT_GT(dut.MaxConcurrency(), initial_concurrency);
 }
 
+/* The latency-based controller handles errors like the default one. */
+TEST(failure, latency_many_errors_cause_abort) {
+  RateController dut(30, CongestionControl::kLatency);
+  RateController::clock::time_point t = RateController::clock::now();
+  RateController::clock::duration interval = std::chrono::seconds(2);
+  for (int i = 0; i < 30; i++) {
+    dut.RequestCompleted(t, t + interval, false);
+    t += interval;
+  }
+  EXPECT_TRUE(dut.ServerHasFailed());
+}
+
+/* Congestion control algorithms are selected by name. */
+TEST(control, parse_congestion_control) {
+  CongestionControl algorithm = CongestionControl::kAimd;
+  EXPECT_TRUE(ParseCongestionControl("latency", &algorithm));
+  EXPECT_EQ(algorithm, CongestionControl::kLatency);
+  EXPECT_TRUE(ParseCongestionControl("aimd", &algorithm));
+  EXPECT_EQ(algorithm, CongestionControl::kAimd);
+  EXPECT_FALSE(ParseCongestionControl("vegas", &algorithm));
+}
+
+namespace {
+
+using clock = RateController::clock;
+using std::chrono::milliseconds;
+
+/* A server that processes up to `workers` requests in parallel, in
+ * `service` each, and queues the others. Requests that find `max_queue`
+ * requests waiting are rejected, and every `error_every`th request fails. */
+struct ServerProfile {
+  const char *name;
+  int workers;
+  milliseconds service;
+  milliseconds network;  // round trip without processing
+  int max_queue;
+  int error_every;  // 0 for never
+
+  double PeakRate() const { return workers / std::chrono::duration<double>(service).count(); }
+};
+
+struct SimulationResult {
+  bool server_failed;
+  int completed;
+  double seconds;
+  double seconds_to_converge;  // until 90% of the peak rate is reached, negative if never
+  int final_concurrency;
+};
+
+/* Replay `requests` successful requests against `profile` in simulated time,
+ * keeping as many requests in flight as the controller allows. Failed
+ * requests are retried. */
+SimulationResult Simulate(const ServerProfile &profile, CongestionControl algorithm, int requests, int cap) {
+  struct InFlight {
+    clock::time_point start;
+    clock::time_point service_start;
+    clock::time_point done;
+    bool ok;
+    bool accepted;
+    bool operator>(const InFlight &other) const { return done > other.done; }
+  };
+
+  RateController dut(cap, algorithm);
+  const clock::time_point t0 = clock::time_point() + std::chrono::hours(1);
+  clock::time_point now = t0;
+  std::priority_queue<InFlight, std::vector<InFlight>, std::greater<InFlight>> in_flight;
+  std::priority_queue<clock::time_point, std::vector<clock::time_point>, std::greater<clock::time_point>> workers;
+  for (int i = 0; i < profile.workers; ++i) {
+    workers.push(t0);
+  }
+  std::multiset<clock::time_point> waiting;  // service start times of accepted requests in flight
+  std::deque<clock::time_point> window;      // recent completions
+  const clock::duration window_length = 20 * (profile.service + profile.network);
+  const double window_target = 0.9 * profile.PeakRate() * std::chrono::duration<double>(window_length).count();
+
+  SimulationResult result{false, 0, 0.0, -1.0, 0};
+  int sent = 0;
+  while (result.completed < requests) {
+    while (static_cast<int>(in_flight.size()) < dut.MaxConcurrency()) {
+      ++sent;
+      InFlight request{now, now, now + profile.network, true, false};
+      const clock::time_point arrival = now + profile.network / 2;
+      const auto queued = std::distance(waiting.upper_bound(arrival), waiting.end());
+      if (queued < profile.max_queue) {
+        request.service_start = std::max(arrival, workers.top());
+        workers.pop();
+        workers.push(request.service_start + profile.service);
+        request.done = request.service_start + profile.service + profile.network / 2;
+        request.accepted = true;
+        request.ok = profile.error_every == 0 || sent % profile.error_every != 0;
+        waiting.insert(request.service_start);
+      } else {
+        request.ok = false;
+      }
+      in_flight.push(request);
+    }
+
+    const InFlight request = in_flight.top();
+    in_flight.pop();
+    if (request.accepted) {
+      waiting.erase(waiting.find(request.service_start));
+    }
+    now = request.done;
+    dut.RequestCompleted(request.start, request.done, request.ok);
+    if (dut.ServerHasFailed()) {
+      result.server_failed = true;
+      break;
+    }
+    if (request.ok) {
+      ++result.completed;
+      window.push_back(now);
+      while (window.front() <= now - window_length) {
+        window.pop_front();
+      }
+      if (result.seconds_to_converge < 0 && now - t0 >= window_length && window.size() >= window_target) {
+        result.seconds_to_converge = std::chrono::duration<double>(now - t0).count();
+      }
+    }
+    now += dut.GetSleepTime();
+  }
+  result.seconds = std::chrono::duration<double>(now - t0).count();
+  result.final_concurrency = dut.MaxConcurrency();
+  return result;
+}
+
+const ServerProfile kLan{"lan", 100, milliseconds(20), milliseconds(2), 1000, 0};
+const ServerProfile kWan{"wan", 50, milliseconds(50), milliseconds(100), 1000, 0};
+const ServerProfile kOverloaded{"overloaded", 20, milliseconds(20), milliseconds(50), 20, 0};
+const ServerProfile kFlaky{"flaky", 50, milliseconds(20), milliseconds(50), 1000, 50};
+
+SimulationResult Report(const ServerProfile &profile, CongestionControl algorithm) {
+  const SimulationResult result = Simulate(profile, algorithm, 20000, 500);
+  LOG_DEBUG << profile.name << " " << (algorithm == CongestionControl::kAimd ? "aimd" : "latency")
+            << ": converged after " << result.seconds_to_converge << " s, mean rate "
+            << result.completed / result.seconds / profile.PeakRate() << " of peak, final concurrency "
+            << result.final_concurrency;
+  return result;
+}
+
+}  // namespace
+
+/* Simulate both controllers against several server profiles. Every request
+ * completes without overloading the server; the time each takes to reach 90%
+ * of the peak request rate is logged at debug level. */
+TEST(simulation, convergence) {
+  for (const ServerProfile &profile : {kLan, kWan, kOverloaded, kFlaky}) {
+    for (const CongestionControl algorithm : {CongestionControl::kAimd, CongestionControl::kLatency}) {
+      const SimulationResult result = Report(profile, algorithm);
+      EXPECT_FALSE(result.server_failed) << profile.name;
+      EXPECT_EQ(result.completed, 20000) << profile.name;
+    }
+  }
+}
+
+/* On a server far away, the latency-based controller reaches the peak rate
+ * sooner, without building a long queue at the server. */
+TEST(simulation, latency_converges_faster) {
+  const SimulationResult aimd = Simulate(kWan, CongestionControl::kAimd, 20000, 500);
+  const SimulationResult latency = Simulate(kWan, CongestionControl::kLatency, 20000, 500);
+  ASSERT_GT(aimd.seconds_to_converge, 0.0);
+  ASSERT_GT(latency.seconds_to_converge, 0.0);
+  EXPECT_LT(latency.seconds_to_converge, aimd.seconds_to_converge / 2);
+  EXPECT_LT(latency.seconds, aimd.seconds);
+  // Enough requests for the peak rate (50 workers busy during a 150 ms round
+  // trip need 150), but not the 500 allowed.
+  EXPECT_GE(latency.final_concurrency, 150);
+  EXPECT_LT(latency.final_concurrency, 250);
+}
+
 #ifndef __NO_MAIN__
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
@@ -1,17 +1,27 @@
 #include "request_pool.h"
 
-#include <algorithm>  // min
 #include <chrono>
 #include <exception>
 #include <thread>
+#include <vector>
 
 #include "logging/logging.h"
+#include "utilities/utils.h"
 
-RequestPool::RequestPool(TreehubServer& server, const int max_curl_requests, const RunMode mode)
-    : rate_controller_(max_curl_requests), running_requests_(0), server_(server), mode_(mode), stopped_(false) {
+RequestPool::RequestPool(TreehubServer& server, const int max_curl_requests, const RunMode mode,
+                         const CongestionControl congestion_control)
+    : rate_controller_(max_curl_requests, congestion_control),
+      running_requests_(0),
+      max_fetches_(max_curl_requests),
+      start_time_(std::chrono::steady_clock::now()),
+      last_progress_(start_time_),
+      server_(server),
+      mode_(mode),
+      stopped_(false) {
   curl_global_init(CURL_GLOBAL_DEFAULT);
   multi_ = curl_multi_init();
   curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_HTTP1 | CURLPIPE_MULTIPLEX);
+  http2_ = (curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_HTTP2) != 0;
 }
 
 RequestPool::~RequestPool() {
@@ -25,6 +35,7 @@ RequestPool::~RequestPool() {
     LOG_INFO << "...done";
 
     curl_multi_cleanup(multi_);
+    handles_.Clear();
     curl_global_cleanup();
   } catch (std::exception& ex) {
     LOG_ERROR << "Exception in RequestPool dtor: " << ex.what();
@@ -47,26 +58,167 @@ void RequestPool::AddUpload(const OSTreeObject::ptr& request) {
   }
 }
 
+void RequestPool::AddFetch(const OSTreeObject::ptr& request, const bool retry) {
+  if (stopped_) {
+    return;
+  }
+  if (retry) {
+    fetch_queue_.push_front(request);
+  } else {
+    fetch_queue_.push_back(request);
+  }
+}
+
+void RequestPool::AddParseWait(const OSTreeObject::ptr& request) {
+  if (!stopped_) {
+    parse_wait_.push_back(request);
+  }
+}
+
+void RequestPool::ObjectChecked(const OSTreeObject& object, const bool present) {
+  objects_checked_++;
+  if (mode_ != RunMode::kCheckTree) {
+    return;
+  }
+  if (present) {
+    check_stats_.present[object.Type()]++;
+  } else {
+    LOG_ERROR << "OSTree object " << object.name() << " is missing on the server";
+    check_stats_.missing.push_back(object.name());
+  }
+}
+
+void RequestPool::ObjectUploaded(const uintmax_t size) {
+  objects_uploaded_++;
+  uploaded_object_size_ += size;
+}
+
+PoolStats RequestPool::Stats() const {
+  PoolStats stats;
+  stats.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time_).count();
+  stats.objects_checked = objects_checked_;
+  stats.objects_uploaded = objects_uploaded_;
+  stats.objects_fetched = objects_fetched_;
+  stats.bytes_uploaded = uploaded_object_size_;
+  stats.bytes_fetched = fetched_object_size_;
+  stats.head_requests = head_requests_made_;
+  stats.upload_requests = put_requests_made_;
+  stats.batch_requests = batch_requests_made_;
+  stats.bulk_requests = bulk_requests_made_;
+  stats.fetch_requests = fetch_requests_made_;
+  stats.failed_requests = failed_requests_;
+  stats.running_requests = running_requests_;
+  stats.max_concurrency = rate_controller_.MaxConcurrency();
+  stats.queued_queries = query_queue_.size();
+  stats.queued_uploads = upload_queue_.size();
+  stats.queued_fetches = fetch_queue_.size();
+  stats.waiting_for_parse = parse_wait_.size();
+  // A batch is one request for many objects.
+  int in_flight = running_requests_ - static_cast<int>(batches_.size() + upload_batches_.size());
+  for (const auto& batch : batches_) {
+    in_flight += static_cast<int>(batch.second->size());
+  }
+  for (const auto& batch : upload_batches_) {
+    in_flight += static_cast<int>(batch.second->size());
+  }
+  stats.in_flight_objects = in_flight > 0 ? in_flight : 0;
+  stats.aborted = stopped_;
+  return stats;
+}
+
+void RequestPool::ReportProgress() {
+  if (progress_interval_ <= std::chrono::seconds(0)) {
+    return;
+  }
+  const auto now = std::chrono::steady_clock::now();
+  if (now - last_progress_ < progress_interval_) {
+    return;
+  }
+  last_progress_ = now;
+  LOG_INFO << "Progress after " << Stats().ToString();
+}
+
+void RequestPool::ResumeParsed() {
+  for (auto it = parse_wait_.begin(); it != parse_wait_.end();) {
+    if ((*it)->ChildrenParsed()) {
+      OSTreeObject::ptr cur = *it;
+      it = parse_wait_.erase(it);
+      cur->ParseDone(*this);
+    } else {
+      ++it;
+    }
+  }
+}
+
+CURL* RequestPool::AcquireHandle() {
+  CURL* handle = handles_.Acquire();
+  if (http2_) {
+    // Negotiate HTTP/2 over TLS and wait for an existing connection to accept
+    // another stream rather than opening a new connection per request, so that
+    // many small objects share a few connections.
+    const long http_version = CURL_HTTP_VERSION_2TLS;  // NOLINT(google-runtime-int)
+    curlEasySetoptWrapper(handle, CURLOPT_HTTP_VERSION, http_version);
+    curlEasySetoptWrapper(handle, CURLOPT_PIPEWAIT, 1L);
+  }
+  return handle;
+}
+
 void RequestPool::LoopLaunch() {
-  while (running_requests_ < rate_controller_.MaxConcurrency() && (!query_queue_.empty() || !upload_queue_.empty())) {
+  while (running_fetches_ < max_fetches_ && !fetch_queue_.empty()) {
+    OSTreeObject::ptr cur = fetch_queue_.front();
+    fetch_queue_.pop_front();
+    if (!cur->Fetch(multi_, AcquireHandle())) {
+      AddFetch(cur, true);
+      LaunchFailed();
+      return;
+    }
+    fetch_requests_made_++;
+    running_fetches_++;
+    running_requests_++;
+  }
+
+  while (running_requests_ - running_fetches_ < rate_controller_.MaxConcurrency() &&
+         (!query_queue_.empty() || !upload_queue_.empty())) {
     OSTreeObject::ptr cur;
 
     // Queries first, uploads second
     if (query_queue_.empty()) {
+      if (bulk_uploads_ && (mode_ == RunMode::kDefault || mode_ == RunMode::kPushTree) && LaunchUploadBatch()) {
+        running_requests_++;
+        continue;
+      }
       cur = upload_queue_.front();
       upload_queue_.pop_front();
-      cur->Upload(server_, multi_, mode_);
-      put_requests_made_++;
-      total_object_size_ += cur->GetSize();
-      if (mode_ == RunMode::kDryRun || mode_ == RunMode::kWalkTree) {
+      if (mode_ == RunMode::kDryRun || mode_ == RunMode::kWalkTree || mode_ == RunMode::kCheckTree) {
         // Don't send an actual upload message, just skip to the part where we
-        // acknowledge that the object has been uploaded.
+        // acknowledge that the object has been uploaded. No request is running
+        // for it afterwards.
+        put_requests_made_++;
+        total_object_size_ += cur->GetSize();
+        cur->Upload(server_, multi_, mode_);
         cur->NotifyParents(*this);
+        continue;
+      }
+      if (!cur->Upload(server_, multi_, mode_, AcquireHandle())) {
+        AddUpload(cur);
+        LaunchFailed();
+        return;
+      }
+      put_requests_made_++;
+      total_object_size_ += cur->GetSize();
+    } else if (batch_queries_ && query_queue_.size() > 1) {
+      if (!LaunchQueryBatch()) {
+        LaunchFailed();
+        return;
       }
     } else {
       cur = query_queue_.front();
       query_queue_.pop_front();
-      cur->MakeTestRequest(server_, multi_);
+      if (!cur->MakeTestRequest(server_, multi_, AcquireHandle())) {
+        AddQuery(cur);
+        LaunchFailed();
+        return;
+      }
       head_requests_made_++;
     }
 
@@ -74,56 +226,95 @@ void RequestPool::LoopLaunch() {
   }
 }
 
-void RequestPool::LoopListen() {
-  // For more information about the timeout logic, read these:
-  // https://curl.haxx.se/libcurl/c/curl_multi_timeout.html
-  // https://curl.haxx.se/libcurl/c/curl_multi_fdset.html
-  CURLMcode mc;
-  // Poll for IO
-  fd_set fdread;
-  fd_set fdwrite;
-  fd_set fdexcept;
-  int maxfd = 0;
-  FD_ZERO(&fdread);    // NOLINT(readability-isolate-declaration)
-  FD_ZERO(&fdwrite);   // NOLINT(readability-isolate-declaration)
-  FD_ZERO(&fdexcept);  // NOLINT(readability-isolate-declaration)
-  long timeoutms = 0;  // NOLINT(google-runtime-int)
-  mc = curl_multi_timeout(multi_, &timeoutms);
-  if (mc != CURLM_OK) {
-    throw std::runtime_error("curl_multi_timeout failed with error");
+void RequestPool::LaunchFailed() {
+  // The request that could not be started is queued again and retried once
+  // the running requests have completed. Without any, nothing would change
+  // before the next attempt.
+  if (running_requests_ == 0) {
+    LOG_ERROR << "Could not start any request, aborting";
+    Abort();
   }
-  // If timeoutms is 0, "it means you should proceed immediately without waiting
-  // for anything".
-  if (timeoutms != 0) {
-    mc = curl_multi_fdset(multi_, &fdread, &fdwrite, &fdexcept, &maxfd);
-    if (mc != CURLM_OK) {
-      throw std::runtime_error("curl_multi_fdset failed with error");
-    }
+}
 
-    struct timeval timeout {};
-    if (maxfd != -1) {
-      // "Wait for activities no longer than the set timeout."
-      if (timeoutms == -1) {
-        // "You must not wait too long (more than a few seconds perhaps)".
-        timeout.tv_sec = 3;
-        timeout.tv_usec = 0;
-      } else {
-        timeout.tv_sec = timeoutms / 1000;
-        timeout.tv_usec = 1000 * (timeoutms % 1000);
-      }
-      if (select(maxfd + 1, &fdread, &fdwrite, &fdexcept, &timeout) < 0) {
-        throw std::runtime_error(std::string("select failed with error: ") + std::strerror(errno));
-      }
-    } else if (timeoutms > 0) {
-      // If maxfd == -1, then wait the lesser of timeoutms and 100 ms.
-      long nofd_timeoutms = std::min(timeoutms, static_cast<long>(100));  // NOLINT(google-runtime-int)
-      LOG_DEBUG << "Waiting " << nofd_timeoutms << " ms for curl";
-      timeout.tv_sec = 0;
-      timeout.tv_usec = 1000 * (nofd_timeoutms % 1000);
-      if (select(0, nullptr, nullptr, nullptr, &timeout) < 0) {
-        throw std::runtime_error(std::string("select failed with error: ") + std::strerror(errno));
+bool RequestPool::LaunchQueryBatch() {
+  std::vector<OSTreeObject::ptr> objects;
+  while (!query_queue_.empty() && objects.size() < kMaxQueryBatch) {
+    objects.push_back(query_queue_.front());
+    query_queue_.pop_front();
+  }
+  auto batch = std_::make_unique<PresenceBatch>(std::move(objects));
+  if (!batch->MakeRequest(server_, multi_, AcquireHandle())) {
+    // Queue the objects again, in their original order
+    query_queue_.insert(query_queue_.begin(), batch->objects().begin(), batch->objects().end());
+    return false;
+  }
+  batch_requests_made_++;
+  batches_.emplace(batch->curl_handle(), std::move(batch));
+  return true;
+}
+
+bool RequestPool::LaunchUploadBatch() {
+  // Only look at the front of the queue: large objects are not going to be
+  // batched and should not be checked again at every launch.
+  std::vector<OSTreeObject::ptr> objects;
+  uintmax_t batch_size = 0;
+  auto it = upload_queue_.begin();
+  for (size_t examined = 0; it != upload_queue_.end() && examined < kMaxUploadBatch; ++examined) {
+    const uintmax_t size = (*it)->GetSize();
+    if (size > kMaxBulkObjectSize) {
+      if (objects.empty()) {
+        return false;
       }
+      ++it;
+      continue;
     }
+    if (batch_size + size > kMaxUploadBatchSize) {
+      break;
+    }
+    objects.push_back(*it);
+    batch_size += size;
+    it = upload_queue_.erase(it);
+  }
+  if (objects.size() < 2) {
+    upload_queue_.insert(upload_queue_.begin(), objects.begin(), objects.end());
+    return false;
+  }
+
+  auto batch = std_::make_unique<UploadBatch>(std::move(objects));
+  if (!batch->MakeRequest(server_, multi_, AcquireHandle())) {
+    // Queue the objects again, for a later batch or a single upload
+    for (const auto& object : batch->objects()) {
+      AddUpload(object);
+    }
+    return false;
+  }
+  bulk_requests_made_++;
+  bulk_objects_sent_ += static_cast<int>(batch->size());
+  total_object_size_ += batch_size;
+  upload_batches_.emplace(batch->curl_handle(), std::move(batch));
+  return true;
+}
+
+void RequestPool::LoopListen() {
+  // Wait for IO on the transfers, or until curl's next timeout. Unlike
+  // select() on the sets from curl_multi_fdset(), this is not limited to
+  // FD_SETSIZE file descriptors. Without any transfer, curl_multi_poll() would
+  // wait for the whole timeout, so don't wait at all. Objects waiting for the
+  // object graph are picked up again after a short wait at most.
+  CURLMcode mc;
+  const int max_wait_ms = parse_wait_.empty() ? kMaxWaitMs : kParseWaitMs;
+  if (running_requests_ > 0) {
+    int numfds = 0;
+#if LIBCURL_VERSION_NUM >= 0x074200
+    mc = curl_multi_poll(multi_, nullptr, 0, max_wait_ms, &numfds);
+#else
+    mc = curl_multi_wait(multi_, nullptr, 0, max_wait_ms, &numfds);
+#endif
+    if (mc != CURLM_OK) {
+      throw std::runtime_error(std::string("curl_multi_poll failed with error: ") + curl_multi_strerror(mc));
+    }
+  } else if (!parse_wait_.empty()) {
+    parse_wait_.front()->WaitForParsing(std::chrono::milliseconds(max_wait_ms));
   }
 
   // Ask curl to handle IO
@@ -138,10 +329,48 @@ void RequestPool::LoopListen() {
   do {
     CURLMsg* msg = curl_multi_info_read(multi_, &msgs_in_queue);
     if ((msg != nullptr) && msg->msg == CURLMSG_DONE) {
-      OSTreeObject::ptr h = ostree_object_from_curl(msg->easy_handle);
-      h->CurlDone(multi_, *this);
-      const bool server_responded_ok = h->LastOperationResult() == ServerResponse::kOk;
-      const RateController::clock::time_point start_time = h->RequestStartTime();
+      bool server_responded_ok;
+      RateController::clock::time_point start_time;
+      auto batch_it = batches_.find(msg->easy_handle);
+      auto upload_it = upload_batches_.find(msg->easy_handle);
+      if (upload_it != upload_batches_.end()) {
+        std::unique_ptr<UploadBatch> batch = std::move(upload_it->second);
+        upload_batches_.erase(upload_it);
+        const UploadBatch::Outcome outcome = batch->CurlDone(multi_, *this);
+        if (outcome == UploadBatch::Outcome::kUnsupported) {
+          bulk_uploads_ = false;
+        }
+        server_responded_ok = outcome != UploadBatch::Outcome::kTemporaryFailure;
+        start_time = batch->RequestStartTime();
+      } else if (batch_it != batches_.end()) {
+        std::unique_ptr<PresenceBatch> batch = std::move(batch_it->second);
+        batches_.erase(batch_it);
+        const PresenceBatch::Outcome outcome = batch->CurlDone(multi_, *this);
+        if (outcome == PresenceBatch::Outcome::kUnsupported) {
+          batch_queries_ = false;
+        }
+        server_responded_ok = outcome != PresenceBatch::Outcome::kTemporaryFailure;
+        start_time = batch->RequestStartTime();
+      } else {
+        OSTreeObject::ptr h = ostree_object_from_curl(msg->easy_handle);
+        const bool fetch = h->operation() == CurrentOp::kOstreeObjectFetching;
+        h->CurlDone(multi_, *this);
+        if (fetch) {
+          running_fetches_--;
+          if (h->fetched()) {
+            objects_fetched_++;
+            fetched_object_size_ += h->GetSize();
+          } else if (h->LastOperationResult() == ServerResponse::kTemporaryFailure) {
+            failed_requests_++;
+          }
+          continue;
+        }
+        server_responded_ok = h->LastOperationResult() == ServerResponse::kOk;
+        start_time = h->RequestStartTime();
+      }
+      if (!server_responded_ok) {
+        failed_requests_++;
+      }
       const RateController::clock::time_point end_time = RateController::clock::now();
       rate_controller_.RequestCompleted(start_time, end_time, server_responded_ok);
       if (rate_controller_.ServerHasFailed()) {
@@ -159,7 +388,9 @@ void RequestPool::LoopListen() {
 }
 
 void RequestPool::Loop() {
+  ResumeParsed();
   LoopLaunch();
   LoopListen();
+  ReportProgress();
 }
 // vim: set tabstop=2 shiftwidth=2 expandtab:
@@ -1,29 +1,86 @@
 #ifndef SOTA_CLIENT_TOOLS_REQUEST_POOL_H_
 #define SOTA_CLIENT_TOOLS_REQUEST_POOL_H_
 
+#include <chrono>
 #include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include <curl/curl.h>
 
+#include "curl_handle_pool.h"
 #include "garage_common.h"
 #include "ostree_object.h"
+#include "pool_stats.h"
+#include "presence_batch.h"
 #include "rate_controller.h"
+#include "upload_batch.h"
+
+/** What a walk in RunMode::kCheckTree found on the server. */
+struct TreeCheckStats {
+  std::map<OstreeObjectType, int> present;  // objects found, by type
+  std::vector<std::string> missing;         // names of the objects not found
+};
 
 class RequestPool {
  public:
-  RequestPool(TreehubServer& server, int max_curl_requests, RunMode mode);
+  RequestPool(TreehubServer& server, int max_curl_requests, RunMode mode,
+              CongestionControl congestion_control = CongestionControl::kAimd);
   ~RequestPool();
   void AddQuery(const OSTreeObject::ptr& request);
   void AddUpload(const OSTreeObject::ptr& request);
+  /* Queue a download of the object from the source repository. Retries are
+   * sent before any other fetch. */
+  void AddFetch(const OSTreeObject::ptr& request, bool retry = false);
+  /* Hold the object until the source repository's object graph has parsed
+   * it, then call its ParseDone(). */
+  void AddParseWait(const OSTreeObject::ptr& request);
   void Abort() {
     stopped_ = true;
     query_queue_.clear();
     upload_queue_.clear();
+    fetch_queue_.clear();
+    parse_wait_.clear();
   };
-  bool is_idle() const { return query_queue_.empty() && upload_queue_.empty() && running_requests_ == 0; }
+  bool is_idle() const {
+    return query_queue_.empty() && upload_queue_.empty() && fetch_queue_.empty() && parse_wait_.empty() &&
+           running_requests_ == 0;
+  }
   bool is_stopped() const { return stopped_; }
+  /* Give back the easy handle of a completed request for reuse. */
+  void ReleaseHandle(CURL* handle) { handles_.Release(handle); }
   RunMode run_mode() const { return mode_; }
 
+  /* Record whether a queried object is on the server. In RunMode::kCheckTree,
+   * this includes the metadata objects checked by fetching them. */
+  void ObjectChecked(const OSTreeObject& object, bool present);
+  const TreeCheckStats& check_stats() const { return check_stats_; }
+  /* Record an object stored on the server. */
+  void ObjectUploaded(uintmax_t size);
+
+  /* The work done so far and the work queued. */
+  PoolStats Stats() const;
+  /* How often Loop() logs the Stats(). Zero turns it off. */
+  void progress_interval(std::chrono::seconds interval) { progress_interval_ = interval; }
+
+  /**
+   * Send presence queries for several queued objects as one batched request
+   * (enabled by default). Batching is turned off for the rest of the run if the
+   * server does not support it.
+   */
+  void batch_queries(bool enabled) { batch_queries_ = enabled; }
+  bool batch_queries() const { return batch_queries_; }
+
+  /**
+   * Upload small objects in archives of several objects (disabled by
+   * default). Bulk uploads are turned off for the rest of the run if the
+   * server does not support them.
+   */
+  void bulk_uploads(bool enabled) { bulk_uploads_ = enabled; }
+  bool bulk_uploads() const { return bulk_uploads_; }
+
   /**
    * One iteration of request-listen loop, launches multiple requests, then
    * listens for the result.
@@ -35,21 +92,78 @@ class RequestPool {
    */
   int put_requests_made() { return put_requests_made_; }
   int head_requests_made() { return head_requests_made_; }
+  /** The number of batched presence queries sent to curl. */
+  int batch_requests_made() { return batch_requests_made_; }
+  /** The number of bulk uploads sent to curl, and the objects in them. */
+  int bulk_requests_made() { return bulk_requests_made_; }
+  int bulk_objects_sent() { return bulk_objects_sent_; }
+  /** The number of objects requested from the source repository. */
+  int fetch_requests_made() { return fetch_requests_made_; }
+  /** The total size of the objects fetched from the source repository. */
+  uintmax_t fetched_object_size() const { return fetched_object_size_; }
   uintmax_t total_object_size() { return total_object_size_; }
+  /** The number of curl easy handles created. Handles are reused between requests. */
+  int curl_handles_created() const { return handles_.handles_created(); }
 
  private:
   void LoopLaunch();  // launches multiple requests from the queues
   void LoopListen();  // listens to the result of launched requests
+  bool LaunchQueryBatch();   // false if curl did not take the request
+  bool LaunchUploadBatch();  // false if no batch was launched
+  void LaunchFailed();       // aborts if no request is left running to retry after
+  void ResumeParsed();       // hands the objects whose children are parsed back to them
+  void ReportProgress();     // logs the Stats() if progress_interval_ has passed
+  CURL* AcquireHandle();     // a handle from handles_, set up to share connections
+
+  // Upper bound on the number of objects in a batched presence query
+  static constexpr size_t kMaxQueryBatch = 1000;
+  // Objects up to this size are uploaded in bulk, in archives of at most
+  // kMaxUploadBatch objects and kMaxUploadBatchSize bytes of objects
+  static constexpr uintmax_t kMaxBulkObjectSize = 64 * 1024;
+  static constexpr size_t kMaxUploadBatch = 1000;
+  static constexpr uintmax_t kMaxUploadBatchSize = 4 * 1024 * 1024;
+  // Longest time to wait for network activity in one LoopListen()
+  static constexpr int kMaxWaitMs = 1000;
+  // Longest wait while objects are waiting for the object graph
+  static constexpr int kParseWaitMs = 10;
+  // Default time between two progress reports
+  static constexpr int kProgressIntervalSeconds = 10;
 
   RateController rate_controller_;
   int running_requests_;
   int head_requests_made_{0};
   int put_requests_made_{0};
+  int batch_requests_made_{0};
+  int bulk_requests_made_{0};
+  int bulk_objects_sent_{0};
+  int fetch_requests_made_{0};
+  // Fetches go to the source repository and have their own limit, they are
+  // neither counted against nor reported to the rate controller.
+  const int max_fetches_;
+  int running_fetches_{0};
   uintmax_t total_object_size_{0};
+  int objects_checked_{0};
+  int objects_uploaded_{0};
+  uintmax_t uploaded_object_size_{0};
+  int objects_fetched_{0};
+  uintmax_t fetched_object_size_{0};
+  int failed_requests_{0};
+  const std::chrono::steady_clock::time_point start_time_;
+  std::chrono::steady_clock::time_point last_progress_;
+  std::chrono::seconds progress_interval_{kProgressIntervalSeconds};
+  TreeCheckStats check_stats_;
   TreehubServer& server_;
   CURLM* multi_;
+  CurlHandlePool handles_;
+  bool http2_;  // whether libcurl can multiplex requests over HTTP/2
   std::list<OSTreeObject::ptr> query_queue_;
   std::list<OSTreeObject::ptr> upload_queue_;
+  std::list<OSTreeObject::ptr> fetch_queue_;
+  std::list<OSTreeObject::ptr> parse_wait_;
+  std::map<CURL*, std::unique_ptr<PresenceBatch>> batches_;  // batched queries in flight
+  std::map<CURL*, std::unique_ptr<UploadBatch>> upload_batches_;  // bulk uploads in flight
+  bool batch_queries_{true};
+  bool bulk_uploads_{false};
   RunMode mode_;
   bool stopped_;
 };
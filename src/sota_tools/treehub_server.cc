@@ -15,6 +15,14 @@ TreehubServer::TreehubServer() {
   force_header_.next = &content_type_header_;
   content_type_header_.data = const_cast<char*>(content_type_header_contents_.c_str());
   content_type_header_.next = nullptr;
+
+  json_auth_header_.data = auth_header_.data;
+  json_auth_header_.next = &json_force_header_;
+  json_force_header_.data = force_header_.data;
+  json_force_header_.next = &json_content_type_header_;
+  json_content_type_header_contents_ = "Content-Type: application/json";
+  json_content_type_header_.data = const_cast<char*>(json_content_type_header_contents_.c_str());
+  json_content_type_header_.next = nullptr;
 }
 
 void TreehubServer::SetToken(const string& token) {
@@ -24,6 +32,7 @@ void TreehubServer::SetToken(const string& token) {
 
   auth_header_contents_ = "Authorization: Bearer " + token;
   auth_header_.data = const_cast<char*>(auth_header_contents_.c_str());
+  json_auth_header_.data = auth_header_.data;
   method_ = AuthMethod::kOauth2;
 }
 
@@ -86,6 +95,11 @@ void TreehubServer::InjectIntoCurl(const string& url_suffix, CURL* curl_handle,
   }
 }
 
+void TreehubServer::InjectJsonIntoCurl(const string& url_suffix, CURL* curl_handle) const {
+  InjectIntoCurl(url_suffix, curl_handle);
+  curlEasySetoptWrapper(curl_handle, CURLOPT_HTTPHEADER, &json_auth_header_);
+}
+
 // Set the url of the treehub server, this should be something like
 // "https://treehub-staging.atsgarage.com/api/v2/"
 // The trailing slash is optional, and will be appended if required
@@ -17,6 +17,8 @@ class TreehubServer {
   void SetAuthBasic(const std::string &username, const std::string &password);
 
   void InjectIntoCurl(const std::string &url_suffix, CURL *curl_handle, bool tufrepo = false) const;
+  /* Same as InjectIntoCurl(), for requests with a JSON body. */
+  void InjectJsonIntoCurl(const std::string &url_suffix, CURL *curl_handle) const;
 
   void ca_certs(const std::string &cacerts) { ca_certs_ = cacerts; }
   void root_url(const std::string &_root_url);
@@ -44,6 +46,12 @@ class TreehubServer {
   // Don't modify content_type_header_contents_ without updating the pointer in
   // content_type_header_
   std::string content_type_header_contents_;
+  // Header list used by InjectJsonIntoCurl(): the same authentication and
+  // force headers, with a fixed JSON content type.
+  struct curl_slist json_auth_header_ {};
+  struct curl_slist json_force_header_ {};
+  struct curl_slist json_content_type_header_ {};
+  std::string json_content_type_header_contents_;
 };
 
 // vim: set tabstop=2 shiftwidth=2 expandtab:
@@ -0,0 +1,97 @@
+#include "upload_batch.h"
+
+#include <cassert>
+#include <map>
+
+#include "logging/logging.h"
+#include "request_pool.h"
+#include "utilities/utils.h"
+
+UploadBatch::UploadBatch(std::vector<OSTreeObject::ptr> objects) : objects_(std::move(objects)) {}
+
+UploadBatch::~UploadBatch() {
+  if (curl_handle_ != nullptr) {
+    curl_easy_cleanup(curl_handle_);
+    curl_handle_ = nullptr;
+  }
+}
+
+std::string UploadBatch::RequestBody(const std::vector<OSTreeObject::ptr>& objects) {
+  std::map<std::string, std::string> entries;
+  for (const auto& object : objects) {
+    entries.emplace(object->name(), Utils::readFile(object->file_path()));
+  }
+  std::stringstream archive;
+  Utils::writeArchive(entries, archive);
+  return archive.str();
+}
+
+bool UploadBatch::MakeRequest(TreehubServer& push_target, CURLM* curl_multi_handle, CURL* curl_handle) {
+  assert(!curl_handle_);
+  request_body_ = RequestBody(objects_);
+  LOG_INFO << "Uploading " << objects_.size() << " objects in one archive of " << request_body_.size() << " bytes";
+
+  curl_handle_ = curl_handle != nullptr ? curl_handle : curl_easy_init();
+  if (curl_handle_ == nullptr) {
+    throw std::runtime_error("Could not initialize curl handle");
+  }
+  curlEasySetoptWrapper(curl_handle_, CURLOPT_VERBOSE, get_curlopt_verbose());
+
+  push_target.SetContentType("Content-Type: application/octet-stream");
+  push_target.InjectIntoCurl("objects/bulk", curl_handle_);
+  curlEasySetoptWrapper(curl_handle_, CURLOPT_USERAGENT, Utils::getUserAgent());
+  curlEasySetoptWrapper(curl_handle_, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(request_body_.size()));
+  curlEasySetoptWrapper(curl_handle_, CURLOPT_POSTFIELDS, request_body_.data());
+  curlEasySetoptWrapper(curl_handle_, CURLOPT_WRITEFUNCTION, &UploadBatch::curl_handle_write);
+  curlEasySetoptWrapper(curl_handle_, CURLOPT_WRITEDATA, this);
+  http_response_.str("");
+
+  const CURLMcode err = curl_multi_add_handle(curl_multi_handle, curl_handle_);
+  if (err != 0) {
+    LOG_ERROR << "curl_multi_add_handle error:" << curl_multi_strerror(err);
+    return false;
+  }
+  request_start_time_ = std::chrono::steady_clock::now();
+  return true;
+}
+
+UploadBatch::Outcome UploadBatch::CurlDone(CURLM* curl_multi_handle, RequestPool& pool) {
+  long rescode = 0;  // NOLINT(google-runtime-int)
+  curl_easy_getinfo(curl_handle_, CURLINFO_RESPONSE_CODE, &rescode);
+  curl_multi_remove_handle(curl_multi_handle, curl_handle_);
+  pool.ReleaseHandle(curl_handle_);
+  curl_handle_ = nullptr;
+  request_body_.clear();
+
+  if (rescode == 200 || rescode == 204) {
+    LOG_DEBUG << "Bulk upload of " << objects_.size() << " objects successful";
+    for (const auto& object : objects_) {
+      object->Uploaded(pool);
+    }
+    return Outcome::kDone;
+  }
+
+  Outcome outcome;
+  if (rescode >= 400 && rescode < 500) {
+    LOG_INFO << "Server does not support bulk uploads (HTTP " << rescode << "), uploading objects one by one";
+    LOG_DEBUG << http_response_.str();
+    outcome = Outcome::kUnsupported;
+  } else {
+    LOG_WARNING << "OSTree bulk upload reported an error code: " << rescode << " retrying...";
+    LOG_DEBUG << http_response_.str();
+    outcome = Outcome::kTemporaryFailure;
+  }
+
+  for (const auto& object : objects_) {
+    pool.AddUpload(object);
+  }
+  return outcome;
+}
+
+size_t UploadBatch::curl_handle_write(void* buffer, size_t size, size_t nmemb, void* userp) {
+  auto* that = static_cast<UploadBatch*>(userp);
+  that->http_response_.write(static_cast<const char*>(buffer), static_cast<std::streamsize>(size * nmemb));
+  return size * nmemb;
+}
+
+// vim: set tabstop=2 shiftwidth=2 expandtab:
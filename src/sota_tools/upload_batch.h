@@ -0,0 +1,63 @@
+#ifndef SOTA_CLIENT_TOOLS_UPLOAD_BATCH_H_
+#define SOTA_CLIENT_TOOLS_UPLOAD_BATCH_H_
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <curl/curl.h>
+
+#include "ostree_object.h"
+#include "treehub_server.h"
+
+class RequestPool;
+
+/**
+ * Uploads several small objects with a single request, instead of one POST
+ * per object.
+ *
+ * The request is a POST to `objects/bulk` whose body is a gzip compressed
+ * tar archive. Every entry is named after an object, relative to the objects
+ * directory (e.g. `ab/cdef....dirtree`), and holds the contents of the
+ * object file. The server verifies and stores all the objects and answers
+ * with 204. A server that does not implement bulk uploads answers with a
+ * client error; the objects are then uploaded one by one again.
+ */
+class UploadBatch {
+ public:
+  enum class Outcome { kDone, kUnsupported, kTemporaryFailure };
+
+  explicit UploadBatch(std::vector<OSTreeObject::ptr> objects);
+  UploadBatch(const UploadBatch&) = delete;
+  UploadBatch& operator=(const UploadBatch&) = delete;
+  ~UploadBatch();
+
+  /* Add the upload to the multi handle, using `curl_handle` if it is given
+   * and a new easy handle otherwise. Returns false if curl did not take the
+   * request; the handle is then released with the batch. */
+  bool MakeRequest(TreehubServer& push_target, CURLM* curl_multi_handle, CURL* curl_handle = nullptr);
+
+  /* Process the completed upload: mark every object as present or, if the
+   * upload failed, queue the objects again. */
+  Outcome CurlDone(CURLM* curl_multi_handle, RequestPool& pool);
+
+  CURL* curl_handle() const { return curl_handle_; }
+  const std::vector<OSTreeObject::ptr>& objects() const { return objects_; }
+  size_t size() const { return objects_.size(); }
+  std::chrono::steady_clock::time_point RequestStartTime() const { return request_start_time_; }
+
+  static std::string RequestBody(const std::vector<OSTreeObject::ptr>& objects);
+
+ private:
+  static size_t curl_handle_write(void* buffer, size_t size, size_t nmemb, void* userp);
+
+  std::vector<OSTreeObject::ptr> objects_;
+  std::string request_body_;
+  std::stringstream http_response_;
+  CURL* curl_handle_{nullptr};
+  std::chrono::steady_clock::time_point request_start_time_;
+};
+
+// vim: set tabstop=2 shiftwidth=2 expandtab:
+#endif  // SOTA_CLIENT_TOOLS_UPLOAD_BATCH_H_
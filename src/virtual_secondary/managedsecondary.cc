@@ -4,6 +4,8 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <array>
+
 #include <boost/algorithm/hex.hpp>
 #include <boost/filesystem.hpp>
 
@@ -29,7 +31,10 @@ struct MetaPack {
 };
 
 ManagedSecondary::ManagedSecondary(Primary::ManagedSecondaryConfig sconfig_in)
-    : sconfig(std::move(sconfig_in)), current_meta(new MetaPack()), meta_bundle_(new Uptane::MetaBundle) {
+    : sconfig(std::move(sconfig_in)),
+      current_meta(new MetaPack()),
+      meta_bundle_(new Uptane::MetaBundle),
+      image_cache_(sconfig.firmware_path) {
   loadMetadata();
   std::string public_key_string;
 
@@ -151,9 +156,26 @@ data::InstallationResult ManagedSecondary::sendFirmware(const Uptane::Target &ta
 data::InstallationResult ManagedSecondary::install(const Uptane::Target &target) {
   auto str = secondary_provider_->getTargetFileHandle(target);
   std::ofstream out_file(sconfig.firmware_path.string(), std::ios::binary);
-  out_file << str.rdbuf();
+  // hash the image while copying it so that manifests don't need to read it again
+  auto hasher = MultiPartHasher::create(Hash::Type::kSha256);
+  std::array<char, 64 * 1024> buf{};
+  uint64_t written = 0;
+  while (str.good()) {
+    str.read(buf.data(), buf.size());
+    const auto read = str.gcount();
+    if (read > 0) {
+      out_file.write(buf.data(), read);
+      hasher->update(reinterpret_cast<const unsigned char *>(buf.data()), static_cast<uint64_t>(read));
+      written += static_cast<uint64_t>(read);
+    }
+  }
   str.close();
   out_file.close();
+  if (out_file.good()) {
+    image_cache_.store(hasher->getHash(), written);
+  } else {
+    image_cache_.invalidate();
+  }
 
   Utils::writeFile(sconfig.target_name_path, target.filename());
   return data::InstallationResult(data::ResultCode::Numeric::kOk, "");
@@ -187,17 +209,14 @@ Uptane::Manifest ManagedSecondary::getManifest() const {
 }
 
 bool ManagedSecondary::getFirmwareInfo(Uptane::InstalledImageInfo &firmware_info) const {
-  std::string content;
-
-  if (!boost::filesystem::exists(sconfig.target_name_path) || !boost::filesystem::exists(sconfig.firmware_path)) {
+  if (!boost::filesystem::exists(sconfig.target_name_path) ||
+      !image_cache_.get(&firmware_info.hash, &firmware_info.len)) {
     firmware_info.name = std::string("noimage");
-    content = "";
+    firmware_info.hash = Uptane::ManifestIssuer::generateVersionHashStr("");
+    firmware_info.len = 0;
   } else {
     firmware_info.name = Utils::readFile(sconfig.target_name_path.string());
-    content = Utils::readFile(sconfig.firmware_path.string());
   }
-  firmware_info.hash = Uptane::ManifestIssuer::generateVersionHashStr(content);
-  firmware_info.len = content.size();
 
   return true;
 }
@@ -226,8 +245,9 @@ bool MetaPack::isConsistent() const {
     if (!director_root.original().empty()) {
       Uptane::Root original_root(director_root);
       Uptane::Root new_root(Uptane::RepositoryType::Director(), director_root.original(), new_root);
-      if (!director_targets.original().empty()) {
-        Uptane::Targets(Uptane::RepositoryType::Director(), Uptane::Role::Targets(), director_targets.original(),
+      const Json::Value targets_json = director_targets.original();
+      if (!targets_json.empty()) {
+        Uptane::Targets(Uptane::RepositoryType::Director(), Uptane::Role::Targets(), Uptane::SignedMeta(targets_json),
                         std::make_shared<Uptane::MetaWithKeys>(original_root));
       }
     }
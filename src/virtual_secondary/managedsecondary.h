@@ -11,6 +11,7 @@
 #include "libaktualizr/secondaryinterface.h"
 #include "libaktualizr/types.h"
 #include "primary/secondary_config.h"
+#include "uptane/installedimagecache.h"
 
 namespace Primary {
 
@@ -87,6 +88,7 @@ class ManagedSecondary : public SecondaryInterface {
   std::string private_key;
   std::unique_ptr<MetaPack> current_meta;
   std::unique_ptr<Uptane::MetaBundle> meta_bundle_;
+  Uptane::InstalledImageCache image_cache_;
 };
 
 }  // namespace Primary
@@ -1,7 +1,7 @@
 import codecs
 from http.server import BaseHTTPRequestHandler
 from socketserver import ThreadingMixIn
-from json import dump
+from json import dump, loads
 from tempfile import NamedTemporaryFile
 
 
@@ -20,6 +20,8 @@ class TreehubServer(BaseHTTPRequestHandler):
         obj = self._ostree_object()
         if self.path == '/token':
             self._respond({'access_token': "dummytoken123"})
+        elif self.path == '/objects/missing':
+            self._batch_query()
         elif obj:
             code = self._ostree_repo.upload(obj)
             self.send_response_only(code)
@@ -46,6 +48,18 @@ class TreehubServer(BaseHTTPRequestHandler):
             self.send_response_only(400)
             self.end_headers()
 
+    def _batch_query(self):
+        # Repositories without a query_batch() method behave like a server
+        # that does not implement batched queries.
+        query_batch = getattr(self._ostree_repo, 'query_batch', None)
+        if query_batch is None:
+            self.send_response_only(404)
+            self.end_headers()
+            return
+        length = int(self.headers['content-length'])
+        objects = loads(self.rfile.read(length).decode('utf-8'))['objects']
+        self._respond({'missing': query_batch(objects)})
+
     def _respond(self, json):
         self.send_response_only(200)
         self.send_header('Content-type', 'text/json')
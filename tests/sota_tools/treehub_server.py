@@ -9,6 +9,10 @@ import subprocess
 import sys
 import time
 import hashlib
+import io
+import json
+import re
+import tarfile
 from contextlib import ExitStack
 from http.server import BaseHTTPRequestHandler, HTTPServer
 from random import seed, randrange
@@ -53,6 +57,12 @@ class TreehubServerHandler(BaseHTTPRequestHandler):
             self.end_headers()
 
     def do_POST(self):
+        if self.path == '/objects/missing':
+            self.batch_query()
+            return
+        if self.path == '/objects/bulk':
+            self.bulk_upload()
+            return
         ctype, pdict = cgi.parse_header(self.headers['Content-Type'])
         print("Upload type: {}".format(ctype))
         if ctype == 'multipart/form-data':
@@ -93,6 +103,65 @@ class TreehubServerHandler(BaseHTTPRequestHandler):
         self.send_response_only(400)
         self.end_headers()
 
+    def batch_query(self):
+        if args.no_batch_query:
+            self.send_response_only(404)
+            self.end_headers()
+            return
+        if self.drop_check():
+            print("Dropping batched query")
+            return
+        length = int(self.headers['content-length'])
+        objects = json.loads(self.rfile.read(length).decode('utf-8'))['objects']
+        print("Processing batched query for %d objects" % len(objects))
+        missing = [o for o in objects if not os.path.exists(os.path.join(repo_path, 'objects', o))]
+        body = json.dumps({'missing': missing}).encode('utf-8')
+        self.send_response_only(200)
+        self.send_header('Content-Type', 'application/json')
+        self.send_header('Content-Length', str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def bulk_upload(self):
+        length = int(self.headers['content-length'])
+        body = self.rfile.read(length)
+        if args.no_bulk_upload:
+            self.send_response_only(404)
+            self.end_headers()
+            return
+        if self.drop_check():
+            print("Dropping bulk upload")
+            return
+        # Verify every object before storing any of them. The name of a
+        # metadata object is the checksum of its contents.
+        objects = {}
+        try:
+            with tarfile.open(fileobj=io.BytesIO(body), mode='r:*') as archive:
+                for member in archive:
+                    if not member.isfile():
+                        continue
+                    match = re.fullmatch(r'([0-9a-f]{2})/([0-9a-f]{62})\.(filez|dirtree|dirmeta|commit)', member.name)
+                    if not match:
+                        raise ValueError('invalid object name %s' % member.name)
+                    data = archive.extractfile(member).read()
+                    if match.group(3) != 'filez' and \
+                            hashlib.sha256(data).hexdigest() != match.group(1) + match.group(2):
+                        raise ValueError('checksum mismatch for %s' % member.name)
+                    objects[member.name] = data
+        except (tarfile.TarError, ValueError) as e:
+            print("Rejecting bulk upload: %s" % e)
+            self.send_response_only(400)
+            self.end_headers()
+            return
+        print("Processing bulk upload of %d objects" % len(objects))
+        for name, data in objects.items():
+            full_path = os.path.join(repo_path, 'objects', name)
+            os.makedirs(os.path.dirname(full_path), exist_ok=True)
+            with open(full_path, 'wb') as f:
+                f.write(data)
+        self.send_response_only(204)
+        self.end_headers()
+
     def drop_check(self):
         self.__class__.made_requests += 1
         if args.fail and args.fail > 0:
@@ -167,6 +236,10 @@ if __name__ == "__main__":
                         help='sleep for n.n seconds for every GET request')
     parser.add_argument('-t', '--tls', action='store_true',
                         help='require TLS from clients')
+    parser.add_argument('--no-batch-query', action='store_true',
+                        help='reject batched object queries like a server that does not implement them')
+    parser.add_argument('--no-bulk-upload', action='store_true',
+                        help='reject bulk uploads like a server that does not implement them')
     args = parser.parse_args()
 
     signal.signal(signal.SIGTERM, sig_handler)